@@ -34,6 +34,7 @@
 #include <ctype.h>
 #include <math.h>
 #include <errno.h>
+#include <float.h>
 
 /* Apparently sscanf is not implemented in some "standard" libraries, so don't use it, if you
  * don't have to. */
@@ -47,11 +48,81 @@
 
 #define FLOAT_FORMAT "%1.17g" /* do not increase precision without incresing NUM_BUF_SIZE */
 #define NUM_BUF_SIZE 64 /* double printed with "%1.17g" shouldn't be longer than 25 bytes so let's be paranoid and use 64 */
+#define NUM_FORMAT_SIZE 8 /* "%1.17g" and shorter precisions */
+#define MAX_FLOAT_PRECISION 17
+
+/* 序列化信息缓存的 key，只有默认数字精度、不转义非 ASCII 字符的紧凑格式输出才会使用缓存 */
+#define CACHE_KEY_NONE              0
+#define CACHE_KEY(escape_slashes)   ((escape_slashes) ? 2 : 1)
+
+/* 可扩展的序列化输出缓冲区第一次分配的大小 */
+#define OUTPUT_STARTING_CAPACITY 256
+
+/* 格式化输出时换行符的最大长度以及预先生成的“换行符 + 缩进字符”缓冲区大小 */
+#define MAX_NEWLINE_LENGTH  16
+#define WHITESPACE_BUF_SIZE 256
+
+/* 二进制格式流式输出时使用的缓冲区大小 */
+#define BINARY_BUF_SIZE 4096
+
+/* CBOR（RFC 8949）数据项的 major type 和用到的简单值 */
+#define CBOR_UNSIGNED   0
+#define CBOR_NEGATIVE   1
+#define CBOR_TEXT       3
+#define CBOR_ARRAY      4
+#define CBOR_MAP        5
+#define CBOR_TAG        6
+#define CBOR_SIMPLE     7
+#define CBOR_FALSE      0xF4
+#define CBOR_TRUE       0xF5
+#define CBOR_NULL       0xF6
+#define CBOR_HALF       0xF9
+#define CBOR_FLOAT      0xFA
+#define CBOR_DOUBLE     0xFB
+#define CBOR_INTEGER_LIMIT 18446744073709551616.0 /* 2^64, integers below it are written as CBOR integers */
+#define CBOR_MAX_PRESIZE   4096 /* streaming reader doesn't trust counts above it for presizing */
+#define CBOR_KEY_BUF_SIZE  128  /* shorter keys are decoded on the stack */
+
+/* 快照镜像格式，所有整数都是 4 字节小端格式，节点之间通过 32 位的相对距离引用，所以镜像最大 4GB */
+#define SNAPSHOT_MAGIC            "PSNP"
+#define SNAPSHOT_VERSION          1
+#define SNAPSHOT_HEADER_SIZE      16
+#define SNAPSHOT_FOOTER_SIZE      8
+#define SNAPSHOT_MAX_SIZE         0xFFFFFFFFUL
+#define SNAPSHOT_SCAN_LIMIT       8    /* objects with more members get a hash table */
+#define SNAPSHOT_STRINGS_CAPACITY 1024 /* starting size of the writer's string table */
+
+/*
+ * 紧凑文档中每个值占用一个 8 字节的槽位，JSON number 直接保存 double，其他类型保存为一个 NaN：最高 16 位是
+ * 0xFFF0 加上类型标记（1 到 6，所以尾数不为 0，不会和 -inf 混淆），最低 32 位保存相对距离、个数或者布尔值
+ * parson 中的数值不会是 NaN，所以这些 NaN 不会和数值混淆
+ */
+#define COMPACT_NULL        1
+#define COMPACT_BOOLEAN     2
+#define COMPACT_STRING      3 /* 载荷是从槽位到字符串的字节距离 */
+#define COMPACT_ARRAY       4 /* 载荷是从槽位到成员区的槽位距离 */
+#define COMPACT_OBJECT      5 /* 载荷是从槽位到成员区的槽位距离 */
+#define COMPACT_COUNT       6 /* 成员区的第一个槽位，载荷是成员个数 */
+#define COMPACT_SLOT_SIZE   8
+#define COMPACT_MAX_SIZE    0xFFFFFFFFUL
+#define COMPACT_NAME_CACHE  64 /* names written recently, objects sharing a key list reuse them */
+
+/* 发布器中每个 epoch 的读者计数器个数，每个计数器独占一个缓存行，减少读者之间的竞争 */
+#define PUBLISHER_STRIPES          16
+#define PUBLISHER_LINE_SIZE        64
+#define PUBLISHER_RETIRED_CAPACITY 4
+
+/* 共享的“键”列表（shape），解析时“键”的个数和顺序都相同的 JSON object 共享同一个“键”列表 */
+#define SHAPE_TABLE_CAPACITY 16 /* starting size of the parser's shape table */
+
+#define POOL_GRANULARITY 8   /* 内存块池按 8 个字节划分大小等级 */
+#define POOL_MAX_SIZE    128 /* 超过 128 个字节的内存块直接使用 parson_malloc 和 parson_free */
+#define POOL_CLASSES     (POOL_MAX_SIZE / POOL_GRANULARITY)
 
 #define SIZEOF_TOKEN(a)       (sizeof(a) - 1)
 #define SKIP_CHAR(str)        ((*str)++)
-#define SKIP_WHITESPACES(str) while (isspace((unsigned char)(**str))) { SKIP_CHAR(str); }
 #define MAX(a, b)             ((a) > (b) ? (a) : (b))
+#define MIN(a, b)             ((a) < (b) ? (a) : (b))
 
 #undef malloc
 #undef free
@@ -62,13 +133,113 @@
 #define IS_NUMBER_INVALID(x) (((x) * 0.0) != 0.0)
 #endif
 
+/* 发布器、延迟释放和共享子树引用计数使用的原子操作，编译器不支持时 json_publisher_init 返回 NULL，引用计数退化成
+   普通的加减（共享子树的文档只能在同一个线程中创建和释放），定义 PARSON_NO_ATOMICS 可以强制关闭 */
+#if !defined(PARSON_NO_ATOMICS) && (defined(__clang__) || \
+    (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))))
+#define PARSON_HAS_ATOMICS 1
+#define ATOMIC_LOAD_LONG(p)       __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define ATOMIC_STORE_LONG(p, v)   __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_ADD_LONG(p, v)     __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_LOAD_INT(p)        __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define ATOMIC_ADD_INT(p, v)      __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_LOAD_PTR(p)        __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define ATOMIC_EXCHANGE_PTR(p, v) __atomic_exchange_n((p), (v), __ATOMIC_SEQ_CST)
+#define ATOMIC_CAS_PTR(p, e, v)   __sync_bool_compare_and_swap((p), (e), (v))
+#elif !defined(PARSON_NO_ATOMICS) && defined(_MSC_VER)
+#include <intrin.h>
+#define PARSON_HAS_ATOMICS 1
+#define ATOMIC_LOAD_LONG(p)       _InterlockedCompareExchange((p), 0, 0)
+#define ATOMIC_STORE_LONG(p, v)   _InterlockedExchange((p), (v))
+#define ATOMIC_ADD_LONG(p, v)     (_InterlockedExchangeAdd((p), (v)) + (v))
+#define ATOMIC_LOAD_INT(p)        ((int)_InterlockedCompareExchange((volatile long *)(p), 0, 0)) /* int is 32 bits like long */
+#define ATOMIC_ADD_INT(p, v)      ((int)_InterlockedExchangeAdd((volatile long *)(p), (v)) + (v))
+#define ATOMIC_LOAD_PTR(p)        _InterlockedCompareExchangePointer((void * volatile *)(p), NULL, NULL)
+#define ATOMIC_EXCHANGE_PTR(p, v) _InterlockedExchangePointer((void * volatile *)(p), (v))
+#define ATOMIC_CAS_PTR(p, e, v)   (_InterlockedCompareExchangePointer((void * volatile *)(p), (v), (e)) == (e))
+#else
+#define PARSON_HAS_ATOMICS 0
+#define ATOMIC_LOAD_LONG(p)       (*(p))
+#define ATOMIC_STORE_LONG(p, v)   (*(p) = (v))
+#define ATOMIC_ADD_LONG(p, v)     (*(p) += (v))
+#define ATOMIC_LOAD_INT(p)        (*(p))
+#define ATOMIC_ADD_INT(p, v)      (*(p) += (v))
+#define ATOMIC_LOAD_PTR(p)        (*(p))
+#define ATOMIC_EXCHANGE_PTR(p, v) parson_exchange_ptr((void**)(p), (v))
+#define ATOMIC_CAS_PTR(p, e, v)   parson_compare_exchange_ptr((void**)(p), (e), (v))
+#endif
+
+/* 小内存块池使用的线程局部存储，编译器不支持时不使用内存块池，定义 PARSON_NO_POOL 可以强制关闭 */
+#if defined(PARSON_NO_POOL)
+#define PARSON_HAS_POOL 0
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define PARSON_HAS_POOL 1
+#define PARSON_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__) || defined(__clang__)
+#define PARSON_HAS_POOL 1
+#define PARSON_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define PARSON_HAS_POOL 1
+#define PARSON_THREAD_LOCAL __declspec(thread)
+#else
+#define PARSON_HAS_POOL 0
+#endif
+
+/* 冻结的 JSON_Value 引用计数不为 0，共享的子树可能被其他线程同时增减引用计数 */
+#define IS_FROZEN(value)          (ATOMIC_LOAD_INT(&(value)->refcount) != 0)
+
+/*
+ * 定义 PARSON_NO_PARENT 时 JSON_Value 中没有 parent 指针，每个节点节省一个指针，添加成员时也不需要写父节点，
+ * 父节点可以通过 JSON_Cursor 在遍历时得到。这时修改子节点不能让祖先节点的序列化缓存无效，所以只有冻结
+ * 之后（不能再修改）的 JSON_Value 使用序列化缓存
+ */
+#ifdef PARSON_NO_PARENT
+#define VALUE_PARENT(value)             ((JSON_Value*)NULL)
+#define SET_VALUE_PARENT(value, node)   ((void)(node))
+#define CACHE_IS_TRUSTED(value)         IS_FROZEN(value)
+#else
+#define VALUE_PARENT(value)             ((value)->parent)
+#define SET_VALUE_PARENT(value, node)   ((value)->parent = (node))
+#define CACHE_IS_TRUSTED(value)         1
+#endif
+
 static JSON_Malloc_Function parson_malloc = malloc;
 static JSON_Free_Function parson_free = free;
 
 static int parson_escape_slashes = 1;
 
+/* 每个线程每个大小等级最多缓存的空闲内存块个数，0 表示不使用内存块池 */
+static size_t parson_pool_limit = 0;
+
+/* json_serialize_to_string_pretty 等接口使用的默认格式化选项：4 个空格缩进，"\n" 换行 */
+static const JSON_Pretty_Options parson_default_pretty = { ' ', 4, "\n", ": ", 0 };
+
+/* json_serialization_options_init 使用的默认序列化选项 */
+static const JSON_Serialization_Options parson_default_options = { 1, 0, MAX_FLOAT_PRECISION, 0, NULL, 0 };
+
 #define IS_CONT(b) (((unsigned char)(b) & 0xC0) == 0x80) /* is utf-8 continuation byte */
 
+/* SWAR (SIMD within a register) helpers, used to scan strings one machine word at a time */
+#define SWAR_ONES              ((size_t)-1 / 0xFF)
+#define SWAR_HIGHS             (SWAR_ONES * 0x80)
+#define SWAR_HAS_ZERO(x)       (((x) - SWAR_ONES) & ~(x) & SWAR_HIGHS)
+#define SWAR_HAS_LESS(x, n)    (((x) - SWAR_ONES * (n)) & ~(x) & SWAR_HIGHS) /* n <= 128 */
+#define SWAR_HAS_BYTE(x, b)    SWAR_HAS_ZERO((x) ^ (SWAR_ONES * (b)))
+#define SWAR_CHUNK             (2 * sizeof(size_t))
+
+/* 序列化字符串时使用的转义表：0 表示不需要转义，'u' 表示需要以 \u00XX 形式输出，其余值为 '\' 后面的转义字符
+ * '/' 是否需要转义还要参考 parson_escape_slashes 的设置 */
+static const char json_escape_table[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u', /* 0x00 - 0x0F */
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', /* 0x10 - 0x1F */
+     0,   0,  '"',  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  '/', /* 0x20 - 0x2F */
+     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  /* 0x30 - 0x3F */
+     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  /* 0x40 - 0x4F */
+     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0, '\\',  0,   0,   0   /* 0x50 - 0x5F */
+};
+
+static const char json_hex_digits[] = "0123456789abcdef";
+
 /* Type definitions */
 
 /*
@@ -91,10 +262,67 @@ typedef union json_value_value {
     int          null;
 } JSON_Value_Value;
 
+/*
+ * JSON object 和 JSON array 中缓存的序列化信息，key 记录缓存对应的序列化选项，修改容器内容时沿着 parent
+ * 指针把当前容器及其所有父节点的缓存置为无效
+ * 如果一个容器的缓存有效，那么它包含的所有容器的缓存都有效，所以置为无效时遇到已经无效的节点就可以停止
+ * fragment 只有在通过 json_value_set_serialization_cache 打开缓存后才会保存，key 有效时内容才有效
+ */
+typedef struct json_serialization_cache_t {
+    size_t size;             /* 紧凑格式序列化后的长度，不包括字符串结尾的 '\0' 字符 */
+    int    key;              /* 缓存对应的序列化选项，CACHE_KEY_NONE 表示缓存无效 */
+    int    fragment_enabled; /* 是否保存序列化结果 */
+    char  *fragment;         /* 保存的序列化结果（size 个字节，没有 '\0' 结尾），可能为 NULL */
+} JSON_Serialization_Cache;
+
+/* 内存块池中空闲的内存块，空闲时内存块的开头用来保存链表指针 */
+typedef struct json_pool_block_t {
+    struct json_pool_block_t *next;
+} JSON_Pool_Block;
+
+/* 每个线程自己的内存块池，每个大小等级一个空闲链表 */
+typedef struct json_pool_t {
+    JSON_Pool_Block *free_blocks[POOL_CLASSES];
+    size_t           counts[POOL_CLASSES];
+} JSON_Pool;
+
+#if PARSON_HAS_POOL
+static PARSON_THREAD_LOCAL JSON_Pool parson_pool;
+#endif
+
 /* 定义一个 JSON 数据中的“变量”表示形式 */
+/*
+ * 多个 JSON object 共享的、不可修改的“键”列表，按照“键”的插入顺序保存，并带有一个预先计算好的哈希索引
+ * 使用它的 JSON object 在修改“键”之前先复制一份私有的“键”列表（写时复制），最后一个使用者释放它
+ */
+typedef struct json_shape_t {
+    long    refcount;   /* 使用它的 JSON object 个数 */
+    size_t  count;      /* “键”的个数 */
+    char  **names;      /* “键”标识符数组 */
+    size_t *index;      /* 开放寻址哈希表，保存 names 中的下标加一，0 表示空位置 */
+    size_t  index_mask; /* 哈希表大小减一，哈希表大小是 2 的整数次幂 */
+} JSON_Shape;
+
+/* 解析时使用的 shape 表，记录本次解析中见过的每一种“键”列表，只在一次解析中有效 */
+typedef struct json_shape_entry_t {
+    size_t       hash;  /* “键”列表的哈希值 */
+    JSON_Object *first; /* 第一个使用这种“键”列表的 JSON object */
+    JSON_Shape  *shape; /* 第二个 JSON object 出现时才创建的 shape */
+} JSON_Shape_Entry;
+
+typedef struct json_shape_table_t {
+    JSON_Shape_Entry *entries;
+    size_t            count;
+    size_t            capacity;
+} JSON_Shape_Table;
+
 struct json_value_t {
+#ifndef PARSON_NO_PARENT
     JSON_Value      *parent;     /* 当前 JSON_Value 在“树形结构”表示中父节点指针 */
+#endif
     JSON_Value_Type  type;       /* 当前 JSON_Value 变量类型 */
+    int              refcount;   /* 0 表示没有冻结，冻结后不能再修改，并且是共享它的引用个数，和 type 一起
+                                    占用 value 之前的 8 个字节，不增加节点大小 */
     JSON_Value_Value value;      /* 当前 JSON_Value 变量值 */
 };
 
@@ -108,6 +336,9 @@ struct json_object_t {
     JSON_Value **values;         /* “键值对”中的“值”标识符 */
     size_t       count;          /* 当前 JSON object 中已经存储的“键值对”个数 */
     size_t       capacity;       /* 当前 JSON object 最多可以存储的“键值对”个数 */
+    JSON_Serialization_Cache cache; /* 序列化信息缓存 */
+    size_t      *sorted_order;   /* 按照“键”排序后的“键值对”索引缓存，NULL 表示还没有排序 */
+    JSON_Shape  *shape;          /* 共享的“键”列表，不为 NULL 时 names 指向 shape->names，“键”不属于当前 JSON object */
 };
 
 /* 定义一个 JSON 数据中的“数组”表示形式，数组中每个表示单位是 JSON_Value */
@@ -116,11 +347,150 @@ struct json_array_t {
     JSON_Value **items;          /* 当前 JSON array 中所包含的 JSON_Value 数组首地址 */
     size_t       count;          /* 当前 JSON array 中已经存储的 JSON_Value 成员个数 */
     size_t       capacity;       /* 当前 JSON array 最多可以经存储的 JSON_Value 成员个数 */
+    JSON_Serialization_Cache cache; /* 序列化信息缓存 */
+};
+
+/*
+ * 序列化输出缓冲区，所有的序列化操作都通过它输出数据
+ * data 为 NULL 并且不可扩展时，输出缓冲区只统计长度，用来计算序列化所需要的空间大小
+ */
+typedef struct json_output_t {
+    char   *data;      /* 输出缓冲区起始地址 */
+    size_t  length;    /* 已经写入（或者统计）的字节数 */
+    size_t  capacity;  /* 输出缓冲区容量，不包括字符串结尾的 '\0' 字符 */
+    int     growable;  /* 空间不足时是否可以通过 parson_malloc 扩展缓冲区 */
+    int     failed;    /* 是否发生了错误（空间不足或者内存分配失败）*/
+} JSON_Output;
+
+/*
+ * 序列化上下文，保存一次序列化过程中使用的输出缓冲区和格式化选项
+ * whitespace 中预先生成了“换行符 + 缩进字符”，用来一次性输出换行和缩进
+ */
+typedef struct json_serializer_t {
+    JSON_Output         *out;                            /* 输出缓冲区 */
+    JSON_Pretty_Options  pretty;                         /* 填充默认值之后的格式化选项 */
+    int                  is_pretty;                      /* 是否添加格式化空白字符 */
+    char                 whitespace[WHITESPACE_BUF_SIZE]; /* 换行符 + 缩进字符 */
+    size_t               newline_len;                    /* whitespace 中换行符的长度 */
+    size_t               whitespace_len;                 /* whitespace 中的有效长度 */
+    char                 num_buf[NUM_BUF_SIZE];          /* 用来格式化 JSONNumber 类型变量值的缓冲区 */
+    char                 num_format[NUM_FORMAT_SIZE];    /* 格式化 JSONNumber 类型变量值时使用的格式字符串 */
+    int                  escape_slashes;                 /* 是否需要转义 '/' 字符 */
+    int                  ascii_only;                     /* 是否把非 ASCII 字符转换成 \uXXXX 格式 */
+    int                  sort_keys;                      /* 是否按照“键”的字节序输出 JSON object 成员 */
+    int                  cache_key;                      /* 可以使用的序列化信息缓存，CACHE_KEY_NONE 表示不使用缓存 */
+    int                  shortest_numbers;               /* 是否使用可以准确还原的最短数字格式 */
+} JSON_Serializer;
+
+/* 对 JSON object 成员按照“键”排序时使用的临时“键值对” */
+typedef struct json_member_t {
+    const char *name;
+    size_t      index;
+} JSON_Member;
+
+/*
+ * 二进制编码器，编码到内存时直接追加到 out 中，流式编码时先缓存到 buf 中，再通过 write_fun 批量写出
+ */
+typedef struct json_binary_writer_t {
+    JSON_Output         *out;                   /* 编码到内存时使用的输出缓冲区，流式编码时为 NULL */
+    JSON_Write_Function  write_fun;             /* 流式编码时使用的写函数 */
+    void                *context;               /* 传递给写函数的参数 */
+    unsigned char        buf[BINARY_BUF_SIZE];  /* 流式编码时使用的缓冲区 */
+    size_t               used;                  /* buf 中已经缓存的字节数 */
+    size_t               position;              /* 已经写入的总字节数 */
+    int                  failed;                /* 是否发生了错误 */
+} JSON_Binary_Writer;
+
+/*
+ * CBOR 解码器，data 不为 NULL 时从内存中解码，否则通过 read_fun 读取数据
+ */
+typedef struct json_cbor_reader_t {
+    const unsigned char *data;       /* 从内存解码时下一个需要读取的字节 */
+    size_t               remaining;  /* 从内存解码时剩余的字节数 */
+    JSON_Read_Function   read_fun;   /* 流式解码时使用的读函数 */
+    void                *context;    /* 传递给读函数的参数 */
+} JSON_Cbor_Reader;
+
+/*
+ * 快照编码器，strings 是已经写入镜像的字符串的散列表，用来让内容相同的字符串（大多是“键”）只写入一次
+ */
+typedef struct json_snapshot_writer_t {
+    JSON_Binary_Writer  *writer;     /* 输出镜像使用的二进制编码器 */
+    const char         **strings;    /* 已经写入的字符串，NULL 表示空位 */
+    size_t              *positions;  /* strings 中每个字符串节点在镜像中的位置 */
+    size_t               capacity;   /* 散列表容量，总是 2 的幂 */
+    size_t               count;      /* 散列表中的字符串个数 */
+} JSON_Snapshot_Writer;
+
+/*
+ * 紧凑文档编码器，先统计槽位个数和字符串长度再一次分配整个文档，槽位在前，字符串在后
+ * names 按照指针缓存最近写入的“键”，共享“键”列表的 JSON object 只写入一次“键”，统计和写入使用相同的缓存
+ */
+typedef struct json_compact_writer_t {
+    unsigned char *slots;      /* 文档起始地址，统计时为 NULL */
+    size_t         slot_count; /* 已经使用的槽位个数 */
+    size_t         string_end; /* 已经使用的字符串区字节数 */
+    size_t         string_base; /* 字符串区在文档中的起始位置 */
+    const char    *names[COMPACT_NAME_CACHE];     /* 最近写入的“键” */
+    size_t         positions[COMPACT_NAME_CACHE]; /* names 中每个“键”在字符串区中的位置 */
+} JSON_Compact_Writer;
+
+/* 发布器的读者计数器，填充到一个缓存行大小 */
+typedef struct json_reader_count_t {
+    long count;
+    char padding[PUBLISHER_LINE_SIZE - sizeof(long)];
+} JSON_Reader_Count;
+
+/*
+ * 发布器，root 和 epoch 由发布者修改、读者原子读取，readers 记录每个 epoch 中正在读取的读者个数，
+ * retired 记录在每个 epoch 中被替换下来、还可能有读者在使用的根节点
+ */
+struct json_publisher_t {
+    JSON_Value         *root;                                 /* 当前发布的根节点 */
+    long                epoch;                                /* 新的读者使用的 epoch（0 或 1）*/
+    JSON_Reader_Count   readers[2][PUBLISHER_STRIPES];        /* 每个 epoch 中正在读取的读者个数 */
+    JSON_Value        **retired[2];                           /* 每个 epoch 中被替换下来的根节点 */
+    size_t              retired_count[2];
+    size_t              retired_capacity[2];
+};
+
+#ifdef PARSON_NO_PARENT
+/*
+ * 没有 parent 指针时，回收器中等待释放的 JSON_Value 通过从内存块池分配的链表节点链接起来
+ */
+typedef struct json_reclaim_link_t {
+    JSON_Value                 *value;
+    struct json_reclaim_link_t *next;
+} JSON_Reclaim_Link;
+
+struct json_reclaimer_t {
+    JSON_Reclaim_Link *incoming; /* json_value_free_deferred 添加的根节点（可能来自多个线程）*/
+    JSON_Reclaim_Link *pending;  /* json_reclaimer_step 正在释放的 JSON_Value 栈，栈顶的成员先释放 */
+};
+#else
+/*
+ * 延迟释放 JSON 数据的回收器，等待释放的 JSON_Value 通过 parent 指针链接起来（它们都已经没有父节点），
+ * 所以不需要另外分配内存
+ */
+struct json_reclaimer_t {
+    JSON_Value *incoming; /* json_value_free_deferred 添加的根节点（可能来自多个线程）*/
+    JSON_Value *pending;  /* json_reclaimer_step 正在释放的 JSON_Value 栈，栈顶的成员先释放 */
+};
+#endif
+
+/*
+ * 游标，保存从根节点到当前节点的路径，用来在遍历时得到父节点（定义 PARSON_NO_PARENT 时 JSON_Value 中没有
+ * parent 指针），也可以用于共享子树（冻结的 JSON_Value 没有唯一的父节点）
+ */
+struct json_cursor_t {
+    JSON_Value **values;   /* 从根节点到当前节点路径上的节点，values[depth] 是当前节点 */
+    size_t      *indexes;  /* values[i] 在 values[i - 1] 中的成员索引，indexes[0] 没有使用 */
+    size_t       depth;    /* 当前节点的深度，根节点的深度为 0 */
+    size_t       capacity; /* values 和 indexes 数组的大小 */
 };
 
 /* Various */
 static char * read_file(const char *filename);
-static void   remove_comments(char *string, const char *start_token, const char *end_token);
 static char * parson_strndup(const char *string, size_t n);
 static char * parson_strdup(const char *string);
 static int    hex_char_to_int(char c);
@@ -128,47 +498,246 @@ static int    parse_utf16_hex(const char *string, unsigned int *result);
 static int    num_bytes_in_utf8_sequence(unsigned char c);
 static int    verify_utf8_sequence(const unsigned char *string, int *len);
 static int    is_valid_utf8(const char *string, size_t string_len);
+static unsigned int utf8_decode_code_point(const unsigned char *string);
 static int    is_decimal(const char *string, size_t length);
+#if !PARSON_HAS_ATOMICS
+static void * parson_exchange_ptr(void **pointer, void *value);
+static int    parson_compare_exchange_ptr(void **pointer, void *expected, void *value);
+#endif
+static void * parson_pool_alloc(size_t size);
+static void   parson_pool_free(void *block, size_t size);
+static void   parson_free_string(char *string);
 
 /* JSON Object */
 static JSON_Object * json_object_init(JSON_Value *wrapping_value);
 static JSON_Status   json_object_add(JSON_Object *object, const char *name, JSON_Value *value);
 static JSON_Status   json_object_addn(JSON_Object *object, const char *name, size_t name_len, JSON_Value *value);
 static JSON_Status   json_object_resize(JSON_Object *object, size_t new_capacity);
+static int           json_object_find_index(const JSON_Object *object, const char *name, size_t name_len, size_t *index);
 static JSON_Value  * json_object_getn_value(const JSON_Object *object, const char *name, size_t name_len);
-static JSON_Status   json_object_remove_internal(JSON_Object *object, const char *name, int free_value);
-static JSON_Status   json_object_dotremove_internal(JSON_Object *object, const char *name, int free_value);
+static JSON_Status   json_object_remove_index(JSON_Object *object, size_t index, JSON_Value **taken, int keep_order);
+static JSON_Status   json_object_remove_internal(JSON_Object *object, const char *name, JSON_Value **taken, int keep_order);
+static JSON_Status   json_object_dotremove_internal(JSON_Object *object, const char *name, JSON_Value **taken);
+static JSON_Value  * json_object_unsharen_value(JSON_Object *object, const char *name, size_t name_len);
 static void          json_object_free(JSON_Object *object);
+static void          json_object_invalidate_order(JSON_Object *object);
+static JSON_Status   json_object_own_names(JSON_Object *object);
+static JSON_Shape  * json_shape_init(JSON_Object *object);
+static void          json_shape_release(JSON_Shape *shape);
 
 /* JSON Array */
 static JSON_Array * json_array_init(JSON_Value *wrapping_value);
 static JSON_Status  json_array_add(JSON_Array *array, JSON_Value *value);
+static JSON_Status  json_array_add_many(JSON_Array *array, JSON_Value_Type type, const void *items, size_t count);
 static JSON_Status  json_array_resize(JSON_Array *array, size_t new_capacity);
 static void         json_array_free(JSON_Array *array);
 
 /* JSON Value */
 static JSON_Value * json_value_init_string_no_copy(char *string);
+static JSON_Serialization_Cache * json_value_get_cache(const JSON_Value *value);
+static void         json_value_invalidate_cache(JSON_Value *value);
+static JSON_Status  json_value_freeze_r(JSON_Value *value, int mark);
+static JSON_Value * json_value_copy_shared(const JSON_Value *value);
+static JSON_Value * json_value_unshare(JSON_Value **slot, JSON_Value *parent);
+static JSON_Value * json_value_get_member(const JSON_Value *value, size_t index);
 
 /* Parser */
+static void         skip_whitespaces(const char **string, int allow_comments);
 static JSON_Status  skip_quotes(const char **string);
 static int          parse_utf16(const char **unprocessed, char **processed);
+static char *       decode_string(const char *input, size_t len, char *output);
 static char *       process_string(const char *input, size_t len);
-static char *       get_quoted_string(const char **string);
-static JSON_Value * parse_object_value(const char **string, size_t nesting);
-static JSON_Value * parse_array_value(const char **string, size_t nesting);
-static JSON_Value * parse_string_value(const char **string);
-static JSON_Value * parse_boolean_value(const char **string);
-static JSON_Value * parse_number_value(const char **string);
-static JSON_Value * parse_null_value(const char **string);
-static JSON_Value * parse_value(const char **string, size_t nesting);
+static char *       get_quoted_string(const char **string, char *recycled);
+static int          json_shape_name_matches(const JSON_Shape *shape, size_t index, const char *string);
+static JSON_Value * json_value_recycle(JSON_Value *recycled, JSON_Value_Type type);
+static void         json_shape_table_share(JSON_Object *object, JSON_Shape *shape);
+static void         json_shape_table_intern(JSON_Shape_Table *table, JSON_Object *object);
+static JSON_Value * parse_root_value(const char **string, int allow_comments, JSON_Value *recycled);
+static JSON_Value * parse_object_value(const char **string, size_t nesting, int allow_comments, JSON_Value *recycled,
+                                       JSON_Shape_Table *shapes);
+static JSON_Value * parse_array_value(const char **string, size_t nesting, int allow_comments, JSON_Value *recycled,
+                                      JSON_Shape_Table *shapes);
+static JSON_Value * parse_string_value(const char **string, JSON_Value *recycled);
+static JSON_Value * parse_boolean_value(const char **string, JSON_Value *recycled);
+static JSON_Value * parse_number_value(const char **string, JSON_Value *recycled);
+static JSON_Value * parse_null_value(const char **string, JSON_Value *recycled);
+static JSON_Value * parse_value(const char **string, size_t nesting, int allow_comments, JSON_Value *recycled,
+                                JSON_Shape_Table *shapes);
 
 /* Serialization */
-static int    json_serialize_to_buffer_r(const JSON_Value *value, char *buf, int level, int is_pretty, char *num_buf);
-static int    json_serialize_string(const char *string, char *buf);
-static int    append_indent(char *buf, int level);
-static int    append_string(char *buf, const char *string);
+static void        json_output_init(JSON_Output *out, char *buf, size_t capacity, int growable);
+static JSON_Status json_output_grow(JSON_Output *out, size_t needed);
+static void        json_output_append(JSON_Output *out, const char *data, size_t len);
+static void        json_output_append_char(JSON_Output *out, char c);
+static JSON_Status json_output_finish(JSON_Output *out);
+static JSON_Status json_serializer_init(JSON_Serializer *ser, JSON_Output *out, const JSON_Serialization_Options *options);
+static void        json_serializer_newline(JSON_Serializer *ser, int level);
+static int         json_array_is_flat(const JSON_Array *array);
+static void        json_serializer_store_cache(JSON_Serializer *ser, JSON_Serialization_Cache *cache, size_t start);
+static const size_t * json_object_get_sorted_order(JSON_Object *object);
+static int         json_member_compare(const void *a, const void *b);
+static int         json_format_number_shortest(double num, char *buf);
+static JSON_Status json_serialize_to_buffer_r(const JSON_Value *value, JSON_Serializer *ser, int level);
+static void        json_serialize_string(const char *string, JSON_Serializer *ser);
+static size_t      json_serialize_utf8_escaped(const char *string, size_t len, JSON_Serializer *ser);
+static size_t      json_string_clean_run(const char *string, size_t len, int escape_slashes, int ascii_only);
+static void        json_serialization_options_init_legacy(JSON_Serialization_Options *options, const JSON_Pretty_Options *pretty);
+static size_t      json_serialization_size_internal(const JSON_Value *value, const JSON_Serialization_Options *options);
+static JSON_Status json_serialize_to_buffer_internal(const JSON_Value *value, char *buf, size_t buf_size_in_bytes,
+                                                     const JSON_Serialization_Options *options);
+static char *      json_serialize_to_string_internal(const JSON_Value *value, const JSON_Serialization_Options *options);
+static JSON_Status json_serialize_to_file_internal(const JSON_Value *value, const char *filename,
+                                                   const JSON_Serialization_Options *options);
+
+/* Binary formats */
+static void        binary_writer_init(JSON_Binary_Writer *writer, JSON_Output *out, JSON_Write_Function write_fun, void *context);
+static void        binary_write(JSON_Binary_Writer *writer, const void *data, size_t len);
+static JSON_Status binary_flush(JSON_Binary_Writer *writer);
+static void        cbor_write_head(JSON_Binary_Writer *writer, int major, unsigned long hi, unsigned long lo);
+static void        cbor_write_size(JSON_Binary_Writer *writer, int major, size_t size);
+static void        cbor_write_number(JSON_Binary_Writer *writer, double num);
+static JSON_Status json_value_write_cbor_r(const JSON_Value *value, JSON_Binary_Writer *writer);
+static JSON_Status cbor_read(JSON_Cbor_Reader *reader, void *data, size_t len);
+static JSON_Status cbor_read_argument(JSON_Cbor_Reader *reader, int info, unsigned long *hi, unsigned long *lo);
+static JSON_Status cbor_read_size(JSON_Cbor_Reader *reader, int info, size_t *size);
+static char *      cbor_read_text(JSON_Cbor_Reader *reader, size_t len, char *buf, size_t buf_size);
+static JSON_Status cbor_read_float(JSON_Cbor_Reader *reader, size_t len, double *num);
+static JSON_Value * json_value_read_cbor_r(JSON_Cbor_Reader *reader, size_t nesting);
+
+/* Snapshot */
+static void        snapshot_put_u32(unsigned char *dst, size_t value);
+static size_t      snapshot_get_u32(const unsigned char *src);
+static size_t      snapshot_hash(const char *string, size_t len);
+static void        snapshot_write_u32(JSON_Snapshot_Writer *sw, size_t value);
+static JSON_Status snapshot_write_string(JSON_Snapshot_Writer *sw, const char *string, size_t *position);
+static JSON_Status json_value_write_snapshot_r(JSON_Snapshot_Writer *sw, const JSON_Value *value, size_t *position);
+static JSON_Status json_value_write_snapshot_internal(const JSON_Value *value, JSON_Binary_Writer *writer);
+static const unsigned char * snapshot_object_getn(const unsigned char *node, const char *name, size_t name_len);
+
+/* Compact documents */
+static int         compact_is_little_endian(void);
+static void        compact_put(unsigned char *slot, int tag, size_t payload);
+static int         compact_get_tag(const unsigned char *slot);
+static size_t      compact_get_payload(const unsigned char *slot);
+static size_t      compact_write_string(JSON_Compact_Writer *cw, size_t slot, const char *string, int is_name);
+static void        compact_write_value(JSON_Compact_Writer *cw, size_t slot, const JSON_Value *value);
+static const unsigned char * compact_object_getn(const unsigned char *object, const char *name, size_t name_len);
+
+/* Publisher */
+static long        json_publisher_count_readers(JSON_Publisher *publisher, long epoch);
+static size_t      json_publisher_stripe(void);
 
 /* Various */
+#if !PARSON_HAS_ATOMICS
+/*********************************************************************************************************
+** 函数名称: parson_exchange_ptr
+** 功能描述: 不支持原子操作时 ATOMIC_EXCHANGE_PTR 使用的普通交换操作
+** 输	 入: pointer - 需要修改的指针的地址
+**         : value - 新的指针值
+** 输	 出: void * - 原来的指针值
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void * parson_exchange_ptr(void **pointer, void *value) {
+    void *old_value = *pointer;
+    *pointer = value;
+    return old_value;
+}
+
+/*********************************************************************************************************
+** 函数名称: parson_compare_exchange_ptr
+** 功能描述: 不支持原子操作时 ATOMIC_CAS_PTR 使用的普通比较交换操作
+** 输	 入: pointer - 需要修改的指针的地址
+**         : expected - 期望的原来的指针值
+**         : value - 新的指针值
+** 输	 出: 1 - 原来的值等于 expected，已经修改
+**         : 0 - 原来的值不等于 expected，没有修改
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static int parson_compare_exchange_ptr(void **pointer, void *expected, void *value) {
+    if (*pointer != expected) {
+        return 0;
+    }
+    *pointer = value;
+    return 1;
+}
+#endif
+
+/*********************************************************************************************************
+** 函数名称: parson_pool_alloc
+** 功能描述: 从当前线程的内存块池中分配一个指定大小的内存块，内存块池中没有空闲内存块时使用 parson_malloc 分配
+** 注     释: 不超过 POOL_MAX_SIZE 的内存块总是按照大小等级向上取整分配（不管是否打开了内存块池），所以释放时
+**         : 只要知道申请的大小（或者一个不超过它的大小）就可以放回对应的等级
+** 输	 入: size - 需要分配的字节数
+** 输	 出: void * - 分配的内存块
+**         : NULL - 内存不足
+** 全局变量: parson_pool
+** 调用模块: 
+*********************************************************************************************************/
+static void * parson_pool_alloc(size_t size) {
+    size_t index = 0;
+#if PARSON_HAS_POOL
+    JSON_Pool_Block *block = NULL;
+#endif
+    if (size == 0 || size > POOL_MAX_SIZE) {
+        return parson_malloc(size);
+    }
+    index = (size - 1) / POOL_GRANULARITY;
+#if PARSON_HAS_POOL
+    block = parson_pool.free_blocks[index];
+    if (block != NULL) {
+        parson_pool.free_blocks[index] = block->next;
+        parson_pool.counts[index]--;
+        return block;
+    }
+#endif
+    return parson_malloc((index + 1) * POOL_GRANULARITY);
+}
+
+/*********************************************************************************************************
+** 函数名称: parson_pool_free
+** 功能描述: 把 parson_pool_alloc 分配的内存块放回当前线程的内存块池，池已满或者没有打开时使用 parson_free 释放
+** 注     释: 内存块可以由其他线程分配，所有线程的内存块都来自 parson_malloc，同一大小等级的内存块可以互换
+** 输	 入: block - 需要释放的内存块，可以为 NULL
+**         : size - 分配时申请的字节数，或者一个不超过它的字节数
+** 输	 出: 
+** 全局变量: parson_pool, parson_pool_limit
+** 调用模块: 
+*********************************************************************************************************/
+static void parson_pool_free(void *block, size_t size) {
+#if PARSON_HAS_POOL
+    size_t index = 0;
+    if (block != NULL && size > 0 && size <= POOL_MAX_SIZE) {
+        index = (size - 1) / POOL_GRANULARITY;
+        if (parson_pool.counts[index] < parson_pool_limit) {
+            ((JSON_Pool_Block*)block)->next = parson_pool.free_blocks[index];
+            parson_pool.free_blocks[index] = (JSON_Pool_Block*)block;
+            parson_pool.counts[index]++;
+            return;
+        }
+    }
+#else
+    (void)size;
+#endif
+    parson_free(block);
+}
+
+/*********************************************************************************************************
+** 函数名称: parson_free_string
+** 功能描述: 释放一个 parson_pool_alloc 分配的字符串
+** 注     释: 字符串的缓冲区不会小于字符串长度加一，所以可以按照字符串长度放回内存块池
+** 输	 入: string - 需要释放的字符串，可以为 NULL
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void parson_free_string(char *string) {
+    if (string != NULL) {
+        parson_pool_free(string, strlen(string) + 1);
+    }
+}
+
 /*********************************************************************************************************
 ** 函数名称: parson_strndup
 ** 功能描述: 分配内存并复制指定字符串的指定个数字符数据，然后返回字符串首地址
@@ -180,7 +749,7 @@ static int    append_string(char *buf, const char *string);
 ** 调用模块: 
 *********************************************************************************************************/
 static char * parson_strndup(const char *string, size_t n) {
-    char *output_string = (char*)parson_malloc(n + 1);
+    char *output_string = (char*)parson_pool_alloc(n + 1);
     if (!output_string) {
         return NULL;
     }
@@ -317,6 +886,28 @@ static int is_valid_utf8(const char *string, size_t string_len) {
     return 1;
 }
 
+/*********************************************************************************************************
+** 函数名称: utf8_decode_code_point
+** 功能描述: 获取指定的 utf8 字符的 unicode 码点
+** 注     释: 调用者需要保证 utf8 字符是合法的，不合法的起始字节直接作为码点返回
+** 输     入: string - utf8 字符起始地址
+** 输     出: unsigned int - unicode 码点
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static unsigned int utf8_decode_code_point(const unsigned char *string) {
+    int i = 0, len = num_bytes_in_utf8_sequence(string[0]);
+    unsigned int cp = 0;
+    if (len < 2) {
+        return string[0];
+    }
+    cp = string[0] & (0xFF >> (len + 1));
+    for (i = 1; i < len; i++) {
+        cp = (cp << 6) | (string[i] & 0x3F);
+    }
+    return cp;
+}
+
 static int is_decimal(const char *string, size_t length) {
     if (length > 1 && string[0] == '0' && string[1] != '.') {
         return 0;
@@ -373,50 +964,6 @@ static char * read_file(const char * filename) {
     return file_contents;
 }
 
-/*********************************************************************************************************
-** 函数名称: remove_comments
-** 功能描述: 从指定的字符串中移除和 JSON 数据无关的注释信息，注释信息是指在起始标识符和结束标识符之间的内容
-** 输     入: start_token - 注释信息的起始标识符，例如 /* 和 //
-*///       : end_token - 注释信息的结束标识符 */ 和 \n                                                
-/* 输     出: string - 移除了注释信息的 JSON 数据
-** 全局变量: 
-** 调用模块: 
-*********************************************************************************************************/
-static void remove_comments(char *string, const char *start_token, const char *end_token) {
-    int in_string = 0, escaped = 0;
-    size_t i;
-    char *ptr = NULL, current_char;
-    size_t start_token_len = strlen(start_token);
-    size_t end_token_len = strlen(end_token);
-    if (start_token_len == 0 || end_token_len == 0) {
-        return;
-    }
-    while ((current_char = *string) != '\0') {
-        if (current_char == '\\' && !escaped) {
-            escaped = 1;
-            string++;
-            continue;
-        } else if (current_char == '\"' && !escaped) {
-            in_string = !in_string;
-        } else if (!in_string && strncmp(string, start_token, start_token_len) == 0) {
-            for(i = 0; i < start_token_len; i++) {
-                string[i] = ' ';
-            }
-            string = string + start_token_len;
-            ptr = strstr(string, end_token);
-            if (!ptr) {
-                return;
-            }
-            for (i = 0; i < (ptr - string) + end_token_len; i++) {
-                string[i] = ' ';
-            }
-            string = ptr + end_token_len - 1;
-        }
-        escaped = 0;
-        string++;
-    }
-}
-
 /* JSON Object */
 /*********************************************************************************************************
 ** 函数名称: json_object_init
@@ -428,7 +975,7 @@ static void remove_comments(char *string, const char *start_token, const char *e
 ** 调用模块: 
 *********************************************************************************************************/
 static JSON_Object * json_object_init(JSON_Value *wrapping_value) {
-    JSON_Object *new_obj = (JSON_Object*)parson_malloc(sizeof(JSON_Object));
+    JSON_Object *new_obj = (JSON_Object*)parson_pool_alloc(sizeof(JSON_Object));
     if (new_obj == NULL) {
         return NULL;
     }
@@ -437,6 +984,12 @@ static JSON_Object * json_object_init(JSON_Value *wrapping_value) {
     new_obj->values = (JSON_Value**)NULL;
     new_obj->capacity = 0;
     new_obj->count = 0;
+    new_obj->cache.size = 0;
+    new_obj->cache.key = CACHE_KEY_NONE;
+    new_obj->cache.fragment_enabled = 0;
+    new_obj->cache.fragment = NULL;
+    new_obj->sorted_order = NULL;
+    new_obj->shape = NULL;
     return new_obj;
 }
 
@@ -473,7 +1026,7 @@ static JSON_Status json_object_addn(JSON_Object *object, const char *name, size_
     if (object == NULL || name == NULL || value == NULL) {
         return JSONFailure;
     }
-    if (json_object_getn_value(object, name, name_len) != NULL) {
+    if (json_object_getn_value(object, name, name_len) != NULL || json_object_own_names(object) == JSONFailure) {
         return JSONFailure;
     }
     if (object->count >= object->capacity) {
@@ -487,9 +1040,13 @@ static JSON_Status json_object_addn(JSON_Object *object, const char *name, size_
     if (object->names[index] == NULL) {
         return JSONFailure;
     }
-    value->parent = json_object_get_wrapping_value(object);
+    if (!IS_FROZEN(value)) { /* shared values have no parent */
+        SET_VALUE_PARENT(value, json_object_get_wrapping_value(object));
+    }
     object->values[index] = value;
     object->count++;
+    json_object_invalidate_order(object);
+    json_value_invalidate_cache(object->wrapping_value);
     return JSONSuccess;
 }
 
@@ -510,7 +1067,7 @@ static JSON_Status json_object_resize(JSON_Object *object, size_t new_capacity)
 
     if ((object->names == NULL && object->values != NULL) ||
         (object->names != NULL && object->values == NULL) ||
-        new_capacity == 0) {
+        new_capacity == 0 || object->shape != NULL) {
             return JSONFailure; /* Shouldn't happen */
     }
     temp_names = (char**)parson_malloc(new_capacity * sizeof(char*));
@@ -535,85 +1092,179 @@ static JSON_Status json_object_resize(JSON_Object *object, size_t new_capacity)
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_getn_value
-** 功能描述: 在指定的 JSON object 中，通过“键值对”中的“键”标识符获取与其对应的“值”标识符的内容
+** 函数名称: json_object_find_index
+** 功能描述: 在指定的 JSON object 中查找指定“键”标识符所在的位置
+** 注     释: 有共享“键”列表时只需要探测一次哈希索引，否则按顺序比较每个“键”
 ** 输     入: object - 我们要操作的 JSON object 对象
 **         : name - “键值对”的“键”标识符
 **         : name_len - “键值对”的“键”标识符长度
-** 输     出: JSON_Status - 执行状态
+**         : index - 找到时保存“键值对”的索引值
+** 输     出: 1 - 找到
+**         : 0 - 没有找到
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static JSON_Value * json_object_getn_value(const JSON_Object *object, const char *name, size_t name_len) {
-    size_t i, name_length;
+static int json_object_find_index(const JSON_Object *object, const char *name, size_t name_len, size_t *index) {
+    size_t i, name_length, slot;
+    const JSON_Shape *shape = object != NULL ? object->shape : NULL;
+    if (shape != NULL) { /* one probe into the shared index */
+        slot = snapshot_hash(name, name_len) & shape->index_mask;
+        while (shape->index[slot] != 0) {
+            i = shape->index[slot] - 1;
+            if (strncmp(shape->names[i], name, name_len) == 0 && shape->names[i][name_len] == '\0') {
+                *index = i;
+                return 1;
+            }
+            slot = (slot + 1) & shape->index_mask;
+        }
+        return 0;
+    }
     for (i = 0; i < json_object_get_count(object); i++) {
         name_length = strlen(object->names[i]);
         if (name_length != name_len) {
             continue;
         }
         if (strncmp(object->names[i], name, name_len) == 0) {
-            return object->values[i];
+            *index = i;
+            return 1;
         }
     }
-    return NULL;
+    return 0;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_remove_internal
-** 功能描述: 从指定的 JSON object 中通过“键值对”的“键”标识符找到与其对应的成员并删除
+** 函数名称: json_object_getn_value
+** 功能描述: 在指定的 JSON object 中，通过“键值对”中的“键”标识符获取与其对应的“值”标识符的内容
 ** 输     入: object - 我们要操作的 JSON object 对象
 **         : name - “键值对”的“键”标识符
-**         : free_value - 是否释放“键值对”的“值”标识符占用的资源
+**         : name_len - “键值对”的“键”标识符长度
+** 输     出: JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Value * json_object_getn_value(const JSON_Object *object, const char *name, size_t name_len) {
+    size_t i = 0;
+    return json_object_find_index(object, name, name_len, &i) ? object->values[i] : NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_remove_index
+** 功能描述: 删除指定 JSON object 中指定索引的“键值对”
+** 注     释: 复制共享的“键”列表不会改变“键值对”的位置
+** 输     入: object - 我们要操作的 JSON object 对象，不能是冻结的
+**         : index - 要删除的“键值对”索引值，必须小于“键值对”个数
+**         : taken - 为 NULL 时释放“值”标识符占用的资源，否则把“值”标识符从 JSON object 中取出保存在这里
+**         : keep_order - 为 0 时用最后一个“键值对”填补删除的位置，否则后面的“键值对”依次前移
 ** 输     出: JSON_Status - 执行状态
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static JSON_Status json_object_remove_internal(JSON_Object *object, const char *name, int free_value) {
-    size_t i = 0, last_item_index = 0;
-    if (object == NULL || json_object_get_value(object, name) == NULL) {
+static JSON_Status json_object_remove_index(JSON_Object *object, size_t index, JSON_Value **taken, int keep_order) {
+    size_t i = index, last_item_index = 0;
+    if (json_object_own_names(object) == JSONFailure) {
         return JSONFailure;
     }
     last_item_index = json_object_get_count(object) - 1;
-    for (i = 0; i < json_object_get_count(object); i++) {
-        if (strcmp(object->names[i], name) == 0) {
-            parson_free(object->names[i]);
-            if (free_value) {
-                json_value_free(object->values[i]);
-            }
-            if (i != last_item_index) { /* Replace key value pair with one from the end */
-                object->names[i] = object->names[last_item_index];
-                object->values[i] = object->values[last_item_index];
-            }
-            object->count -= 1;
-            return JSONSuccess;
+    parson_free_string(object->names[i]);
+    if (taken == NULL) {
+        json_value_free(object->values[i]);
+    } else {
+        *taken = object->values[i];
+        if (!IS_FROZEN(*taken)) { /* shared values have no parent */
+            SET_VALUE_PARENT(*taken, NULL);
         }
     }
-    return JSONFailure; /* No execution path should end here */
+    if (keep_order) {
+        memmove(object->names + i, object->names + i + 1, (last_item_index - i) * sizeof(char*));
+        memmove(object->values + i, object->values + i + 1, (last_item_index - i) * sizeof(JSON_Value*));
+    } else if (i != last_item_index) { /* Replace key value pair with one from the end */
+        object->names[i] = object->names[last_item_index];
+        object->values[i] = object->values[last_item_index];
+    }
+    object->count -= 1;
+    json_object_invalidate_order(object);
+    json_value_invalidate_cache(object->wrapping_value);
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_remove_internal
+** 功能描述: 从指定的 JSON object 中通过“键值对”的“键”标识符找到与其对应的成员并删除
+** 注     释: 只查找一次“键”所在的位置
+** 输     入: object - 我们要操作的 JSON object 对象
+**         : name - “键值对”的“键”标识符
+**         : taken - 为 NULL 时释放“值”标识符占用的资源，否则把“值”标识符从 JSON object 中取出保存在这里
+**         : keep_order - 为 0 时用最后一个“键值对”填补删除的位置，否则后面的“键值对”依次前移
+** 输     出: JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status json_object_remove_internal(JSON_Object *object, const char *name, JSON_Value **taken, int keep_order) {
+    size_t i = 0;
+    if (object == NULL || name == NULL || IS_FROZEN(object->wrapping_value) ||
+        !json_object_find_index(object, name, strlen(name), &i)) {
+        return JSONFailure;
+    }
+    return json_object_remove_index(object, i, taken, keep_order);
 }
 
 /*********************************************************************************************************
 ** 函数名称: json_object_dotremove_internal
 ** 功能描述: 从指定的 JSON object 中通过“点表示法”找到与其对应的成员并删除
+** 注     释: 路径上共享的 JSON object 会先被替换成私有的副本（写时复制）
 ** 输     入: object - 我们要操作的 JSON object 对象
 **         : name - “点表示法”表示的“键值对”的“键”标识符
-**         : free_value - 是否释放“键值对”的“值”标识符占用的资源
+**         : taken - 为 NULL 时释放“值”标识符占用的资源，否则把“值”标识符从 JSON object 中取出保存在这里
 ** 输     出: JSON_Status - 执行状态
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static JSON_Status json_object_dotremove_internal(JSON_Object *object, const char *name, int free_value) {
+static JSON_Status json_object_dotremove_internal(JSON_Object *object, const char *name, JSON_Value **taken) {
     JSON_Value *temp_value = NULL;
     JSON_Object *temp_object = NULL;
     const char *dot_pos = strchr(name, '.');
     if (dot_pos == NULL) {
-        return json_object_remove_internal(object, name, free_value);
+        return json_object_remove_internal(object, name, taken, 0);
+    }
+    if (object == NULL || IS_FROZEN(object->wrapping_value)) {
+        return JSONFailure;
     }
     temp_value = json_object_getn_value(object, name, dot_pos - name);
     if (json_value_get_type(temp_value) != JSONObject) {
         return JSONFailure;
     }
+    if (IS_FROZEN(temp_value)) { /* copy on write, only if there is something to remove */
+        if (json_object_dotget_value(json_value_get_object(temp_value), dot_pos + 1) == NULL) {
+            return JSONFailure;
+        }
+        temp_value = json_object_unsharen_value(object, name, dot_pos - name);
+        if (temp_value == NULL) {
+            return JSONFailure;
+        }
+    }
     temp_object = json_value_get_object(temp_value);
-    return json_object_dotremove_internal(temp_object, dot_pos + 1, free_value);
+    return json_object_dotremove_internal(temp_object, dot_pos + 1, taken);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_unsharen_value
+** 功能描述: 把指定 JSON object 中指定“键”标识符对应的共享（冻结）成员替换成私有的副本（写时复制）
+** 输     入: object - 我们要操作的 JSON object 对象
+**         : name - “键值对”的“键”标识符
+**         : name_len - “键值对”的“键”标识符长度
+** 输     出: JSON_Value - 可以修改的成员，成员没有共享时就是原来的成员
+**         : NULL - 没有找到对应的成员或者内存不足
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Value * json_object_unsharen_value(JSON_Object *object, const char *name, size_t name_len) {
+    size_t i;
+    for (i = 0; i < json_object_get_count(object); i++) {
+        if (strlen(object->names[i]) == name_len && strncmp(object->names[i], name, name_len) == 0) {
+            return json_value_unshare(&object->values[i], object->wrapping_value);
+        }
+    }
+    return NULL;
 }
 
 /*********************************************************************************************************
@@ -627,12 +1278,131 @@ static JSON_Status json_object_dotremove_internal(JSON_Object *object, const cha
 static void json_object_free(JSON_Object *object) {
     size_t i;
     for (i = 0; i < object->count; i++) {
-        parson_free(object->names[i]);
+        if (object->shape == NULL) {
+            parson_free_string(object->names[i]);
+        }
         json_value_free(object->values[i]);
     }
-    parson_free(object->names);
+    if (object->shape != NULL) {
+        json_shape_release(object->shape);
+    } else {
+        parson_free(object->names);
+    }
     parson_free(object->values);
-    parson_free(object);
+    parson_free(object->cache.fragment);
+    parson_free(object->sorted_order);
+    parson_pool_free(object, sizeof(JSON_Object));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_invalidate_order
+** 功能描述: 释放指定 JSON object 中缓存的“键值对”排序结果，在添加或者删除“键值对”之后调用
+** 输     入: object - 我们要操作的 JSON object 对象
+** 输     出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void json_object_invalidate_order(JSON_Object *object) {
+    parson_free(object->sorted_order);
+    object->sorted_order = NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_own_names
+** 功能描述: 如果指定的 JSON object 使用的是共享的“键”列表，则为它复制一份私有的“键”列表（写时复制）
+** 注     释: 修改 JSON object 的“键”之前需要先调用这个函数
+** 输     入: object - 我们要操作的 JSON object 对象
+** 输     出: JSON_Status - 执行状态，内存不足时 JSON object 保持不变
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status json_object_own_names(JSON_Object *object) {
+    char **names = NULL;
+    size_t i = 0;
+    if (object->shape == NULL) {
+        return JSONSuccess;
+    }
+    names = (char**)parson_malloc(object->capacity * sizeof(char*));
+    if (names == NULL) {
+        return JSONFailure;
+    }
+    for (i = 0; i < object->count; i++) {
+        names[i] = parson_strndup(object->names[i], strlen(object->names[i]));
+        if (names[i] == NULL) {
+            while (i > 0) {
+                parson_free_string(names[--i]);
+            }
+            parson_free(names);
+            return JSONFailure;
+        }
+    }
+    json_shape_release(object->shape);
+    object->shape = NULL;
+    object->names = names;
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_shape_init
+** 功能描述: 把指定 JSON object 的“键”列表转换成一个可以共享的 shape，并为它创建哈希索引
+** 注     释: 转换后 JSON object 的“键”属于新创建的 shape，JSON object 是它的第一个使用者
+** 输     入: object - 我们要操作的 JSON object 对象，不能已经有 shape
+** 输     出: JSON_Shape - 新创建的 shape
+**         : NULL - 内存不足，JSON object 保持不变
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Shape * json_shape_init(JSON_Object *object) {
+    JSON_Shape *shape = NULL;
+    size_t i = 0, slot = 0, buckets = 8;
+    while (buckets < object->count * 2) {
+        buckets *= 2;
+    }
+    shape = (JSON_Shape*)parson_pool_alloc(sizeof(JSON_Shape));
+    if (shape == NULL) {
+        return NULL;
+    }
+    shape->index = (size_t*)parson_malloc(buckets * sizeof(size_t));
+    if (shape->index == NULL) {
+        parson_pool_free(shape, sizeof(JSON_Shape));
+        return NULL;
+    }
+    memset(shape->index, 0, buckets * sizeof(size_t));
+    shape->index_mask = buckets - 1;
+    shape->refcount = 1;
+    shape->count = object->count;
+    shape->names = object->names;
+    for (i = 0; i < shape->count; i++) {
+        slot = snapshot_hash(shape->names[i], strlen(shape->names[i])) & shape->index_mask;
+        while (shape->index[slot] != 0) {
+            slot = (slot + 1) & shape->index_mask;
+        }
+        shape->index[slot] = i + 1;
+    }
+    object->shape = shape;
+    return shape;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_shape_release
+** 功能描述: 释放指定 shape 的一个使用者，最后一个使用者释放时释放 shape 及其“键”列表
+** 注     释: 同一个 shape 的使用者可能在不同的线程中释放（例如冻结后分离的子树），所以使用原子操作计数
+** 输     入: shape - 我们要操作的 shape
+** 输     出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void json_shape_release(JSON_Shape *shape) {
+    size_t i = 0;
+    if (ATOMIC_ADD_LONG(&shape->refcount, -1) != 0) {
+        return;
+    }
+    for (i = 0; i < shape->count; i++) {
+        parson_free_string(shape->names[i]);
+    }
+    parson_free(shape->names);
+    parson_free(shape->index);
+    parson_pool_free(shape, sizeof(JSON_Shape));
 }
 
 /* JSON Array */
@@ -645,7 +1415,7 @@ static void json_object_free(JSON_Object *object) {
 ** 调用模块: 
 *********************************************************************************************************/
 static JSON_Array * json_array_init(JSON_Value *wrapping_value) {
-    JSON_Array *new_array = (JSON_Array*)parson_malloc(sizeof(JSON_Array));
+    JSON_Array *new_array = (JSON_Array*)parson_pool_alloc(sizeof(JSON_Array));
     if (new_array == NULL) {
         return NULL;
     }
@@ -653,6 +1423,10 @@ static JSON_Array * json_array_init(JSON_Value *wrapping_value) {
     new_array->items = (JSON_Value**)NULL;
     new_array->capacity = 0;
     new_array->count = 0;
+    new_array->cache.size = 0;
+    new_array->cache.key = CACHE_KEY_NONE;
+    new_array->cache.fragment_enabled = 0;
+    new_array->cache.fragment = NULL;
     return new_array;
 }
 
@@ -672,14 +1446,73 @@ static JSON_Status json_array_add(JSON_Array *array, JSON_Value *value) {
             return JSONFailure;
         }
     }
-    value->parent = json_array_get_wrapping_value(array);
+    if (!IS_FROZEN(value)) { /* shared values have no parent */
+        SET_VALUE_PARENT(value, json_array_get_wrapping_value(array));
+    }
     array->items[array->count] = value;
     array->count++;
+    json_value_invalidate_cache(array->wrapping_value);
     return JSONSuccess;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_array_resize
+** 函数名称: json_array_add_many
+** 功能描述: 向指定的 JSON array 中追加一组同一类型的标量成员，要么全部追加成功，要么什么也不追加
+** 注     释: 数组空间只扩展一次，序列化信息缓存也只失效一次
+** 输     入: array - 我们要操作的 JSON array 对象
+**         : type - 成员类型，JSONNumber、JSONString 或者 JSONBoolean
+**         : items - 成员内容数组，类型分别是 double、const char * 或者 int
+**         : count - 成员个数
+** 输     出: JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status json_array_add_many(JSON_Array *array, JSON_Value_Type type, const void *items, size_t count) {
+    JSON_Value *value = NULL, *wrapping_value = NULL;
+    size_t i = 0, old_count = 0;
+    if (array == NULL || (items == NULL && count > 0) || IS_FROZEN(array->wrapping_value) ||
+        count > (size_t)-1 / sizeof(JSON_Value*) - array->count) {
+        return JSONFailure;
+    }
+    if (count == 0) {
+        return JSONSuccess;
+    }
+    if (array->count + count > array->capacity &&
+        json_array_resize(array, MAX(array->count + count, STARTING_CAPACITY)) == JSONFailure) {
+        return JSONFailure;
+    }
+    old_count = array->count;
+    wrapping_value = json_array_get_wrapping_value(array);
+    for (i = 0; i < count; i++) {
+        switch (type) {
+            case JSONNumber:
+                value = json_value_init_number(((const double*)items)[i]);
+                break;
+            case JSONString:
+                value = json_value_init_string(((const char * const *)items)[i]);
+                break;
+            case JSONBoolean:
+                value = json_value_init_boolean(((const int*)items)[i]);
+                break;
+            default:
+                value = NULL;
+                break;
+        }
+        if (value == NULL) {
+            while (array->count > old_count) {
+                json_value_free(array->items[--array->count]);
+            }
+            return JSONFailure;
+        }
+        SET_VALUE_PARENT(value, wrapping_value);
+        array->items[array->count++] = value;
+    }
+    json_value_invalidate_cache(wrapping_value);
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_resize
 ** 功能描述: 把指定的 JSON array 的 capacity 设置成指定的新值
 ** 注     释: 一个 JSON array 可以按照数组的方式存储 JSON_Value 数据，在指定的 JSON array 中 capacity 字段
 **         : 表示的是这个 JSON array 可以存储多少个 JSON_Value
@@ -721,10 +1554,175 @@ static void json_array_free(JSON_Array *array) {
         json_value_free(array->items[i]);
     }
     parson_free(array->items);
-    parson_free(array);
+    parson_free(array->cache.fragment);
+    parson_pool_free(array, sizeof(JSON_Array));
 }
 
 /* JSON Value */
+/*********************************************************************************************************
+** 函数名称: json_value_get_cache
+** 功能描述: 获取指定的 JSON_Value 所包含的序列化信息缓存，只有 JSONObject 和 JSONArray 类型才有缓存
+** 输	 入: value - 我们要操作的 JSON_Value 变量
+** 输	 出: JSON_Serialization_Cache * - 序列化信息缓存
+**         : NULL - 没有序列化信息缓存
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Serialization_Cache * json_value_get_cache(const JSON_Value *value) {
+    switch (json_value_get_type(value)) {
+        case JSONObject:
+            return &value->value.object->cache;
+        case JSONArray:
+            return &value->value.array->cache;
+        default:
+            return NULL;
+    }
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_invalidate_cache
+** 功能描述: 把指定的 JSON_Value 及其所有父节点的序列化信息缓存置为无效，在修改 JSON object 或者 JSON array
+**         : 的内容之后调用
+** 注     释: 有效缓存的所有子节点缓存一定有效，所以遇到已经无效的节点时它的父节点也一定无效，可以直接停止
+** 输	 入: value - 内容被修改的 JSON_Value 变量
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void json_value_invalidate_cache(JSON_Value *value) {
+    JSON_Serialization_Cache *cache = NULL;
+    while (value != NULL) {
+        cache = json_value_get_cache(value);
+        if (cache == NULL || cache->key == CACHE_KEY_NONE) {
+            return;
+        }
+        cache->key = CACHE_KEY_NONE;
+        value = VALUE_PARENT(value);
+    }
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_freeze_r
+** 功能描述: 冻结指定的 JSON_Value 及其包含的所有 JSON_Value
+** 注     释: 第一遍（mark 为 0）为所有包含多个“键值对”的 JSON object 生成排序索引，这一步可能因为内存不足
+**         : 失败；第二遍（mark 为 1）只设置冻结标志（引用计数为 1）并清除父节点指针，不会失败。已经冻结的
+**         : 共享子树会被跳过
+** 输	 入: value - 我们要冻结的 JSON_Value
+**         : mark - 是否设置冻结标志
+** 输	 出: JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status json_value_freeze_r(JSON_Value *value, int mark) {
+    JSON_Object *object = NULL;
+    JSON_Array *array = NULL;
+    size_t i = 0;
+    if (IS_FROZEN(value)) { /* shared subtree, frozen already */
+        return JSONSuccess;
+    }
+    if (json_value_get_type(value) == JSONObject) {
+        object = json_value_get_object(value);
+        if (!mark && json_object_get_count(object) > 1 && json_object_get_sorted_order(object) == NULL) {
+            return JSONFailure;
+        }
+        for (i = 0; i < json_object_get_count(object); i++) {
+            if (json_value_freeze_r(object->values[i], mark) == JSONFailure) {
+                return JSONFailure;
+            }
+        }
+    } else if (json_value_get_type(value) == JSONArray) {
+        array = json_value_get_array(value);
+        for (i = 0; i < json_array_get_count(array); i++) {
+            if (json_value_freeze_r(array->items[i], mark) == JSONFailure) {
+                return JSONFailure;
+            }
+        }
+    }
+    if (mark) {
+        SET_VALUE_PARENT(value, NULL);
+        value->refcount = 1; /* the reference held by the parent, or by the caller for the root */
+    }
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_copy_shared
+** 功能描述: 创建指定冻结 JSON_Value 的一个没有冻结的副本
+** 注     释: JSON object 和 JSON array 只复制一层，副本的成员是原来成员（都已经冻结）的新引用
+** 输	 入: value - 需要复制的 JSON_Value
+** 输	 出: JSON_Value - 新创建的副本
+**         : NULL - 内存不足
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Value * json_value_copy_shared(const JSON_Value *value) {
+    JSON_Value *copy = NULL, *member = NULL;
+    JSON_Object *object = NULL;
+    JSON_Array *array = NULL;
+    JSON_Status status = JSONSuccess;
+    size_t i = 0;
+    if (json_value_get_type(value) == JSONObject) {
+        object = json_value_get_object(value);
+        copy = json_value_init_object();
+        if (copy == NULL || json_object_resize(json_value_get_object(copy), MAX(object->count, 1)) == JSONFailure) {
+            json_value_free(copy);
+            return NULL;
+        }
+        for (i = 0; i < object->count && status == JSONSuccess; i++) {
+            member = json_value_share(object->values[i]);
+            status = json_object_add(json_value_get_object(copy), object->names[i], member);
+        }
+    } else if (json_value_get_type(value) == JSONArray) {
+        array = json_value_get_array(value);
+        copy = json_value_init_array();
+        if (copy == NULL || json_array_resize(json_value_get_array(copy), MAX(array->count, 1)) == JSONFailure) {
+            json_value_free(copy);
+            return NULL;
+        }
+        for (i = 0; i < array->count && status == JSONSuccess; i++) {
+            member = json_value_share(array->items[i]);
+            status = json_array_add(json_value_get_array(copy), member);
+        }
+    } else {
+        return json_value_deep_copy(value);
+    }
+    if (status == JSONFailure) {
+        json_value_free(member);
+        json_value_free(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_unshare
+** 功能描述: 如果指定位置上的 JSON_Value 是共享的（冻结的），把它替换成一个私有的副本并释放原来的引用
+** 注     释: 副本没有序列化信息缓存，而失效操作遇到没有缓存的节点就会停止，所以替换之后要让父节点的缓存失效
+** 输	 入: slot - 保存成员指针的位置（JSON object 或者 JSON array 中）
+**         : parent - 成员所属的 JSON_Value，必须没有冻结
+** 输	 出: JSON_Value - 可以修改的成员
+**         : NULL - 内存不足
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Value * json_value_unshare(JSON_Value **slot, JSON_Value *parent) {
+    JSON_Value *copy = NULL;
+    if (!IS_FROZEN(*slot)) {
+        return *slot;
+    }
+    copy = json_value_copy_shared(*slot);
+    if (copy == NULL) {
+        return NULL;
+    }
+    SET_VALUE_PARENT(copy, parent);
+    json_value_free(*slot);
+    *slot = copy;
+    /* the copy starts without a cache, so later changes under it can't reach the parents, their caches
+       have to be dropped now */
+    json_value_invalidate_cache(parent);
+    return copy;
+}
+
 /*********************************************************************************************************
 ** 函数名称: json_value_init_string_no_copy
 ** 功能描述: 创建并初始化一个             JSONString 类型的 JSON_Value 变量
@@ -734,17 +1732,58 @@ static void json_array_free(JSON_Array *array) {
 ** 调用模块: 
 *********************************************************************************************************/
 static JSON_Value * json_value_init_string_no_copy(char *string) {
-    JSON_Value *new_value = (JSON_Value*)parson_malloc(sizeof(JSON_Value));
+    JSON_Value *new_value = (JSON_Value*)parson_pool_alloc(sizeof(JSON_Value));
     if (!new_value) {
         return NULL;
     }
-    new_value->parent = NULL;
+    SET_VALUE_PARENT(new_value, NULL);
+    new_value->refcount = 0;
     new_value->type = JSONString;
     new_value->value.string = string;
     return new_value;
 }
 
 /* Parser */
+/*********************************************************************************************************
+** 函数名称: skip_whitespaces
+** 功能描述: 跳过指定字符串起始位置的空白字符，允许注释时同时跳过 / * * / 和 // 格式的注释信息
+** 注     释: 没有结束标识符的 // 注释一直延续到字符串结尾，没有结束标识符的 / * 注释不会被跳过，由后续的解析
+**         : 逻辑报告错误
+** 输     入: string - 需要跳过空白字符的字符串
+**         : allow_comments - 是否把注释信息当作空白字符跳过
+** 输     出: string - 跳过空白字符后的字符串
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void skip_whitespaces(const char **string, int allow_comments) {
+    const char *ptr = *string, *end = NULL;
+    for (;;) {
+        while (isspace((unsigned char)*ptr)) {
+            ptr++;
+        }
+        if (!allow_comments || ptr[0] != '/') {
+            break;
+        }
+        if (ptr[1] == '*') {
+            end = strstr(ptr + 2, "*/");
+            if (end == NULL) {
+                break;
+            }
+            ptr = end + 2;
+        } else if (ptr[1] == '/') {
+            end = strchr(ptr + 2, '\n');
+            if (end == NULL) {
+                ptr += strlen(ptr);
+                break;
+            }
+            ptr = end + 1;
+        } else {
+            break;
+        }
+    }
+    *string = ptr;
+}
+
 /*********************************************************************************************************
 ** 函数名称: skip_quotes
 ** 功能描述: 找到第一个双引号对的位置，比如函数参数的内容为：
@@ -833,26 +1872,22 @@ static int parse_utf16(const char **unprocessed, char **processed) {
 
 
 /* Copies and processes passed string up to supplied length.
-Example: "\u006Corem ipsum" -> lorem ipsum */
+Example: "lorem ipsum" -> lorem ipsum */
 /*********************************************************************************************************
-** 函数名称: process_string
-** 功能描述: 把不同格式的输入字符串数据转换成与其对应的 ascii 字符串格式
+** 函数名称: decode_string
+** 功能描述: 把 JSON 字符串中双引号之间的内容（包括转义字符）转换成与其对应的 utf8 字符串，写入指定的缓冲区
+** 注     释: 转换后的长度不会超过转换前的长度，所以缓冲区至少需要 len + 1 个字节
 ** 输     入: input - 需要转换的不同格式数据
 **         : len - 我们需要转换的字符长度
-** 输     出: output - 转换后 的 ascii 字符串格式地址
+**         : output - 保存转换结果的缓冲区
+** 输     出: char * - 转换结果结尾的 '\0' 字符的位置
+**         : NULL - 输入的字符串格式错误
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static char* process_string(const char *input, size_t len) {
+static char * decode_string(const char *input, size_t len, char *output) {
     const char *input_ptr = input;
-    size_t initial_size = (len + 1) * sizeof(char);
-    size_t final_size = 0;
-    char *output = NULL, *output_ptr = NULL, *resized_output = NULL;
-    output = (char*)parson_malloc(initial_size);
-    if (output == NULL) {
-        goto error;
-    }
-    output_ptr = output;
+    char *output_ptr = output;
     while ((*input_ptr != '\0') && (size_t)(input_ptr - input) < len) {
         if (*input_ptr == '\\') {
             input_ptr++;
@@ -867,14 +1902,14 @@ static char* process_string(const char *input, size_t len) {
                 case 't':  *output_ptr = '\t'; break;
                 case 'u':
                     if (parse_utf16(&input_ptr, &output_ptr) == JSONFailure) {
-                        goto error;
+                        return NULL;
                     }
                     break;
                 default:
-                    goto error;
+                    return NULL;
             }
         } else if ((unsigned char)*input_ptr < 0x20) {
-            goto error; /* 0x00-0x19 are invalid characters for JSON string (http://www.ietf.org/rfc/rfc4627.txt) */
+            return NULL; /* 0x00-0x19 are invalid characters for JSON string (http://www.ietf.org/rfc/rfc4627.txt) */
         } else {
             *output_ptr = *input_ptr;
         }
@@ -882,18 +1917,42 @@ static char* process_string(const char *input, size_t len) {
         input_ptr++;
     }
     *output_ptr = '\0';
+    return output_ptr;
+}
+
+/*********************************************************************************************************
+** 函数名称: process_string
+** 功能描述: 把不同格式的输入字符串数据转换成与其对应的 ascii 字符串格式
+** 输     入: input - 需要转换的不同格式数据
+**         : len - 我们需要转换的字符长度
+** 输     出: output - 转换后 的 ascii 字符串格式地址
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static char* process_string(const char *input, size_t len) {
+    size_t initial_size = (len + 1) * sizeof(char);
+    size_t final_size = 0;
+    char *output = NULL, *output_end = NULL, *resized_output = NULL;
+    output = (char*)parson_pool_alloc(initial_size);
+    if (output == NULL) {
+        goto error;
+    }
+    output_end = decode_string(input, len, output);
+    if (output_end == NULL) {
+        goto error;
+    }
     /* resize to new length */
-    final_size = (size_t)(output_ptr-output) + 1;
+    final_size = (size_t)(output_end - output) + 1;
     /* todo: don't resize if final_size == initial_size */
-    resized_output = (char*)parson_malloc(final_size);
+    resized_output = (char*)parson_pool_alloc(final_size);
     if (resized_output == NULL) {
         goto error;
     }
     memcpy(resized_output, output, final_size);
-    parson_free(output);
+    parson_pool_free(output, initial_size);
     return resized_output;
 error:
-    parson_free(output);
+    parson_pool_free(output, initial_size);
     return NULL;
 }
 
@@ -905,53 +1964,267 @@ error:
 **         : ascii 字符串格式并返回，例如：
 **         : if arg string = "name": "zhaoge.zhang"
 **         : return char * =  name
+** 注     释: recycled 不为 NULL 并且足够长时直接把结果写入 recycled，不分配内存
 ** 输     入: string - 需要提取的字符串指针
+**         : recycled - 可以重复使用的字符串（上一次解析的结果），不再使用时会被释放，可以为 NULL
 ** 输     出: output - 转换后的 ascii 字符串格式地址
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static char * get_quoted_string(const char **string) {
+static char * get_quoted_string(const char **string, char *recycled) {
     const char *string_start = *string;
     size_t string_len = 0;
     JSON_Status status = skip_quotes(string);
     if (status != JSONSuccess) {
+        parson_free_string(recycled);
         return NULL;
     }
     string_len = *string - string_start - 2; /* length without quotes */
+    if (recycled != NULL && strlen(recycled) >= string_len) {
+        if (decode_string(string_start + 1, string_len, recycled) == NULL) {
+            parson_free_string(recycled);
+            return NULL;
+        }
+        return recycled;
+    }
+    parson_free_string(recycled);
     return process_string(string_start + 1, string_len);
 }
 
+/*********************************************************************************************************
+** 函数名称: json_shape_name_matches
+** 功能描述: 判断以“双引号”开头的字符串中，第一个“双引号对”中的数据内容是否就是指定 shape 中的第 index 个“键”
+** 注     释: 直接比较原始字符，不转换也不分配内存。包含转义字符的“键”总是认为不相同，由调用者按照普通的
+**         : “键”解析，所以结果不会出错
+** 输     入: shape - 我们要比较的 shape
+**         : index - 我们要比较的“键”在 shape 中的下标
+**         : string - 需要比较的字符串指针
+** 输     出: 1 - 相同
+**         : 0 - 不相同
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static int json_shape_name_matches(const JSON_Shape *shape, size_t index, const char *string) {
+    const char *name = NULL;
+    if (index >= shape->count || *string != '\"') {
+        return 0;
+    }
+    for (name = shape->names[index], string++; *name != '\0'; name++, string++) {
+        if (*string != *name || *string == '\"' || *string == '\\' || (unsigned char)*string < 0x20) {
+            return 0;
+        }
+    }
+    return *string == '\"';
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_recycle
+** 功能描述: 把上一次解析得到的 JSON_Value 准备成指定类型的 JSON_Value 重复使用
+** 注     释: 类型相同的 JSON object 和 JSON array 保留成员（由调用者逐个重复使用或者释放）和存储空间，JSON
+**         : object 还保留它的 shape，其他类型的内容都会被释放，只保留 JSON_Value 节点本身。冻结的（共享的）
+**         : JSON_Value 不能重复使用，只释放一个引用，JSON object 和 JSON array 不能由其他类型的节点转换而来
+** 输     入: recycled - 需要重复使用的 JSON_Value，可以为 NULL
+**         : type - 需要的 JSON_Value 类型
+** 输     出: JSON_Value - 可以重复使用的 JSON_Value
+**         : NULL - 不能重复使用，调用者需要创建新的 JSON_Value
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Value * json_value_recycle(JSON_Value *recycled, JSON_Value_Type type) {
+    JSON_Serialization_Cache *cache = NULL;
+    if (recycled == NULL) {
+        return NULL;
+    }
+    if (IS_FROZEN(recycled) ||
+        ((type == JSONObject || type == JSONArray) && json_value_get_type(recycled) != type)) {
+        json_value_free(recycled);
+        return NULL;
+    }
+    switch (json_value_get_type(recycled)) {
+        case JSONObject:
+            if (type != JSONObject) {
+                json_object_free(recycled->value.object);
+            } else {
+                json_object_invalidate_order(recycled->value.object);
+            }
+            break;
+        case JSONArray:
+            if (type != JSONArray) {
+                json_array_free(recycled->value.array);
+            }
+            break;
+        case JSONString:
+            parson_free_string(recycled->value.string);
+            break;
+        default:
+            break;
+    }
+    if (type == JSONObject || type == JSONArray) { /* start with a clean cache, like a new container */
+        cache = json_value_get_cache(recycled);
+        parson_free(cache->fragment);
+        cache->fragment = NULL;
+        cache->fragment_enabled = 0;
+        cache->key = CACHE_KEY_NONE;
+    }
+    SET_VALUE_PARENT(recycled, NULL);
+    recycled->type = type;
+    return recycled;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_shape_table_share
+** 功能描述: 释放指定 JSON object 自己的“键”列表，让它使用指定 shape 中相同的“键”列表
+** 输     入: object - 我们要操作的 JSON object 对象，不能已经有 shape
+**         : shape - 我们要共享的 shape，“键”列表和 JSON object 的“键”列表相同
+** 输     出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void json_shape_table_share(JSON_Object *object, JSON_Shape *shape) {
+    size_t i = 0;
+    for (i = 0; i < object->count; i++) {
+        parson_free_string(object->names[i]);
+    }
+    parson_free(object->names);
+    ATOMIC_ADD_LONG(&shape->refcount, 1);
+    object->names = shape->names;
+    object->shape = shape;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_shape_table_intern
+** 功能描述: 在 shape 表中查找和指定 JSON object 的“键”列表（个数、顺序和内容）相同的 JSON object，找到时让
+**         : 它们共享同一个 shape，并释放指定 JSON object 自己的“键”列表，找不到时把它记录到 shape 表中
+** 注     释: 只有一个 JSON object 使用的“键”列表不会创建 shape；内存不足时不共享，不影响解析结果。重复使用时
+**         : 保留了 shape 的 JSON object 也记录到 shape 表中，之后新解析的相同的 JSON object 直接共享它的 shape
+** 输     入: table - 本次解析的 shape 表，为 NULL 时不共享
+**         : object - 刚刚解析完成的 JSON object
+** 输     出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void json_shape_table_intern(JSON_Shape_Table *table, JSON_Object *object) {
+    JSON_Shape_Entry *entries = NULL, *entry = NULL;
+    size_t hash = 2166136261UL, i = 0, slot = 0, new_capacity = 0;
+    if (table == NULL || object->count == 0) {
+        return;
+    }
+    if (table->count * 2 >= table->capacity) { /* keep at most half of the table full */
+        new_capacity = MAX(table->capacity * 2, SHAPE_TABLE_CAPACITY);
+        entries = (JSON_Shape_Entry*)parson_malloc(new_capacity * sizeof(JSON_Shape_Entry));
+        if (entries == NULL) {
+            return;
+        }
+        memset(entries, 0, new_capacity * sizeof(JSON_Shape_Entry));
+        for (i = 0; i < table->capacity; i++) {
+            if (table->entries[i].first != NULL) {
+                slot = table->entries[i].hash & (new_capacity - 1);
+                while (entries[slot].first != NULL) {
+                    slot = (slot + 1) & (new_capacity - 1);
+                }
+                entries[slot] = table->entries[i];
+            }
+        }
+        parson_free(table->entries);
+        table->entries = entries;
+        table->capacity = new_capacity;
+    }
+    for (i = 0; i < object->count; i++) {
+        hash = ((hash * 16777619UL) ^ snapshot_hash(object->names[i], strlen(object->names[i]))) & 0xFFFFFFFFUL;
+    }
+    slot = hash & (table->capacity - 1);
+    for (entry = &table->entries[slot]; entry->first != NULL; entry = &table->entries[slot]) {
+        if (entry->hash == hash && entry->first->count == object->count) {
+            for (i = 0; i < object->count; i++) {
+                if (strcmp(entry->first->names[i], object->names[i]) != 0) {
+                    break;
+                }
+            }
+            if (i == object->count) {
+                if (object->shape != NULL) { /* a reused object, the first one shares its shape */
+                    if (entry->shape == NULL) {
+                        json_shape_table_share(entry->first, object->shape);
+                        entry->shape = object->shape;
+                    }
+                    return;
+                }
+                if (entry->shape == NULL) {
+                    entry->shape = json_shape_init(entry->first);
+                    if (entry->shape == NULL) {
+                        return;
+                    }
+                }
+                json_shape_table_share(object, entry->shape);
+                return;
+            }
+        }
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    entry->hash = hash;
+    entry->first = object;
+    entry->shape = object->shape;
+    table->count++;
+}
+
+/*********************************************************************************************************
+** 函数名称: parse_root_value
+** 功能描述: 解析一个完整的 JSON 字符串数据，解析过程中使用一个 shape 表让“键”列表相同的 JSON object 共享“键”
+** 输     入: string - 需要解析的 JSON 字符串
+**         : allow_comments - 是否把 / * * / 和 // 格式的注释信息当作空白字符跳过
+**         : recycled - 可以重复使用的上一次解析的结果，不管解析是否成功都会被重复使用或者释放，可以为 NULL
+** 输     出: JSON_Value - 转换后的“树形结构” JSON 数据
+**         : NULL - 转换失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Value * parse_root_value(const char **string, int allow_comments, JSON_Value *recycled) {
+    JSON_Shape_Table shapes;
+    JSON_Value *value = NULL;
+    shapes.entries = NULL;
+    shapes.count = 0;
+    shapes.capacity = 0;
+    value = parse_value(string, 0, allow_comments, recycled, &shapes);
+    parson_free(shapes.entries);
+    return value;
+}
+
 /*********************************************************************************************************
 ** 函数名称: parse_value
 ** 功能描述: 解析指定的 JSON 字符串数据，将其转换成“树形结构”表示形式
 ** 输     入: string - 需要解析的 JSON 字符串
 **         : nesting - 当前解析的 JSON 字符串在整个 JSON 数据中的嵌套层数
+**         : allow_comments - 是否把 / * * / 和 // 格式的注释信息当作空白字符跳过
+**         : recycled - 可以重复使用的上一次解析的结果，不管解析是否成功都会被重复使用或者释放，可以为 NULL
+**         : shapes - 本次解析的 shape 表，可以为 NULL
 ** 输     出: JSON_Value - 转换后的“树形结构” JSON 数据
 **         : NULL - 转换失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static JSON_Value * parse_value(const char **string, size_t nesting) {
+static JSON_Value * parse_value(const char **string, size_t nesting, int allow_comments, JSON_Value *recycled,
+                                JSON_Shape_Table *shapes) {
     if (nesting > MAX_NESTING) {
+        json_value_free(recycled);
         return NULL;
     }
-    SKIP_WHITESPACES(string);
+    skip_whitespaces(string, allow_comments);
     switch (**string) {
         case '{':
-            return parse_object_value(string, nesting + 1);
+            return parse_object_value(string, nesting + 1, allow_comments, recycled, shapes);
         case '[':
-            return parse_array_value(string, nesting + 1);
+            return parse_array_value(string, nesting + 1, allow_comments, recycled, shapes);
         case '\"':
-            return parse_string_value(string);
+            return parse_string_value(string, recycled);
         case 'f': case 't':
-            return parse_boolean_value(string);
+            return parse_boolean_value(string, recycled);
         case '-':
         case '0': case '1': case '2': case '3': case '4':
         case '5': case '6': case '7': case '8': case '9':
-            return parse_number_value(string);
+            return parse_number_value(string, recycled);
         case 'n':
-            return parse_null_value(string);
+            return parse_null_value(string, recycled);
         default:
+            json_value_free(recycled);
             return NULL;
     }
 }
@@ -959,149 +2232,255 @@ static JSON_Value * parse_value(const char **string, size_t nesting) {
 /*********************************************************************************************************
 ** 函数名称: parse_object_value
 ** 功能描述: 把“序列化”格式的字符串 JSON object 解析并转换成与其对应的“树形结构”格式的 JSON_Value 数据
+** 注     释: “键值对”直接按顺序写入 names 和 values 数组，重复使用 recycled 时，第 i 个“键值对”使用 recycled
+**         : 中原来第 i 个“键值对”的“键”和“值”，多余的原来的“键值对”在解析结束后释放。recycled 有 shape 时，
+**         : 只要“键”按顺序和 shape 中的“键”相同就继续使用这个 shape，只重复使用“值”，不分配任何“键”，不相同时
+**         : 才复制一份私有的“键”列表。解析完成后的 JSON object 和本次解析中“键”列表相同的 JSON object 共享“键”列表
 ** 输     入: string - 需要解析的“序列化”格式的字符串
 **         : nesting - 当前 JSON object 在整个 JSON 数据中的嵌套层数
+**         : allow_comments - 是否把 / * * / 和 // 格式的注释信息当作空白字符跳过
+**         : recycled - 可以重复使用的上一次解析的结果，可以为 NULL
+**         : shapes - 本次解析的 shape 表，可以为 NULL
 ** 输     出: JSON_Value - 转换后的“树形结构”格式的 JSON_Value 数据
 **         : NULL - 转换失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static JSON_Value * parse_object_value(const char **string, size_t nesting) {
-    JSON_Value *output_value = NULL, *new_value = NULL;
+static JSON_Value * parse_object_value(const char **string, size_t nesting, int allow_comments, JSON_Value *recycled,
+                                       JSON_Shape_Table *shapes) {
+    JSON_Value *output_value = NULL, *new_value = NULL, *old_value = NULL;
     JSON_Object *output_object = NULL;
-    char *new_key = NULL;
-    output_value = json_value_init_object();
+    char *new_key = NULL, *old_key = NULL, *owned_key = NULL; /* owned_key is NULL when new_key is in a shape */
+    size_t old_count = 0, i = 0, j = 0;
+    int reused = 0;
+    output_value = json_value_recycle(recycled, JSONObject);
+    reused = output_value != NULL;
+    if (!reused) {
+        output_value = json_value_init_object();
+    }
     if (output_value == NULL) {
         return NULL;
     }
+    output_object = json_value_get_object(output_value);
+    old_count = output_object->count; /* members after count are old ones, reused or freed below */
+    output_object->count = 0;
     if (**string != '{') {
-        json_value_free(output_value);
-        return NULL;
+        goto error;
     }
-    output_object = json_value_get_object(output_value);
     SKIP_CHAR(string);
-    SKIP_WHITESPACES(string);
+    skip_whitespaces(string, allow_comments);
     if (**string == '}') { /* empty object */
-        SKIP_CHAR(string);
-        return output_value;
+        goto done;
     }
     while (**string != '\0') {
-        new_key = get_quoted_string(string);
+        i = output_object->count;
+        old_key = NULL;
+        old_value = NULL;
+        if (i < old_count) {
+            old_value = output_object->values[i];
+            output_object->values[i] = NULL;
+        }
+        if (output_object->shape != NULL && !json_shape_name_matches(output_object->shape, i, *string)) {
+            if (json_object_own_names(output_object) == JSONFailure) { /* copies the first i names */
+                json_value_free(old_value);
+                goto error;
+            }
+            for (j = i; j < old_count; j++) {
+                output_object->names[j] = NULL;
+            }
+        }
+        if (output_object->shape != NULL) { /* same name as before, it's already in names[i] */
+            skip_quotes(string);
+            new_key = output_object->names[i];
+            owned_key = NULL;
+        } else {
+            if (i < old_count) {
+                old_key = output_object->names[i];
+                output_object->names[i] = NULL;
+            }
+            new_key = get_quoted_string(string, old_key);
+            owned_key = new_key;
+        }
         if (new_key == NULL) {
-            json_value_free(output_value);
-            return NULL;
+            json_value_free(old_value);
+            goto error;
         }
-        SKIP_WHITESPACES(string);
+        skip_whitespaces(string, allow_comments);
         if (**string != ':') {
-            parson_free(new_key);
-            json_value_free(output_value);
-            return NULL;
+            parson_free_string(owned_key);
+            json_value_free(old_value);
+            goto error;
         }
         SKIP_CHAR(string);
-        new_value = parse_value(string, nesting);
+        new_value = parse_value(string, nesting, allow_comments, old_value, shapes);
         if (new_value == NULL) {
-            parson_free(new_key);
-            json_value_free(output_value);
-            return NULL;
+            parson_free_string(owned_key);
+            goto error;
         }
-        if (json_object_add(output_object, new_key, new_value) == JSONFailure) {
-            parson_free(new_key);
+        if ((output_object->shape == NULL && /* names of a shape are distinct */
+             json_object_getn_value(output_object, new_key, strlen(new_key)) != NULL) || /* duplicate */
+            (i >= output_object->capacity && /* only new members are left when it's full */
+             json_object_resize(output_object, MAX(output_object->capacity * 2, STARTING_CAPACITY)) == JSONFailure)) {
+            parson_free_string(owned_key);
             json_value_free(new_value);
-            json_value_free(output_value);
-            return NULL;
+            goto error;
         }
-        parson_free(new_key);
-        SKIP_WHITESPACES(string);
+        output_object->names[i] = new_key;
+        output_object->values[i] = new_value;
+        SET_VALUE_PARENT(new_value, output_value);
+        output_object->count++;
+        skip_whitespaces(string, allow_comments);
         if (**string != ',') {
             break;
         }
         SKIP_CHAR(string);
-        SKIP_WHITESPACES(string);
+        skip_whitespaces(string, allow_comments);
     }
-    SKIP_WHITESPACES(string);
-    if (**string != '}' || /* Trim object after parsing is over */
-        json_object_resize(output_object, json_object_get_count(output_object)) == JSONFailure) {
-            json_value_free(output_value);
-            return NULL;
+    skip_whitespaces(string, allow_comments);
+    if (**string != '}' || /* Trim new objects after parsing is over, reused ones keep their capacity */
+        (!reused && json_object_resize(output_object, json_object_get_count(output_object)) == JSONFailure)) {
+        goto error;
     }
+done:
     SKIP_CHAR(string);
+    for (i = output_object->count; i < old_count; i++) {
+        if (output_object->shape == NULL) {
+            parson_free_string(output_object->names[i]);
+        }
+        json_value_free(output_object->values[i]);
+        output_object->values[i] = NULL;
+    }
+    if (output_object->shape != NULL && output_object->count != output_object->shape->count &&
+        json_object_own_names(output_object) == JSONFailure) { /* fewer members than the shape */
+        goto error;
+    }
+    json_shape_table_intern(shapes, output_object);
     return output_value;
-}
-
-/*********************************************************************************************************
+error:
+    for (i = output_object->count; i < old_count; i++) {
+        if (output_object->shape == NULL) {
+            parson_free_string(output_object->names[i]);
+        }
+        json_value_free(output_object->values[i]);
+    }
+    json_value_free(output_value);
+    return NULL;
+}
+
+/*********************************************************************************************************
 ** 函数名称: parse_array_value
 ** 功能描述: 把“序列化”格式的字符串 JSON array 解析并转换成与其对应的“树形结构”格式的 JSON_Value 数据
+** 注     释: 重复使用 recycled 时，第 i 个成员使用 recycled 中原来的第 i 个成员，多余的原来的成员在解析结束后释放
 ** 输     入: string - 需要解析的“序列化”格式的字符串
 **         : nesting - 当前 JSON object 在整个 JSON 数据中的嵌套层数
+**         : allow_comments - 是否把 / * * / 和 // 格式的注释信息当作空白字符跳过
+**         : recycled - 可以重复使用的上一次解析的结果，可以为 NULL
+**         : shapes - 本次解析的 shape 表，可以为 NULL
 ** 输     出: JSON_Value - 转换后的“树形结构”格式的 JSON_Value 数据
 **         : NULL - 转换失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static JSON_Value * parse_array_value(const char **string, size_t nesting) {
-    JSON_Value *output_value = NULL, *new_array_value = NULL;
+static JSON_Value * parse_array_value(const char **string, size_t nesting, int allow_comments, JSON_Value *recycled,
+                                      JSON_Shape_Table *shapes) {
+    JSON_Value *output_value = NULL, *new_array_value = NULL, *old_value = NULL;
     JSON_Array *output_array = NULL;
-    output_value = json_value_init_array();
+    size_t old_count = 0, i = 0;
+    int reused = 0;
+    output_value = json_value_recycle(recycled, JSONArray);
+    reused = output_value != NULL;
+    if (!reused) {
+        output_value = json_value_init_array();
+    }
     if (output_value == NULL) {
         return NULL;
     }
+    output_array = json_value_get_array(output_value);
+    old_count = output_array->count; /* items after count are old ones, reused or freed below */
+    output_array->count = 0;
     if (**string != '[') {
-        json_value_free(output_value);
-        return NULL;
+        goto error;
     }
-    output_array = json_value_get_array(output_value);
     SKIP_CHAR(string);
-    SKIP_WHITESPACES(string);
+    skip_whitespaces(string, allow_comments);
     if (**string == ']') { /* empty array */
-        SKIP_CHAR(string);
-        return output_value;
+        goto done;
     }
     while (**string != '\0') {
-        new_array_value = parse_value(string, nesting);
+        i = output_array->count;
+        old_value = NULL;
+        if (i < old_count) {
+            old_value = output_array->items[i];
+            output_array->items[i] = NULL;
+        }
+        new_array_value = parse_value(string, nesting, allow_comments, old_value, shapes);
         if (new_array_value == NULL) {
-            json_value_free(output_value);
-            return NULL;
+            goto error;
         }
-        if (json_array_add(output_array, new_array_value) == JSONFailure) {
+        if (i >= output_array->capacity && /* only new items are left when it's full */
+            json_array_resize(output_array, MAX(output_array->capacity * 2, STARTING_CAPACITY)) == JSONFailure) {
             json_value_free(new_array_value);
-            json_value_free(output_value);
-            return NULL;
+            goto error;
         }
-        SKIP_WHITESPACES(string);
+        output_array->items[i] = new_array_value;
+        SET_VALUE_PARENT(new_array_value, output_value);
+        output_array->count++;
+        skip_whitespaces(string, allow_comments);
         if (**string != ',') {
             break;
         }
         SKIP_CHAR(string);
-        SKIP_WHITESPACES(string);
+        skip_whitespaces(string, allow_comments);
     }
-    SKIP_WHITESPACES(string);
-    if (**string != ']' || /* Trim array after parsing is over */
-        json_array_resize(output_array, json_array_get_count(output_array)) == JSONFailure) {
-            json_value_free(output_value);
-            return NULL;
+    skip_whitespaces(string, allow_comments);
+    if (**string != ']' || /* Trim new arrays after parsing is over, reused ones keep their capacity */
+        (!reused && json_array_resize(output_array, json_array_get_count(output_array)) == JSONFailure)) {
+        goto error;
     }
+done:
     SKIP_CHAR(string);
+    for (i = output_array->count; i < old_count; i++) {
+        json_value_free(output_array->items[i]);
+    }
     return output_value;
+error:
+    for (i = output_array->count; i < old_count; i++) {
+        json_value_free(output_array->items[i]);
+    }
+    json_value_free(output_value);
+    return NULL;
 }
 
 /*********************************************************************************************************
 ** 函数名称: parse_string_value
 ** 功能描述: 把“序列化”的双引号格式的 JSON string 解析并转换成与其对应的“树形结构”格式的 JSON_Value 数据
 ** 输     入: string - 需要解析的“序列化”的双引号格式的字符串
+**         : recycled - 可以重复使用的上一次解析的结果，原来是 JSON string 时也重复使用它的字符串，可以为 NULL
 ** 输     出: JSON_Value - 转换后的“树形结构”格式的 JSON_String 数据
 **         : NULL - 转换失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static JSON_Value * parse_string_value(const char **string) {
+static JSON_Value * parse_string_value(const char **string, JSON_Value *recycled) {
     JSON_Value *value = NULL;
-    char *new_string = get_quoted_string(string);
+    char *new_string = NULL, *old_string = NULL;
+    if (recycled != NULL && !IS_FROZEN(recycled) && json_value_get_type(recycled) == JSONString) {
+        old_string = recycled->value.string;
+        recycled->value.string = NULL;
+    }
+    new_string = get_quoted_string(string, old_string);
+    value = json_value_recycle(recycled, JSONString);
     if (new_string == NULL) {
+        json_value_free(value);
         return NULL;
     }
+    if (value != NULL) {
+        value->value.string = new_string;
+        return value;
+    }
     value = json_value_init_string_no_copy(new_string);
     if (value == NULL) {
-        parson_free(new_string);
+        parson_free_string(new_string);
         return NULL;
     }
     return value;
@@ -1111,1406 +2490,4939 @@ static JSON_Value * parse_string_value(const char **string) {
 ** 函数名称: parse_boolean_value
 ** 功能描述: 把“序列化”的 JSON bool 类型变量解析并转换成与其对应的“树形结构”格式的 JSON_Value 数据
 ** 输     入: string - 需要解析的“序列化”的 JSON bool 字符串
+**         : recycled - 可以重复使用的上一次解析的结果，可以为 NULL
 ** 输     出: JSON_Value - 转换后的“树形结构”格式的 JSON_Bool 数据
 **         : NULL - 转换失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static JSON_Value * parse_boolean_value(const char **string) {
+static JSON_Value * parse_boolean_value(const char **string, JSON_Value *recycled) {
     size_t true_token_size = SIZEOF_TOKEN("true");
     size_t false_token_size = SIZEOF_TOKEN("false");
+    JSON_Value *value = NULL;
+    int boolean = 0;
     if (strncmp("true", *string, true_token_size) == 0) {
         *string += true_token_size;
-        return json_value_init_boolean(1);
+        boolean = 1;
     } else if (strncmp("false", *string, false_token_size) == 0) {
         *string += false_token_size;
-        return json_value_init_boolean(0);
+        boolean = 0;
+    } else {
+        json_value_free(recycled);
+        return NULL;
     }
-    return NULL;
+    value = json_value_recycle(recycled, JSONBoolean);
+    if (value == NULL) {
+        return json_value_init_boolean(boolean);
+    }
+    value->value.boolean = boolean;
+    return value;
 }
 
 /*********************************************************************************************************
 ** 函数名称: parse_number_value
 ** 功能描述: 把“序列化”的 JSON number 类型变量解析并转换成与其对应的“树形结构”格式的 JSON_Value 数据
 ** 输     入: string - 需要解析的“序列化”的 JSON number 字符串
+**         : recycled - 可以重复使用的上一次解析的结果，可以为 NULL
 ** 输     出: JSON_Value - 转换后的“树形结构”格式的 JSON_Number 数据
 **         : NULL - 转换失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static JSON_Value * parse_number_value(const char **string) {
+static JSON_Value * parse_number_value(const char **string, JSON_Value *recycled) {
+    JSON_Value *value = NULL;
     char *end;
     double number = 0;
     errno = 0;
     number = strtod(*string, &end);
     if (errno || !is_decimal(*string, end - *string)) {
+        json_value_free(recycled);
         return NULL;
     }
     *string = end;
-    return json_value_init_number(number);
+    value = json_value_recycle(recycled, JSONNumber);
+    if (value == NULL) {
+        return json_value_init_number(number);
+    }
+    value->value.number = number;
+    return value;
 }
 
 /*********************************************************************************************************
 ** 函数名称: parse_null_value
 ** 功能描述: 把“序列化”的 JSON null 类型变量解析并转换成与其对应的“树形结构”格式的 JSON_Value 数据
 ** 输     入: string - 需要解析的“序列化”的 JSON null 字符串
+**         : recycled - 可以重复使用的上一次解析的结果，可以为 NULL
 ** 输     出: JSON_Value - 转换后的“树形结构”格式的 JSON_Null 数据
 **         : NULL - 转换失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static JSON_Value * parse_null_value(const char **string) {
+static JSON_Value * parse_null_value(const char **string, JSON_Value *recycled) {
     size_t token_size = SIZEOF_TOKEN("null");
+    JSON_Value *value = NULL;
     if (strncmp("null", *string, token_size) == 0) {
         *string += token_size;
-        return json_value_init_null();
+        value = json_value_recycle(recycled, JSONNull);
+        return value != NULL ? value : json_value_init_null();
     }
+    json_value_free(recycled);
     return NULL;
 }
 
 /* Serialization */
-#define APPEND_STRING(str) do { written = append_string(buf, (str));\
-                                if (written < 0) { return -1; }\
-                                if (buf != NULL) { buf += written; }\
-                                written_total += written; } while(0)
-
-#define APPEND_INDENT(level) do { written = append_indent(buf, (level));\
-                                  if (written < 0) { return -1; }\
-                                  if (buf != NULL) { buf += written; }\
-                                  written_total += written; } while(0)
+#define OUTPUT_CHAR(out, c)       do { if ((out)->length < (out)->capacity) { (out)->data[(out)->length++] = (char)(c); }\
+                                       else { json_output_append_char((out), (char)(c)); } } while (0)
+#define OUTPUT_LITERAL(out, str)  json_output_append((out), (str), SIZEOF_TOKEN(str))
 
 /*********************************************************************************************************
-** 函数名称: json_serialize_to_buffer_r
-** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据并把转换后
-**         : 的结果存储到我们指定的缓存空间中
-** 输	 入: value - 需要转换的“树形结构” JSON 数据
-**         : buf - 用来存储转换后的、“序列化”格式的字符串缓冲区
-**         : level - 在“序列化”的字符串中，不同 JSON 对象之间需要添加的空格数量，单位是 4 个空格
-**         : is_pretty - 我们在“序列化”后的字符串中是否需要添加格式化空格来提高可阅读性
-**         : num_buf - 用来存储 JSONNumber 类型变量值的缓冲区
-** 输	 出: written_total - 我们序列化后的字符串长度，不包括字符串结尾'\0'字符
-**		   : -1 - 执行失败
+** 函数名称: json_output_init
+** 功能描述: 初始化一个序列化输出缓冲区
+** 注     释: buf 为 NULL 且 growable 为 0 时，这个输出缓冲区只统计写入的字节数，不保存任何数据，用来计算序列化
+**         : 所需要的空间大小；growable 为 1 时，缓冲区空间不足会通过 parson_malloc 自动扩展
+** 输	 入: out - 需要初始化的输出缓冲区
+**         : buf - 输出缓冲区起始地址
+**         : capacity - 输出缓冲区容量（不包括字符串结尾的 '\0' 字符）
+**         : growable - 输出缓冲区是否可以自动扩展
+** 输	 出: 
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static int json_serialize_to_buffer_r(const JSON_Value *value, char *buf, int level, int is_pretty, char *num_buf)
-{
-    const char *key = NULL, *string = NULL;
-    JSON_Value *temp_value = NULL;
-    JSON_Array *array = NULL;
-    JSON_Object *object = NULL;
-    size_t i = 0, count = 0;
-    double num = 0.0;
-    int written = -1, written_total = 0;
-
-    switch (json_value_get_type(value)) {
-        case JSONArray:
-            array = json_value_get_array(value);
-            count = json_array_get_count(array);
-            APPEND_STRING("[");
-            if (count > 0 && is_pretty) {
-                APPEND_STRING("\n");
-            }
-            for (i = 0; i < count; i++) {
-                if (is_pretty) {
-                    APPEND_INDENT(level+1);
-                }
-                temp_value = json_array_get_value(array, i);
-                written = json_serialize_to_buffer_r(temp_value, buf, level+1, is_pretty, num_buf);
-                if (written < 0) {
-                    return -1;
-                }
-                if (buf != NULL) {
-                    buf += written;
-                }
-                written_total += written;
-                if (i < (count - 1)) {
-                    APPEND_STRING(",");
-                }
-                if (is_pretty) {
-                    APPEND_STRING("\n");
-                }
-            }
-            if (count > 0 && is_pretty) {
-                APPEND_INDENT(level);
-            }
-            APPEND_STRING("]");
-            return written_total;
-        case JSONObject:
-            object = json_value_get_object(value);
-            count  = json_object_get_count(object);
-            APPEND_STRING("{");
-            if (count > 0 && is_pretty) {
-                APPEND_STRING("\n");
-            }
-            for (i = 0; i < count; i++) {
-                key = json_object_get_name(object, i);
-                if (key == NULL) {
-                    return -1;
-                }
-                if (is_pretty) {
-                    APPEND_INDENT(level+1);
-                }
-                written = json_serialize_string(key, buf);
-                if (written < 0) {
-                    return -1;
-                }
-                if (buf != NULL) {
-                    buf += written;
-                }
-                written_total += written;
-                APPEND_STRING(":");
-                if (is_pretty) {
-                    APPEND_STRING(" ");
-                }
-                temp_value = json_object_get_value(object, key);
-                written = json_serialize_to_buffer_r(temp_value, buf, level+1, is_pretty, num_buf);
-                if (written < 0) {
-                    return -1;
-                }
-                if (buf != NULL) {
-                    buf += written;
-                }
-                written_total += written;
-                if (i < (count - 1)) {
-                    APPEND_STRING(",");
-                }
-                if (is_pretty) {
-                    APPEND_STRING("\n");
-                }
-            }
-            if (count > 0 && is_pretty) {
-                APPEND_INDENT(level);
-            }
-            APPEND_STRING("}");
-            return written_total;
-        case JSONString:
-            string = json_value_get_string(value);
-            if (string == NULL) {
-                return -1;
-            }
-            written = json_serialize_string(string, buf);
-            if (written < 0) {
-                return -1;
-            }
-            if (buf != NULL) {
-                buf += written;
-            }
-            written_total += written;
-            return written_total;
-        case JSONBoolean:
-            if (json_value_get_boolean(value)) {
-                APPEND_STRING("true");
-            } else {
-                APPEND_STRING("false");
-            }
-            return written_total;
-        case JSONNumber:
-            num = json_value_get_number(value);
-            if (buf != NULL) {
-                num_buf = buf;
-            }
-            written = sprintf(num_buf, FLOAT_FORMAT, num);
-            if (written < 0) {
-                return -1;
-            }
-            if (buf != NULL) {
-                buf += written;
-            }
-            written_total += written;
-            return written_total;
-        case JSONNull:
-            APPEND_STRING("null");
-            return written_total;
-        case JSONError:
-            return -1;
-        default:
-            return -1;
-    }
+static void json_output_init(JSON_Output *out, char *buf, size_t capacity, int growable) {
+    out->data = buf;
+    out->length = 0;
+    out->capacity = capacity;
+    out->growable = growable;
+    out->failed = 0;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_serialize_string
-** 功能描述: 把指定的 JSON string 数据转换成与其对应的“序列化”格式的字符串数据并把转换后的结果存储到我们
-**         : 指定的缓存空间中（常常用于序列化“键值对”中的“键”描述符字段）
-** 输	 入: string - 我们需要序列化的 JSON string 字符串
-**         : buf - 存储序列化后结果的缓冲区起始地址
-** 输	 出: written_total - 一共向 buf 中写入数据的字节数
-**		   : -1 - 执行失败
+** 函数名称: json_output_grow
+** 功能描述: 确保输出缓冲区还可以再写入指定字节数的数据，如果空间不足并且缓冲区可以扩展，则按照容量加倍的
+**         : 策略重新分配缓冲区
+** 注     释: 缓冲区实际分配的空间总是比 capacity 多一个字节，用来存放字符串结尾的 '\0' 字符
+** 输	 入: out - 我们要操作的输出缓冲区
+**         : needed - 需要再写入的字节数
+** 输	 出: JSON_Status - 执行状态，失败时会设置 out->failed
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static int json_serialize_string(const char *string, char *buf) {
-    size_t i = 0, len = strlen(string);
-    char c = '\0';
-    int written = -1, written_total = 0;
-    APPEND_STRING("\"");
-    for (i = 0; i < len; i++) {
-        c = string[i];
-        switch (c) {
-            case '\"': APPEND_STRING("\\\""); break;
-            case '\\': APPEND_STRING("\\\\"); break;
-            case '\b': APPEND_STRING("\\b"); break;
-            case '\f': APPEND_STRING("\\f"); break;
-            case '\n': APPEND_STRING("\\n"); break;
-            case '\r': APPEND_STRING("\\r"); break;
-            case '\t': APPEND_STRING("\\t"); break;
-            case '\x00': APPEND_STRING("\\u0000"); break;
-            case '\x01': APPEND_STRING("\\u0001"); break;
-            case '\x02': APPEND_STRING("\\u0002"); break;
-            case '\x03': APPEND_STRING("\\u0003"); break;
-            case '\x04': APPEND_STRING("\\u0004"); break;
-            case '\x05': APPEND_STRING("\\u0005"); break;
-            case '\x06': APPEND_STRING("\\u0006"); break;
-            case '\x07': APPEND_STRING("\\u0007"); break;
-            /* '\x08' duplicate: '\b' */
-            /* '\x09' duplicate: '\t' */
-            /* '\x0a' duplicate: '\n' */
-            case '\x0b': APPEND_STRING("\\u000b"); break;
-            /* '\x0c' duplicate: '\f' */
-            /* '\x0d' duplicate: '\r' */
-            case '\x0e': APPEND_STRING("\\u000e"); break;
-            case '\x0f': APPEND_STRING("\\u000f"); break;
-            case '\x10': APPEND_STRING("\\u0010"); break;
-            case '\x11': APPEND_STRING("\\u0011"); break;
-            case '\x12': APPEND_STRING("\\u0012"); break;
-            case '\x13': APPEND_STRING("\\u0013"); break;
-            case '\x14': APPEND_STRING("\\u0014"); break;
-            case '\x15': APPEND_STRING("\\u0015"); break;
-            case '\x16': APPEND_STRING("\\u0016"); break;
-            case '\x17': APPEND_STRING("\\u0017"); break;
-            case '\x18': APPEND_STRING("\\u0018"); break;
-            case '\x19': APPEND_STRING("\\u0019"); break;
-            case '\x1a': APPEND_STRING("\\u001a"); break;
-            case '\x1b': APPEND_STRING("\\u001b"); break;
-            case '\x1c': APPEND_STRING("\\u001c"); break;
-            case '\x1d': APPEND_STRING("\\u001d"); break;
-            case '\x1e': APPEND_STRING("\\u001e"); break;
-            case '\x1f': APPEND_STRING("\\u001f"); break;
-            case '/':
-                if (parson_escape_slashes) {
-                    APPEND_STRING("\\/");  /* to make json embeddable in xml\/html */
-                } else {
-                    APPEND_STRING("/");
-                }
-                break;
-            default:
-                if (buf != NULL) {
-                    buf[0] = c;
-                    buf += 1;
-                }
-                written_total += 1;
-                break;
-        }
+static JSON_Status json_output_grow(JSON_Output *out, size_t needed) {
+    size_t new_capacity = 0;
+    char *new_data = NULL;
+    if (out->failed) {
+        return JSONFailure;
+    }
+    if (out->length + needed <= out->capacity) {
+        return JSONSuccess;
+    }
+    if (!out->growable) {
+        out->failed = 1;
+        return JSONFailure;
+    }
+    new_capacity = MAX(out->capacity * 2, out->length + needed);
+    new_capacity = MAX(new_capacity, OUTPUT_STARTING_CAPACITY);
+    new_data = (char*)parson_malloc(new_capacity + 1);
+    if (new_data == NULL) {
+        out->failed = 1;
+        return JSONFailure;
     }
-    APPEND_STRING("\"");
-    return written_total;
+    if (out->data != NULL && out->length > 0) {
+        memcpy(new_data, out->data, out->length);
+    }
+    parson_free(out->data);
+    out->data = new_data;
+    out->capacity = new_capacity;
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
-** 函数名称: append_indent
-** 功能描述: 向指定的缓冲区中追加指定个数的空格块，每个空格块包含 4 个空格字符
-** 输	 入: buf - 我们要追加空格块的缓冲区起始地址
-**         : level - 我们要追加的空格块个数
-** 输	 出: written_total - 一共向 buf 中写入数据的字节数
-**		   : -1 - 执行失败
+** 函数名称: json_output_append
+** 功能描述: 向输出缓冲区中追加指定长度的数据
+** 输	 入: out - 我们要操作的输出缓冲区
+**         : data - 需要追加的数据
+**         : len - 需要追加的数据长度
+** 输	 出: 
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static int append_indent(char *buf, int level) {
-    int i;
-    int written = -1, written_total = 0;
-    for (i = 0; i < level; i++) {
-        APPEND_STRING("    ");
+static void json_output_append(JSON_Output *out, const char *data, size_t len) {
+    if (out->data == NULL && !out->growable) {
+        out->length += len;
+        return;
     }
-    return written_total;
+    if (out->length + len > out->capacity && json_output_grow(out, len) == JSONFailure) {
+        return;
+    }
+    memcpy(out->data + out->length, data, len);
+    out->length += len;
 }
 
 /*********************************************************************************************************
-** 函数名称: append_string
-** 功能描述: 把指定的字符串追加到指定的缓冲区中
-** 输	 入: buf - 我们要追加字符串的缓冲区起始地址
-**         : string - 我们要向缓冲区中追加的字符串内容
-** 输	 出: written_total - 一共向 buf 中写入数据的字节数
-**		   : -1 - 执行失败
+** 函数名称: json_output_append_char
+** 功能描述: 向输出缓冲区中追加一个字符，这个函数是 OUTPUT_CHAR 在缓冲区空间不足时的处理路径
+** 输	 入: out - 我们要操作的输出缓冲区
+**         : c - 需要追加的字符
+** 输	 出: 
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-static int append_string(char *buf, const char *string) {
-    if (buf == NULL) {
-        return (int)strlen(string);
-    }
-    return sprintf(buf, "%s", string);
+static void json_output_append_char(JSON_Output *out, char c) {
+    json_output_append(out, &c, 1);
 }
 
-#undef APPEND_STRING
-#undef APPEND_INDENT
-
-/* Parser API */
 /*********************************************************************************************************
-** 函数名称: json_parse_file
-** 功能描述: 读取指定的 JSON 文件内容（序列化格式）并把读取到的“序列化”格式 JSON 数据解析并转换成“树形结构”
-**         : JSON 表示格式
-** 输	 入: filename - 存储“序列化”格式 JSON 数据的文件名
-** 输	 出: output_value - 解析转换后的“树形结构” JSON 数据
-**		   : NULL - 执行失败
+** 函数名称: json_output_finish
+** 功能描述: 在输出缓冲区的数据结尾添加字符串结尾 '\0' 字符
+** 输	 入: out - 我们要操作的输出缓冲区
+** 输	 出: JSON_Status - 序列化过程中是否发生过错误
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_parse_file(const char *filename) {
-    char *file_contents = read_file(filename);
-    JSON_Value *output_value = NULL;
-    if (file_contents == NULL) {
-        return NULL;
+static JSON_Status json_output_finish(JSON_Output *out) {
+    if (out->failed) {
+        return JSONFailure;
     }
-    output_value = json_parse_string(file_contents);
-    parson_free(file_contents);
-    return output_value;
+    if (out->data != NULL) {
+        out->data[out->length] = '\0';
+    }
+    return JSONSuccess;
 }
 
+
 /*********************************************************************************************************
-** 函数名称: json_parse_file_with_comments
-** 功能描述: 读取指定的 JSON 文件内容（序列化格式）并把读取到的“序列化”格式 JSON 数据解析并转换成“树形结构” 
-**         : JSON 表示格式
-** 注     释: 这个函数除了包含解析 JSON 字符串功能外，还包含去除 JSON 字符串中注释信息的功能逻辑，所以如果在
-**         : JSON 文件中不仅包含 JSON 原始数据，还包含了注释信息，那么我们就可以调用这个接口来解析
-** 输	 入: filename - 存储“序列化”格式 JSON 数据的文件名
-** 输	 出: output_value - 解析转换后的“树形结构” JSON 数据
-**		   : NULL - 执行失败
+** 函数名称: json_serializer_init
+** 功能描述: 根据指定的序列化选项初始化一个序列化上下文
+** 注     释: 格式化输出时会预先生成一个“换行符 + 缩进字符”的空白字符缓冲区，这样每一行的换行和缩进只需要一次
+**         : memcpy 就可以完成
+** 输	 入: ser - 需要初始化的序列化上下文
+**         : out - 序列化结果使用的输出缓冲区
+**         : options - 序列化选项，其中 pretty 为 NULL 时不添加格式化空白字符
+** 输	 出: JSON_Status - 执行状态，序列化选项不合法时返回 JSONFailure
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_parse_file_with_comments(const char *filename) {
-    char *file_contents = read_file(filename);
-    JSON_Value *output_value = NULL;
-    if (file_contents == NULL) {
-        return NULL;
+static JSON_Status json_serializer_init(JSON_Serializer *ser, JSON_Output *out, const JSON_Serialization_Options *options) {
+    const JSON_Pretty_Options *pretty = options->pretty;
+    ser->out = out;
+    ser->is_pretty = pretty != NULL;
+    ser->newline_len = 0;
+    ser->whitespace_len = 0;
+    ser->escape_slashes = options->escape_slashes;
+    ser->ascii_only = options->ascii_only;
+    ser->sort_keys = options->sort_keys;
+    ser->shortest_numbers = options->float_precision == 0;
+    ser->cache_key = CACHE_KEY_NONE;
+    if (options->canonical) { /* RFC 8785 */
+        pretty = NULL;
+        ser->is_pretty = 0;
+        ser->escape_slashes = 0;
+        ser->ascii_only = 0;
+        ser->sort_keys = 1;
+        ser->shortest_numbers = 1;
+    } else if (pretty == NULL && !options->ascii_only && options->float_precision == MAX_FLOAT_PRECISION) {
+        ser->cache_key = CACHE_KEY(options->escape_slashes);
+    }
+    if (options->float_precision < 0 || options->float_precision > MAX_FLOAT_PRECISION) {
+        return JSONFailure;
     }
-    output_value = json_parse_string_with_comments(file_contents);
-    parson_free(file_contents);
-    return output_value;
+    sprintf(ser->num_format, "%%1.%dg", options->float_precision);
+    json_pretty_options_init(&ser->pretty);
+    if (pretty == NULL) {
+        return JSONSuccess;
+    }
+    ser->pretty.indent_char = pretty->indent_char;
+    ser->pretty.indent_width = pretty->indent_width;
+    ser->pretty.scalars_per_line = pretty->scalars_per_line;
+    if (pretty->newline != NULL) {
+        ser->pretty.newline = pretty->newline;
+    }
+    if (pretty->name_separator != NULL) {
+        ser->pretty.name_separator = pretty->name_separator;
+    }
+    ser->newline_len = strlen(ser->pretty.newline);
+    if (ser->newline_len > MAX_NEWLINE_LENGTH) {
+        return JSONFailure;
+    }
+    memcpy(ser->whitespace, ser->pretty.newline, ser->newline_len);
+    memset(ser->whitespace + ser->newline_len, ser->pretty.indent_char, WHITESPACE_BUF_SIZE - ser->newline_len);
+    ser->whitespace_len = WHITESPACE_BUF_SIZE;
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_parse_string
-** 功能描述: 解析指定的 JSON 字符串数据（序列化格式）并转换成能表示 JSON 数据树形结构的表示形式
-** 输	 入: string - 序列化格式的 JSON 字符串数据
-** 输	 出: JSON_Value - 和序列化 JSON 字符串对应的 JSON 数据结构表示形式的数据
-**		   : NULL - 执行失败
+** 函数名称: json_serializer_newline
+** 功能描述: 向输出缓冲区中追加换行符以及指定嵌套层数对应的缩进字符
+** 注     释: 缩进不超过预先生成的空白字符缓冲区长度时，一次 memcpy 即可完成，否则按缓冲区长度分段追加
+** 输	 入: ser - 我们要操作的序列化上下文
+**         : level - 下一行数据在 JSON 数据中的嵌套层数
+** 输	 出: 
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_parse_string(const char *string) {
-    if (string == NULL) {
-        return NULL;
+static void json_serializer_newline(JSON_Serializer *ser, int level) {
+    size_t indent = ser->pretty.indent_width * (size_t)level;
+    size_t chunk = 0, max_chunk = ser->whitespace_len - ser->newline_len;
+    if (ser->newline_len + indent <= ser->whitespace_len) {
+        json_output_append(ser->out, ser->whitespace, ser->newline_len + indent);
+        return;
     }
-    if (string[0] == '\xEF' && string[1] == '\xBB' && string[2] == '\xBF') {
-        string = string + 3; /* Support for UTF-8 BOM */
+    json_output_append(ser->out, ser->whitespace, ser->newline_len);
+    while (indent > 0) {
+        chunk = indent < max_chunk ? indent : max_chunk;
+        json_output_append(ser->out, ser->whitespace + ser->newline_len, chunk);
+        indent -= chunk;
     }
-    return parse_value((const char**)&string, 0);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_parse_string_with_comments
-** 功能描述: 解析指定的 JSON 字符串数据（序列化格式）并转换成能表示 JSON 数据树形结构的表示形式
-** 注     释: 这个函数除了包含解析 JSON 字符串功能外，还包含去除 JSON 字符串中注释信息的功能逻辑，所以如果
-**         : 我们的 JSON 文件中不仅包含 JSON 原始数据，还包含了注释信息，那么我们就可以调用这个接口来解析
-** 输	 入: string - 序列化格式的 JSON 字符串数据
-** 输	 出: JSON_Value - 和序列化 JSON 字符串对应的 JSON 数据结构表示形式的数据
-**		   : NULL - 执行失败
+** 函数名称: json_serializer_store_cache
+** 功能描述: 在序列化完一个 JSON object 或者 JSON array 之后更新它的序列化信息缓存
+** 注     释: 打开了序列化结果缓存的容器在输出真实数据时同时保存序列化结果，只统计长度时原来保存的结果可能和
+**         : 新的缓存 key 不一致，所以直接释放
+** 输	 入: ser - 序列化上下文
+**         : cache - 刚刚序列化完的容器的序列化信息缓存
+**         : start - 容器序列化结果在输出缓冲区中的起始位置
+** 输	 出: 
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_parse_string_with_comments(const char *string) {
-    JSON_Value *result = NULL;
-    char *string_mutable_copy = NULL, *string_mutable_copy_ptr = NULL;
-    string_mutable_copy = parson_strdup(string);
-    if (string_mutable_copy == NULL) {
-        return NULL;
+static void json_serializer_store_cache(JSON_Serializer *ser, JSON_Serialization_Cache *cache, size_t start) {
+    JSON_Output *out = ser->out;
+    if (cache == NULL || out->failed) {
+        return;
+    }
+    cache->size = out->length - start;
+    cache->key = ser->cache_key;
+    if (!cache->fragment_enabled) {
+        return;
+    }
+    parson_free(cache->fragment);
+    cache->fragment = NULL;
+    if (out->data != NULL && !ser->sort_keys) {
+        cache->fragment = (char*)parson_malloc(cache->size > 0 ? cache->size : 1);
+        if (cache->fragment != NULL) {
+            memcpy(cache->fragment, out->data + start, cache->size);
+        }
     }
-    remove_comments(string_mutable_copy, "/*", "*/");
-    remove_comments(string_mutable_copy, "//", "\n");
-    string_mutable_copy_ptr = string_mutable_copy;
-    result = parse_value((const char**)&string_mutable_copy_ptr, 0);
-    parson_free(string_mutable_copy);
-    return result;
 }
 
-/* JSON Object API */
 /*********************************************************************************************************
-** 函数名称: json_object_get_value
-** 功能描述: 在指定的 JSON object 中，通过“键值对”中的“键”标识符获取与其对应的“值”标识符的内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “键值对”的“键”标识符
-** 输	 出: JSON_Value - 读取到的 JSON_Value 变量
-**		   : NULL - 执行失败
+** 函数名称: json_array_is_flat
+** 功能描述: 判断指定的 JSON array 中是否只包含标量（非 JSONObject 和 JSONArray 类型）成员
+** 输	 入: array - 我们要判断的 JSON array 对象
+** 输	 出: 1 - 只包含标量成员
+**         : 0 - 包含 JSONObject 或者 JSONArray 类型成员
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_object_get_value(const JSON_Object *object, const char *name) {
-    if (object == NULL || name == NULL) {
-        return NULL;
+static int json_array_is_flat(const JSON_Array *array) {
+    size_t i = 0;
+    JSON_Value_Type type = JSONError;
+    for (i = 0; i < json_array_get_count(array); i++) {
+        type = json_value_get_type(array->items[i]);
+        if (type == JSONObject || type == JSONArray) {
+            return 0;
+        }
     }
-    return json_object_getn_value(object, name, strlen(name));
+    return 1;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_get_string
-** 功能描述: 在指定的 JSON object 中，通过 JSONString 类型变量的“键值对”中的“键”标识符获取与其对应的“值”
-**         : 标识符的内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “键值对”的“键”标识符
-** 输	 出: string - 读取到的 JSONString 类型 string 变量值
-**		   : NULL - 读取失败
+** 函数名称: json_member_compare
+** 功能描述: qsort 使用的比较函数，按照“键”的 utf16 编码单元顺序（RFC 8785 规定的顺序）比较两个“键值对”
+** 注     释: 先按字节找到第一个不同的 utf8 字符，只有 U+E000 ~ U+FFFF 和大于 U+FFFF 的字符比较时，utf16 顺序
+**         : 才和字节顺序不同，所以只需要比较这两个字符的第一个 utf16 编码单元
+** 输	 入: a - 第一个“键值对”
+**         : b - 第二个“键值对”
+** 输	 出: int - 比较结果
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-const char * json_object_get_string(const JSON_Object *object, const char *name) {
-    return json_value_get_string(json_object_get_value(object, name));
+static int json_member_compare(const void *a, const void *b) {
+    const unsigned char *na = (const unsigned char*)((const JSON_Member*)a)->name;
+    const unsigned char *nb = (const unsigned char*)((const JSON_Member*)b)->name;
+    unsigned int ua = 0, ub = 0;
+    size_t i = 0;
+    while (na[i] == nb[i] && na[i] != '\0') {
+        i++;
+    }
+    if (na[i] == nb[i]) {
+        return 0;
+    }
+    while (i > 0 && IS_CONT(na[i])) {
+        i--;
+    }
+    ua = na[i] == '\0' ? 0 : utf8_decode_code_point(na + i);
+    ub = nb[i] == '\0' ? 0 : utf8_decode_code_point(nb + i);
+    if (ua > 0xFFFF && ub > 0xFFFF) {
+        return ua < ub ? -1 : 1;
+    }
+    ua = ua > 0xFFFF ? 0xD800 + ((ua - 0x10000) >> 10) : ua;
+    ub = ub > 0xFFFF ? 0xD800 + ((ub - 0x10000) >> 10) : ub;
+    return ua < ub ? -1 : 1;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_get_number
-** 功能描述: 在指定的 JSON object 中，通过 JSONNumber 类型变量的“键值对”中的“键”标识符获取与其对应的“值”
-**         : 标识符的内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “键值对”的“键”标识符
-** 输	 出: double - 读取到的 JSONNumber 类型 number 变量值
-**		   : 0 - 读取失败
+** 函数名称: json_object_get_sorted_order
+** 功能描述: 获取指定 JSON object 中所有“键值对”按照“键”排序后的索引数组
+** 注     释: 排序结果缓存在 JSON object 中，只有添加或者删除“键值对”时才需要重新排序
+** 输	 入: object - 我们要排序的 JSON object 对象
+** 输	 出: size_t * - 排序后的“键值对”索引数组，失败时返回 NULL
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-double json_object_get_number(const JSON_Object *object, const char *name) {
-    return json_value_get_number(json_object_get_value(object, name));
+static const size_t * json_object_get_sorted_order(JSON_Object *object) {
+    size_t i = 0, count = json_object_get_count(object);
+    JSON_Member *members = NULL;
+    if (object->sorted_order != NULL || IS_FROZEN(object->wrapping_value)) { /* computed by json_value_freeze */
+        return object->sorted_order;
+    }
+    members = (JSON_Member*)parson_malloc(count * sizeof(JSON_Member));
+    if (members == NULL) {
+        return NULL;
+    }
+    object->sorted_order = (size_t*)parson_malloc(count * sizeof(size_t));
+    if (object->sorted_order == NULL) {
+        parson_free(members);
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        members[i].name = object->names[i];
+        members[i].index = i;
+    }
+    qsort(members, count, sizeof(JSON_Member), json_member_compare);
+    for (i = 0; i < count; i++) {
+        object->sorted_order[i] = members[i].index;
+    }
+    parson_free(members);
+    return object->sorted_order;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_get_object
-** 功能描述: 在指定的 JSON object 中，通过 JSONObject 类型变量的“键值对”中的“键”标识符获取与其对应的“值”
-**         : 标识符的内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “键值对”的“键”标识符
-** 输	 出: JSON_Object - 读取到的 JSONObject 类型 object 变量值
-**		   : NULL - 读取失败
+** 函数名称: json_format_number_shortest
+** 功能描述: 把指定的数字转换成可以准确还原的最短字符串，格式与 ECMAScript 的 Number.prototype.toString 相同
+**         : （RFC 8785 规定的数字格式）
+** 注     释: 从小到大尝试有效数字位数，第一个可以准确还原的就是最短的。正规数（绝对值不小于 DBL_MIN）相邻
+**         : 两个数的间隔小于 15 位有效数字的间隔，最短表示不超过 15 位时 15 位精度的结果去掉末尾的 0 就是它，
+**         : 所以直接从 15 位开始，大多数数字只需要一次格式化和一次转换；非正规数的精度更低，%.15g 虽然可以还原
+**         : 但不是最短的（例如 5e-324），需要从 1 位开始尝试
+** 输	 入: num - 需要转换的数字
+**         : buf - 存储转换结果的缓冲区，至少 NUM_BUF_SIZE 字节
+** 输	 出: int - 转换结果的长度
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Object * json_object_get_object(const JSON_Object *object, const char *name) {
-    return json_value_get_object(json_object_get_value(object, name));
-}
-
-/*********************************************************************************************************
+static int json_format_number_shortest(double num, char *buf) {
+    char scientific[NUM_BUF_SIZE], digits[MAX_FLOAT_PRECISION + 1];
+    const char *ptr = scientific;
+    int precision = 0, count = 0, point = 0, exponent = 0, len = 0, i = 0;
+    if (num == 0.0) { /* also -0 */
+        buf[0] = '0';
+        buf[1] = '\0';
+        return 1;
+    }
+    precision = (num >= DBL_MIN || num <= -DBL_MIN) ? DBL_DIG : 1;
+    for (; ; precision++) {
+        sprintf(scientific, "%.*e", precision - 1, num);
+        if (precision == MAX_FLOAT_PRECISION || strtod(scientific, NULL) == num) {
+            break;
+        }
+    }
+    if (*ptr == '-') {
+        buf[len++] = '-';
+        ptr++;
+    }
+    for (; *ptr != 'e' && *ptr != 'E' && *ptr != '\0'; ptr++) {
+        if (isdigit((unsigned char)*ptr) && count < MAX_FLOAT_PRECISION) {
+            digits[count++] = *ptr;
+        }
+    }
+    while (count > 1 && digits[count - 1] == '0') {
+        count--;
+    }
+    point = (*ptr != '\0' ? atoi(ptr + 1) : 0) + 1; /* value is 0.digits * 10^point */
+    if (count <= point && point <= 21) {
+        for (i = 0; i < point; i++) {
+            buf[len++] = i < count ? digits[i] : '0';
+        }
+    } else if (0 < point && point <= 21) {
+        for (i = 0; i < count; i++) {
+            if (i == point) {
+                buf[len++] = '.';
+            }
+            buf[len++] = digits[i];
+        }
+    } else if (-6 < point && point <= 0) {
+        buf[len++] = '0';
+        buf[len++] = '.';
+        for (i = point; i < 0; i++) {
+            buf[len++] = '0';
+        }
+        for (i = 0; i < count; i++) {
+            buf[len++] = digits[i];
+        }
+    } else {
+        buf[len++] = digits[0];
+        if (count > 1) {
+            buf[len++] = '.';
+            for (i = 1; i < count; i++) {
+                buf[len++] = digits[i];
+            }
+        }
+        exponent = point - 1;
+        len += sprintf(buf + len, "e%c%d", exponent < 0 ? '-' : '+', exponent < 0 ? -exponent : exponent);
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_buffer_r
+** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据并把转换后
+**         : 的结果追加到序列化上下文的输出缓冲区中
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : ser - 序列化上下文，包含输出缓冲区和格式化选项
+**         : level - 当前 JSON 数据在整个 JSON 数据中的嵌套层数，用来计算格式化时的缩进长度
+** 输	 出: JSON_Status - 执行状态，输出缓冲区空间不足记录在 ser->out->failed 中
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status json_serialize_to_buffer_r(const JSON_Value *value, JSON_Serializer *ser, int level)
+{
+    const char *key = NULL, *string = NULL;
+    JSON_Value *temp_value = NULL;
+    JSON_Array *array = NULL;
+    JSON_Object *object = NULL;
+    JSON_Output *out = ser->out;
+    JSON_Serialization_Cache *cache = NULL;
+    const size_t *order = NULL;
+    size_t i = 0, index = 0, count = 0, per_line = 0, start = out->length;
+    double num = 0.0;
+    int written = -1;
+
+    if (ser->cache_key != CACHE_KEY_NONE) {
+        cache = json_value_get_cache(value);
+        if (cache != NULL && cache->key == ser->cache_key && CACHE_IS_TRUSTED(value)) {
+            if (out->data == NULL && !out->growable) { /* only counting */
+                out->length += cache->size;
+                return JSONSuccess;
+            } else if (cache->fragment != NULL && !ser->sort_keys) {
+                json_output_append(out, cache->fragment, cache->size);
+                return JSONSuccess;
+            }
+        }
+        if (cache != NULL && IS_FROZEN(value)) { /* frozen values may be read by several threads at once */
+            cache = NULL;
+        }
+    }
+    switch (json_value_get_type(value)) {
+        case JSONArray:
+            array = json_value_get_array(value);
+            count = json_array_get_count(array);
+            if (ser->is_pretty && ser->pretty.scalars_per_line > 0 && json_array_is_flat(array)) {
+                per_line = ser->pretty.scalars_per_line;
+            }
+            OUTPUT_CHAR(out, '[');
+            for (i = 0; i < count && !out->failed; i++) {
+                if (i > 0) {
+                    OUTPUT_CHAR(out, ',');
+                }
+                if (per_line > 0 && (count <= per_line || i % per_line != 0)) {
+                    if (i > 0) {
+                        OUTPUT_CHAR(out, ' ');
+                    }
+                } else if (ser->is_pretty) {
+                    json_serializer_newline(ser, level + 1);
+                }
+                temp_value = json_array_get_value(array, i);
+                if (json_serialize_to_buffer_r(temp_value, ser, level + 1) == JSONFailure) {
+                    return JSONFailure;
+                }
+            }
+            if (count > 0 && ser->is_pretty && (per_line == 0 || count > per_line)) {
+                json_serializer_newline(ser, level);
+            }
+            OUTPUT_CHAR(out, ']');
+            json_serializer_store_cache(ser, cache, start);
+            return JSONSuccess;
+        case JSONObject:
+            object = json_value_get_object(value);
+            count  = json_object_get_count(object);
+            if (ser->sort_keys && count > 1) {
+                order = json_object_get_sorted_order(object);
+                if (order == NULL) {
+                    return JSONFailure;
+                }
+            }
+            OUTPUT_CHAR(out, '{');
+            for (i = 0; i < count && !out->failed; i++) {
+                index = order != NULL ? order[i] : i;
+                key = json_object_get_name(object, index);
+                if (key == NULL) {
+                    return JSONFailure;
+                }
+                if (i > 0) {
+                    OUTPUT_CHAR(out, ',');
+                }
+                if (ser->is_pretty) {
+                    json_serializer_newline(ser, level + 1);
+                }
+                json_serialize_string(key, ser);
+                if (ser->is_pretty) {
+                    json_output_append(out, ser->pretty.name_separator, strlen(ser->pretty.name_separator));
+                } else {
+                    OUTPUT_CHAR(out, ':');
+                }
+                temp_value = json_object_get_value_at(object, index);
+                if (json_serialize_to_buffer_r(temp_value, ser, level + 1) == JSONFailure) {
+                    return JSONFailure;
+                }
+            }
+            if (count > 0 && ser->is_pretty) {
+                json_serializer_newline(ser, level);
+            }
+            OUTPUT_CHAR(out, '}');
+            json_serializer_store_cache(ser, cache, start);
+            return JSONSuccess;
+        case JSONString:
+            string = json_value_get_string(value);
+            if (string == NULL) {
+                return JSONFailure;
+            }
+            json_serialize_string(string, ser);
+            return JSONSuccess;
+        case JSONBoolean:
+            if (json_value_get_boolean(value)) {
+                OUTPUT_LITERAL(out, "true");
+            } else {
+                OUTPUT_LITERAL(out, "false");
+            }
+            return JSONSuccess;
+        case JSONNumber:
+            num = json_value_get_number(value);
+            if (ser->shortest_numbers) {
+                written = json_format_number_shortest(num, ser->num_buf);
+            } else {
+                written = sprintf(ser->num_buf, ser->num_format, num);
+            }
+            if (written < 0) {
+                return JSONFailure;
+            }
+            json_output_append(out, ser->num_buf, (size_t)written);
+            return JSONSuccess;
+        case JSONNull:
+            OUTPUT_LITERAL(out, "null");
+            return JSONSuccess;
+        case JSONError:
+            return JSONFailure;
+        default:
+            return JSONFailure;
+    }
+}
+
+/*********************************************************************************************************
+** 函数名称: json_string_clean_run
+** 功能描述: 计算指定字符串从起始位置开始，连续的、不需要转义的字符个数
+** 注     释: 先以 SWAR_CHUNK 字节为单位按机器字批量检测（两个机器字一组，64 位系统上即 16 字节），发现需要
+**         : 转义的字符后再逐字节定位，这样没有转义字符的连续数据可以直接通过 memcpy 整段复制
+** 输	 入: string - 需要检测的字符串
+**         : len - 字符串长度
+**         : escape_slashes - 是否需要转义 '/' 字符
+**         : ascii_only - 是否需要转义非 ASCII 字符
+** 输	 出: size_t - 不需要转义的连续字符个数
+** 全局变量: json_escape_table
+** 调用模块: 
+*********************************************************************************************************/
+static size_t json_string_clean_run(const char *string, size_t len, int escape_slashes, int ascii_only) {
+    size_t i = 0, w0 = 0, w1 = 0, mask = 0;
+    unsigned char c = 0;
+    while (i + SWAR_CHUNK <= len) {
+        memcpy(&w0, string + i, sizeof(size_t));
+        memcpy(&w1, string + i + sizeof(size_t), sizeof(size_t));
+        mask = SWAR_HAS_LESS(w0, 0x20) | SWAR_HAS_BYTE(w0, '\"') | SWAR_HAS_BYTE(w0, '\\') |
+               SWAR_HAS_LESS(w1, 0x20) | SWAR_HAS_BYTE(w1, '\"') | SWAR_HAS_BYTE(w1, '\\');
+        if (escape_slashes) {
+            mask |= SWAR_HAS_BYTE(w0, '/') | SWAR_HAS_BYTE(w1, '/');
+        }
+        if (ascii_only) {
+            mask |= (w0 | w1) & SWAR_HIGHS;
+        }
+        if (mask != 0) {
+            break;
+        }
+        i += SWAR_CHUNK;
+    }
+    for (; i < len; i++) {
+        c = (unsigned char)string[i];
+        if (json_escape_table[c] != '\0' && (c != '/' || escape_slashes)) {
+            break;
+        }
+        if (c >= 0x80 && ascii_only) {
+            break;
+        }
+    }
+    return i;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_utf8_escaped
+** 功能描述: 把指定字符串起始位置的一个 utf8 字符转换成 \uXXXX 格式（码点大于 0xFFFF 时为 utf16 代理对）
+**         : 并追加到序列化上下文的输出缓冲区中
+** 输	 入: string - utf8 字符起始地址
+**         : len - string 中剩余的字节数
+**         : ser - 序列化上下文
+** 输	 出: size_t - 处理的字节数
+** 全局变量: json_hex_digits
+** 调用模块: 
+*********************************************************************************************************/
+static size_t json_serialize_utf8_escaped(const char *string, size_t len, JSON_Serializer *ser) {
+    const unsigned char *s = (const unsigned char*)string;
+    unsigned int cp = 0, units[2];
+    size_t i = 0, n = (size_t)num_bytes_in_utf8_sequence(s[0]), units_count = 1;
+    char escape[6];
+    if (n < 2 || n > len) {
+        /* strings are validated when they are created, but never read past the end of one */
+        n = 1;
+        cp = s[0];
+    } else {
+        cp = s[0] & (0xFF >> (n + 1));
+        for (i = 1; i < n; i++) {
+            cp = (cp << 6) | (s[i] & 0x3F);
+        }
+    }
+    units[0] = cp;
+    if (cp > 0xFFFF) {
+        cp -= 0x10000;
+        units[0] = 0xD800 | (cp >> 10);
+        units[1] = 0xDC00 | (cp & 0x3FF);
+        units_count = 2;
+    }
+    escape[0] = '\\';
+    escape[1] = 'u';
+    for (i = 0; i < units_count; i++) {
+        escape[2] = json_hex_digits[(units[i] >> 12) & 0xF];
+        escape[3] = json_hex_digits[(units[i] >> 8) & 0xF];
+        escape[4] = json_hex_digits[(units[i] >> 4) & 0xF];
+        escape[5] = json_hex_digits[units[i] & 0xF];
+        json_output_append(ser->out, escape, 6);
+    }
+    return n;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_string
+** 功能描述: 把指定的 JSON string 数据转换成与其对应的“序列化”格式的字符串数据并把转换后的结果追加到序列
+**         : 化上下文的输出缓冲区中（常常用于序列化“键值对”中的“键”描述符字段）
+** 注     释: 不需要转义的连续字符整段复制，需要转义的字符根据 json_escape_table 生成转义序列
+** 输	 入: string - 我们需要序列化的 JSON string 字符串
+**         : ser - 序列化上下文，包含输出缓冲区和转义选项
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void json_serialize_string(const char *string, JSON_Serializer *ser) {
+    JSON_Output *out = ser->out;
+    size_t i = 0, run = 0, len = strlen(string);
+    unsigned char c = 0;
+    char escape[6];
+    OUTPUT_CHAR(out, '\"');
+    while (i < len) {
+        run = json_string_clean_run(string + i, len - i, ser->escape_slashes, ser->ascii_only);
+        if (run > 0) {
+            json_output_append(out, string + i, run);
+            i += run;
+            if (i >= len) {
+                break;
+            }
+        }
+        c = (unsigned char)string[i];
+        if (c >= 0x80) {
+            i += json_serialize_utf8_escaped(string + i, len - i, ser);
+            continue;
+        }
+        escape[0] = '\\';
+        escape[1] = json_escape_table[c];
+        if (escape[1] == 'u') {
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = json_hex_digits[c >> 4];
+            escape[5] = json_hex_digits[c & 0xF];
+            json_output_append(out, escape, 6);
+        } else {
+            json_output_append(out, escape, 2);
+        }
+        i++;
+    }
+    OUTPUT_CHAR(out, '\"');
+}
+
+#undef OUTPUT_CHAR
+#undef OUTPUT_LITERAL
+
+/* Binary formats */
+/*********************************************************************************************************
+** 函数名称: binary_writer_init
+** 功能描述: 初始化一个二进制编码器
+** 输	 入: writer - 需要初始化的二进制编码器
+**         : out - 编码到内存时使用的输出缓冲区，流式编码时为 NULL
+**         : write_fun - 流式编码时使用的写函数
+**         : context - 传递给写函数的参数
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void binary_writer_init(JSON_Binary_Writer *writer, JSON_Output *out, JSON_Write_Function write_fun, void *context) {
+    writer->out = out;
+    writer->write_fun = write_fun;
+    writer->context = context;
+    writer->used = 0;
+    writer->position = 0;
+    writer->failed = 0;
+}
+
+/*********************************************************************************************************
+** 函数名称: binary_write
+** 功能描述: 向指定的二进制编码器中写入指定长度的数据
+** 注     释: 编码到内存时直接追加到输出缓冲区中，流式编码时先缓存到编码器的缓冲区中，缓冲区满了之后再通过
+**         : 用户指定的写函数批量写出
+** 输	 入: writer - 我们要操作的二进制编码器
+**         : data - 需要写入的数据
+**         : len - 需要写入的数据长度
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void binary_write(JSON_Binary_Writer *writer, const void *data, size_t len) {
+    if (writer->failed) {
+        return;
+    }
+    writer->position += len;
+    if (writer->out != NULL) {
+        json_output_append(writer->out, (const char*)data, len);
+        writer->failed = writer->out->failed;
+        return;
+    }
+    if (writer->used + len > BINARY_BUF_SIZE && binary_flush(writer) == JSONFailure) {
+        return;
+    }
+    if (len >= BINARY_BUF_SIZE) {
+        if (writer->write_fun(writer->context, data, len) == JSONFailure) {
+            writer->failed = 1;
+        }
+        return;
+    }
+    memcpy(writer->buf + writer->used, data, len);
+    writer->used += len;
+}
+
+/*********************************************************************************************************
+** 函数名称: binary_flush
+** 功能描述: 把指定的流式 二进制编码器中缓存的数据通过用户指定的写函数写出
+** 输	 入: writer - 我们要操作的二进制编码器
+** 输	 出: JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status binary_flush(JSON_Binary_Writer *writer) {
+    if (writer->failed) {
+        return JSONFailure;
+    }
+    if (writer->out == NULL && writer->used > 0) {
+        if (writer->write_fun(writer->context, writer->buf, writer->used) == JSONFailure) {
+            writer->failed = 1;
+            return JSONFailure;
+        }
+        writer->used = 0;
+    }
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: cbor_write_head
+** 功能描述: 向指定的二进制编码器中写入一个数据项的头部（major type 和参数），参数使用最短的编码长度
+** 注     释: C89 没有 64 位整数类型，所以 64 位的参数分成高 32 位和低 32 位两部分传入
+** 输	 入: writer - 我们要操作的二进制编码器
+**         : major - 数据项的 major type
+**         : hi - 参数的高 32 位
+**         : lo - 参数的低 32 位
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void cbor_write_head(JSON_Binary_Writer *writer, int major, unsigned long hi, unsigned long lo) {
+    unsigned char head[9];
+    size_t len = 0;
+    int i = 0;
+    head[0] = (unsigned char)(major << 5);
+    if (hi == 0 && lo < 24) {
+        head[0] |= (unsigned char)lo;
+        len = 1;
+    } else if (hi == 0 && lo <= 0xFF) {
+        head[0] |= 24;
+        head[1] = (unsigned char)lo;
+        len = 2;
+    } else if (hi == 0 && lo <= 0xFFFF) {
+        head[0] |= 25;
+        head[1] = (unsigned char)(lo >> 8);
+        head[2] = (unsigned char)lo;
+        len = 3;
+    } else if (hi == 0) {
+        head[0] |= 26;
+        for (i = 0; i < 4; i++) {
+            head[1 + i] = (unsigned char)(lo >> (24 - 8 * i));
+        }
+        len = 5;
+    } else {
+        head[0] |= 27;
+        for (i = 0; i < 4; i++) {
+            head[1 + i] = (unsigned char)(hi >> (24 - 8 * i));
+            head[5 + i] = (unsigned char)(lo >> (24 - 8 * i));
+        }
+        len = 9;
+    }
+    binary_write(writer, head, len);
+}
+
+/*********************************************************************************************************
+** 函数名称: cbor_write_size
+** 功能描述: 向指定的二进制编码器中写入一个以 size_t 类型长度（或成员个数）作为参数的数据项头部
+** 输	 入: writer - 我们要操作的二进制编码器
+**         : major - 数据项的 major type
+**         : size - 数据长度或者成员个数
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void cbor_write_size(JSON_Binary_Writer *writer, int major, size_t size) {
+    /* shifting twice by 16 is defined even when size_t has only 32 bits */
+    cbor_write_head(writer, major, (unsigned long)((size >> 16) >> 16), (unsigned long)(size & 0xFFFFFFFFUL));
+}
+
+/*********************************************************************************************************
+** 函数名称: cbor_write_number
+** 功能描述: 向指定的二进制编码器中写入一个数字，整数使用 CBOR 整数编码，可以用单精度浮点数准确表示的数字使
+**         : 用单精度浮点数编码，其余的数字使用双精度浮点数编码
+** 注     释: 浮点数按照大端字节序写入，假设浮点数使用 IEEE 754 格式
+** 输	 入: writer - 我们要操作的二进制编码器
+**         : num - 需要写入的数字
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void cbor_write_number(JSON_Binary_Writer *writer, double num) {
+    unsigned char bytes[9], native[8];
+    double magnitude = 0.0, low = 0.0;
+    unsigned long hi = 0;
+    float single = 0.0f;
+    const double one = 1.0;
+    int little_endian = 0, i = 0;
+    memcpy(native, &one, sizeof(double));
+    little_endian = native[7] == 0x3F;
+    memcpy(native, &num, sizeof(double));
+    magnitude = num < 0 ? -1.0 - num : num; /* CBOR stores negative n as -1 - n */
+    if (magnitude >= 0.0 && magnitude < CBOR_INTEGER_LIMIT && (num >= 0 || -1.0 - magnitude == num) &&
+        !(num == 0.0 && (native[little_endian ? 7 : 0] & 0x80))) { /* -0 is written as a float */
+        hi = (unsigned long)(magnitude / 4294967296.0);
+        low = magnitude - (double)hi * 4294967296.0; /* exact, both halves fit in a double */
+        if (low == (double)(unsigned long)low) {
+            cbor_write_head(writer, num < 0 ? CBOR_NEGATIVE : CBOR_UNSIGNED, hi, (unsigned long)low);
+            return;
+        }
+    }
+    if (fabs(num) <= FLT_MAX && (double)(single = (float)num) == num) {
+        bytes[0] = CBOR_FLOAT;
+        memcpy(native, &single, sizeof(float));
+        for (i = 0; i < 4; i++) {
+            bytes[1 + i] = native[little_endian ? 3 - i : i];
+        }
+        binary_write(writer, bytes, 5);
+        return;
+    }
+    bytes[0] = CBOR_DOUBLE;
+    for (i = 0; i < 8; i++) {
+        bytes[1 + i] = native[little_endian ? 7 - i : i];
+    }
+    binary_write(writer, bytes, 9);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_write_cbor_r
+** 功能描述: 把指定的“树形结构” JSON 数据编码成 CBOR 格式并写入指定的二进制编码器中
+** 注     释: JSON array 和 JSON object 使用确定长度编码，解码时可以预先分配成员空间
+** 输	 入: value - 需要编码的“树形结构” JSON 数据
+**         : writer - 我们要操作的二进制编码器
+** 输	 出: JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status json_value_write_cbor_r(const JSON_Value *value, JSON_Binary_Writer *writer) {
+    const char *string = NULL;
+    JSON_Array *array = NULL;
+    JSON_Object *object = NULL;
+    unsigned char simple = 0;
+    size_t i = 0, count = 0, len = 0;
+    switch (json_value_get_type(value)) {
+        case JSONArray:
+            array = json_value_get_array(value);
+            count = json_array_get_count(array);
+            cbor_write_size(writer, CBOR_ARRAY, count);
+            for (i = 0; i < count && !writer->failed; i++) {
+                if (json_value_write_cbor_r(array->items[i], writer) == JSONFailure) {
+                    return JSONFailure;
+                }
+            }
+            break;
+        case JSONObject:
+            object = json_value_get_object(value);
+            count = json_object_get_count(object);
+            cbor_write_size(writer, CBOR_MAP, count);
+            for (i = 0; i < count && !writer->failed; i++) {
+                len = strlen(object->names[i]);
+                cbor_write_size(writer, CBOR_TEXT, len);
+                binary_write(writer, object->names[i], len);
+                if (json_value_write_cbor_r(object->values[i], writer) == JSONFailure) {
+                    return JSONFailure;
+                }
+            }
+            break;
+        case JSONString:
+            string = json_value_get_string(value);
+            if (string == NULL) {
+                return JSONFailure;
+            }
+            len = strlen(string);
+            cbor_write_size(writer, CBOR_TEXT, len);
+            binary_write(writer, string, len);
+            break;
+        case JSONNumber:
+            cbor_write_number(writer, json_value_get_number(value));
+            break;
+        case JSONBoolean:
+            simple = json_value_get_boolean(value) ? CBOR_TRUE : CBOR_FALSE;
+            binary_write(writer, &simple, 1);
+            break;
+        case JSONNull:
+            simple = CBOR_NULL;
+            binary_write(writer, &simple, 1);
+            break;
+        default:
+            return JSONFailure;
+    }
+    return writer->failed ? JSONFailure : JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: cbor_read
+** 功能描述: 从指定的 CBOR 解码器中读取指定长度的数据
+** 输	 入: reader - 我们要操作的 CBOR 解码器
+**         : data - 存储读取到的数据的缓冲区
+**         : len - 需要读取的数据长度
+** 输	 出: JSON_Status - 执行状态，数据不足时返回 JSONFailure
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status cbor_read(JSON_Cbor_Reader *reader, void *data, size_t len) {
+    if (reader->data == NULL) {
+        return reader->read_fun(reader->context, data, len);
+    }
+    if (len > reader->remaining) {
+        return JSONFailure;
+    }
+    memcpy(data, reader->data, len);
+    reader->data += len;
+    reader->remaining -= len;
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: cbor_read_argument
+** 功能描述: 根据 CBOR 数据项头部的附加信息读取数据项的参数
+** 注     释: 不支持不确定长度编码（附加信息 31）
+** 输	 入: reader - 我们要操作的 CBOR 解码器
+**         : info - 数据项头部的附加信息（低 5 位）
+** 输	 出: hi - 参数的高 32 位
+**         : lo - 参数的低 32 位
+**         : JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status cbor_read_argument(JSON_Cbor_Reader *reader, int info, unsigned long *hi, unsigned long *lo) {
+    unsigned char bytes[8];
+    size_t len = 0, i = 0;
+    *hi = 0;
+    *lo = 0;
+    if (info < 24) {
+        *lo = (unsigned long)info;
+        return JSONSuccess;
+    }
+    if (info > 27) {
+        return JSONFailure;
+    }
+    len = (size_t)1 << (info - 24);
+    if (cbor_read(reader, bytes, len) == JSONFailure) {
+        return JSONFailure;
+    }
+    for (i = 0; i < len; i++) {
+        if (len == 8 && i < 4) {
+            *hi = (*hi << 8) | bytes[i];
+        } else {
+            *lo = (*lo << 8) | bytes[i];
+        }
+    }
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: cbor_read_size
+** 功能描述: 根据 CBOR 数据项头部的附加信息读取以 size_t 类型表示的长度（或成员个数）
+** 输	 入: reader - 我们要操作的 CBOR 解码器
+**         : info - 数据项头部的附加信息（低 5 位）
+** 输	 出: size - 读取到的长度
+**         : JSON_Status - 执行状态，长度超出 size_t 表示范围时返回 JSONFailure
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status cbor_read_size(JSON_Cbor_Reader *reader, int info, size_t *size) {
+    unsigned long hi = 0, lo = 0;
+    if (cbor_read_argument(reader, info, &hi, &lo) == JSONFailure) {
+        return JSONFailure;
+    }
+    *size = ((((size_t)hi) << 16) << 16) | (size_t)lo;
+    if ((((*size) >> 16) >> 16) != hi || *size == (size_t)-1) {
+        return JSONFailure;
+    }
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: cbor_read_text
+** 功能描述: 从指定的 CBOR 解码器中读取一个指定长度的 utf8 字符串，并返回以 '\0' 结尾的字符串
+** 注     释: 字符串中不能包含 '\0' 字符，并且必须是合法的 utf8 编码
+** 输	 入: reader - 我们要操作的 CBOR 解码器
+**         : len - 字符串长度
+**         : buf - 长度小于 buf_size 时使用的缓冲区，为 NULL 时总是动态分配
+**         : buf_size - buf 缓冲区大小
+** 输	 出: char * - 读取到的字符串，不是 buf 时需要调用者通过 parson_free 释放，失败时返回 NULL
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static char * cbor_read_text(JSON_Cbor_Reader *reader, size_t len, char *buf, size_t buf_size) {
+    char *text = buf;
+    if (reader->data != NULL && len > reader->remaining) {
+        return NULL;
+    }
+    if (text == NULL || len >= buf_size) {
+        text = (char*)parson_pool_alloc(len + 1);
+        if (text == NULL) {
+            return NULL;
+        }
+    }
+    text[len] = '\0'; /* is_valid_utf8 stops truncated sequences at the terminator */
+    if (cbor_read(reader, text, len) == JSONFailure ||
+        memchr(text, '\0', len) != NULL || !is_valid_utf8(text, len)) {
+        if (text != buf) {
+            parson_pool_free(text, len + 1);
+        }
+        return NULL;
+    }
+    return text;
+}
+
+/*********************************************************************************************************
+** 函数名称: cbor_read_float
+** 功能描述: 从指定的 CBOR 解码器中读取一个大端字节序的半精度、单精度或者双精度浮点数
+** 输	 入: reader - 我们要操作的 CBOR 解码器
+**         : len - 浮点数的字节数（2、4 或者 8）
+** 输	 出: num - 读取到的浮点数
+**         : JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status cbor_read_float(JSON_Cbor_Reader *reader, size_t len, double *num) {
+    unsigned char bytes[8], native[8];
+    const double one = 1.0;
+    float single = 0.0f;
+    int little_endian = 0, exponent = 0, i = 0;
+    unsigned int mantissa = 0;
+    if (cbor_read(reader, bytes, len) == JSONFailure) {
+        return JSONFailure;
+    }
+    memcpy(native, &one, sizeof(double));
+    little_endian = native[7] == 0x3F;
+    if (len == 2) {
+        exponent = (bytes[0] >> 2) & 0x1F;
+        mantissa = ((bytes[0] & 0x3u) << 8) | bytes[1];
+        if (exponent == 0x1F) {
+            return JSONFailure; /* infinity and NaN are not valid JSON numbers */
+        }
+        if (exponent == 0) {
+            *num = (double)mantissa / 16777216.0; /* subnormal, mantissa * 2^-24 */
+        } else {
+            *num = (double)(mantissa + 1024) / 33554432.0; /* (1024 + mantissa) * 2^(exponent - 25) */
+            for (i = 0; i < exponent; i++) {
+                *num *= 2.0;
+            }
+        }
+        if (bytes[0] & 0x80) {
+            *num = -*num;
+        }
+        return JSONSuccess;
+    }
+    for (i = 0; i < (int)len; i++) {
+        native[i] = bytes[little_endian ? (int)len - 1 - i : i];
+    }
+    if (len == 4) {
+        memcpy(&single, native, sizeof(float));
+        *num = single;
+    } else {
+        memcpy(num, native, sizeof(double));
+    }
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_read_cbor_r
+** 功能描述: 从指定的 CBOR 解码器中读取一个 CBOR 数据项，并转换成与其对应的“树形结构” JSON 数据
+** 注     释: 数组和 map 根据成员个数预先分配空间，为了避免不可信的成员个数导致分配过多内存，从内存解码时成员
+**         : 个数不能超过剩余数据长度，流式解码时最多预先分配 CBOR_MAX_PRESIZE 个成员
+**         : 忽略 tag，不支持 byte string、不确定长度编码以及除 false、true、null 以外的简单值
+** 输	 入: reader - 我们要操作的 CBOR 解码器
+**         : nesting - 当前数据项在整个 JSON 数据中的嵌套层数
+** 输	 出: JSON_Value - 转换后的“树形结构” JSON 数据
+**         : NULL - 转换失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Value * json_value_read_cbor_r(JSON_Cbor_Reader *reader, size_t nesting) {
+    unsigned char head = 0;
+    unsigned long hi = 0, lo = 0;
+    int major = 0, info = 0;
+    size_t i = 0, count = 0, len = 0, presize = 0;
+    char key_buf[CBOR_KEY_BUF_SIZE], *key = NULL, *string = NULL;
+    double num = 0.0;
+    JSON_Value *output_value = NULL, *item = NULL;
+    if (nesting > MAX_NESTING) {
+        return NULL;
+    }
+    for (;;) {
+        if (cbor_read(reader, &head, 1) == JSONFailure) {
+            return NULL;
+        }
+        major = head >> 5;
+        info = head & 0x1F;
+        if (major != CBOR_TAG) {
+            break;
+        }
+        if (cbor_read_argument(reader, info, &hi, &lo) == JSONFailure) { /* tags are skipped */
+            return NULL;
+        }
+    }
+    switch (major) {
+        case CBOR_UNSIGNED:
+        case CBOR_NEGATIVE:
+            if (cbor_read_argument(reader, info, &hi, &lo) == JSONFailure) {
+                return NULL;
+            }
+            num = (double)hi * 4294967296.0 + (double)lo;
+            return json_value_init_number(major == CBOR_NEGATIVE ? -1.0 - num : num);
+        case CBOR_TEXT:
+            if (cbor_read_size(reader, info, &len) == JSONFailure) {
+                return NULL;
+            }
+            string = cbor_read_text(reader, len, NULL, 0);
+            if (string == NULL) {
+                return NULL;
+            }
+            output_value = json_value_init_string_no_copy(string);
+            if (output_value == NULL) {
+                parson_free_string(string);
+            }
+            return output_value;
+        case CBOR_ARRAY:
+            if (cbor_read_size(reader, info, &count) == JSONFailure) {
+                return NULL;
+            }
+            output_value = json_value_init_array();
+            if (output_value == NULL) {
+                return NULL;
+            }
+            presize = reader->data != NULL ? MIN(count, reader->remaining) : MIN(count, CBOR_MAX_PRESIZE);
+            if (presize > 0 && json_array_resize(json_value_get_array(output_value), presize) == JSONFailure) {
+                json_value_free(output_value);
+                return NULL;
+            }
+            for (i = 0; i < count; i++) {
+                item = json_value_read_cbor_r(reader, nesting + 1);
+                if (item == NULL) {
+                    json_value_free(output_value);
+                    return NULL;
+                }
+                if (json_array_add(json_value_get_array(output_value), item) == JSONFailure) {
+                    json_value_free(item);
+                    json_value_free(output_value);
+                    return NULL;
+                }
+            }
+            return output_value;
+        case CBOR_MAP:
+            if (cbor_read_size(reader, info, &count) == JSONFailure) {
+                return NULL;
+            }
+            output_value = json_value_init_object();
+            if (output_value == NULL) {
+                return NULL;
+            }
+            presize = reader->data != NULL ? MIN(count, reader->remaining / 2) : MIN(count, CBOR_MAX_PRESIZE);
+            if (presize > 0 && json_object_resize(json_value_get_object(output_value), presize) == JSONFailure) {
+                json_value_free(output_value);
+                return NULL;
+            }
+            for (i = 0; i < count; i++) {
+                if (cbor_read(reader, &head, 1) == JSONFailure || (head >> 5) != CBOR_TEXT ||
+                    cbor_read_size(reader, head & 0x1F, &len) == JSONFailure ||
+                    (key = cbor_read_text(reader, len, key_buf, sizeof(key_buf))) == NULL) {
+                    json_value_free(output_value);
+                    return NULL;
+                }
+                item = json_value_read_cbor_r(reader, nesting + 1);
+                if (item == NULL ||
+                    json_object_addn(json_value_get_object(output_value), key, len, item) == JSONFailure) {
+                    if (key != key_buf) {
+                        parson_pool_free(key, len + 1);
+                    }
+                    json_value_free(item);
+                    json_value_free(output_value);
+                    return NULL;
+                }
+                if (key != key_buf) {
+                    parson_pool_free(key, len + 1);
+                }
+            }
+            return output_value;
+        case CBOR_SIMPLE:
+            switch (head) {
+                case CBOR_FALSE:
+                    return json_value_init_boolean(0);
+                case CBOR_TRUE:
+                    return json_value_init_boolean(1);
+                case CBOR_NULL:
+                    return json_value_init_null();
+                case CBOR_HALF:
+                case CBOR_FLOAT:
+                case CBOR_DOUBLE:
+                    if (cbor_read_float(reader, (size_t)1 << (info - 24), &num) == JSONFailure) {
+                        return NULL;
+                    }
+                    return json_value_init_number(num);
+                default:
+                    return NULL;
+            }
+        default:
+            return NULL;
+    }
+}
+
+/* Snapshot */
+/*********************************************************************************************************
+** 函数名称: snapshot_put_u32
+** 功能描述: 把指定的整数以 4 字节小端格式存储到指定的缓冲区中
+** 输	 入: dst - 存储整数的缓冲区
+**         : value - 需要存储的整数，只存储低 32 位
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void snapshot_put_u32(unsigned char *dst, size_t value) {
+    dst[0] = (unsigned char)(value & 0xFF);
+    dst[1] = (unsigned char)((value >> 8) & 0xFF);
+    dst[2] = (unsigned char)((value >> 16) & 0xFF);
+    dst[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+/*********************************************************************************************************
+** 函数名称: snapshot_get_u32
+** 功能描述: 从指定的缓冲区中读取一个 4 字节小端格式的整数
+** 输	 入: src - 存储整数的缓冲区
+** 输	 出: size_t - 读取到的整数
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static size_t snapshot_get_u32(const unsigned char *src) {
+    return (size_t)src[0] | ((size_t)src[1] << 8) | ((size_t)src[2] << 16) | ((size_t)src[3] << 24);
+}
+
+/*********************************************************************************************************
+** 函数名称: snapshot_hash
+** 功能描述: 计算指定字符串的 32 位 FNV-1a 散列值，快照镜像中的 JSON object 散列表使用这个散列值
+** 输	 入: string - 需要计算散列值的字符串
+**         : len - 字符串长度
+** 输	 出: size_t - 计算出的散列值
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static size_t snapshot_hash(const char *string, size_t len) {
+    size_t hash = 2166136261UL, i = 0;
+    for (i = 0; i < len; i++) {
+        hash = ((hash ^ (unsigned char)string[i]) * 16777619UL) & 0xFFFFFFFFUL;
+    }
+    return hash;
+}
+
+/*********************************************************************************************************
+** 函数名称: snapshot_write_u32
+** 功能描述: 向指定的快照编码器中写入一个 4 字节小端格式的整数
+** 输	 入: sw - 我们要操作的快照编码器
+**         : value - 需要写入的整数
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void snapshot_write_u32(JSON_Snapshot_Writer *sw, size_t value) {
+    unsigned char bytes[4];
+    snapshot_put_u32(bytes, value);
+    binary_write(sw->writer, bytes, 4);
+}
+
+/*********************************************************************************************************
+** 函数名称: snapshot_write_string
+** 功能描述: 向指定的快照编码器中写入一个字符串节点，内容相同的字符串只写入一次
+** 注     释: 字符串节点的格式为：类型、长度、字符串数据和 '\0'，然后填充到 4 字节对齐
+** 输	 入: sw - 我们要操作的快照编码器
+**         : string - 需要写入的字符串
+** 输	 出: position - 字符串节点在镜像中的位置
+**         : JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status snapshot_write_string(JSON_Snapshot_Writer *sw, const char *string, size_t *position) {
+    const unsigned char padding[4] = { 0, 0, 0, 0 };
+    size_t len = strlen(string), mask = 0, i = 0, new_capacity = 0;
+    const char **new_strings = NULL;
+    size_t *new_positions = NULL;
+    if (sw->count * 2 >= sw->capacity) {
+        new_capacity = sw->capacity * 2;
+        new_strings = (const char**)parson_malloc(new_capacity * sizeof(char*));
+        new_positions = (size_t*)parson_malloc(new_capacity * sizeof(size_t));
+        if (new_strings == NULL || new_positions == NULL) {
+            parson_free((void*)new_strings);
+            parson_free(new_positions);
+            return JSONFailure;
+        }
+        memset((void*)new_strings, 0, new_capacity * sizeof(char*));
+        for (i = 0; i < sw->capacity; i++) {
+            if (sw->strings[i] != NULL) {
+                mask = snapshot_hash(sw->strings[i], strlen(sw->strings[i])) & (new_capacity - 1);
+                while (new_strings[mask] != NULL) {
+                    mask = (mask + 1) & (new_capacity - 1);
+                }
+                new_strings[mask] = sw->strings[i];
+                new_positions[mask] = sw->positions[i];
+            }
+        }
+        parson_free((void*)sw->strings);
+        parson_free(sw->positions);
+        sw->strings = new_strings;
+        sw->positions = new_positions;
+        sw->capacity = new_capacity;
+    }
+    mask = snapshot_hash(string, len) & (sw->capacity - 1);
+    while (sw->strings[mask] != NULL) {
+        if (strcmp(sw->strings[mask], string) == 0) {
+            *position = sw->positions[mask];
+            return JSONSuccess;
+        }
+        mask = (mask + 1) & (sw->capacity - 1);
+    }
+    *position = sw->writer->position;
+    snapshot_write_u32(sw, JSONString);
+    snapshot_write_u32(sw, len);
+    binary_write(sw->writer, string, len + 1);
+    binary_write(sw->writer, padding, (4 - (len + 1) % 4) % 4);
+    sw->strings[mask] = string;
+    sw->positions[mask] = *position;
+    sw->count++;
+    return sw->writer->failed ? JSONFailure : JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_write_snapshot_r
+** 功能描述: 把指定的“树形结构” JSON 数据写入快照编码器中，子节点先于父节点写入
+** 注     释: 父节点通过 32 位的“父节点位置 - 子节点位置”引用子节点，所以镜像可以被加载到任意地址
+**         : JSON object 节点的格式为：类型、成员个数、散列表大小、（“键”，值）引用数组，然后是散列表，
+**         : 散列表中存储成员序号 + 1，0 表示空位，成员个数不超过 SNAPSHOT_SCAN_LIMIT 时没有散列表
+** 输	 入: sw - 我们要操作的快照编码器
+**         : value - 需要写入的“树形结构” JSON 数据
+** 输	 出: position - 节点在镜像中的位置
+**         : JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status json_value_write_snapshot_r(JSON_Snapshot_Writer *sw, const JSON_Value *value, size_t *position) {
+    unsigned char number[8], native[8];
+    const double one = 1.0;
+    double num = 0.0;
+    JSON_Array *array = NULL;
+    JSON_Object *object = NULL;
+    size_t *children = NULL, *table = NULL;
+    size_t i = 0, count = 0, buckets = 0, mask = 0;
+    JSON_Value_Type type = json_value_get_type(value);
+    if (sw->writer->failed || sw->writer->position > SNAPSHOT_MAX_SIZE) {
+        return JSONFailure;
+    }
+    if (type == JSONString) {
+        return snapshot_write_string(sw, json_value_get_string(value), position);
+    }
+    if (type == JSONArray || type == JSONObject) {
+        array = json_value_get_array(value);
+        object = json_value_get_object(value);
+        count = array != NULL ? json_array_get_count(array) : json_object_get_count(object);
+        if (object != NULL && count > SNAPSHOT_SCAN_LIMIT) {
+            buckets = 1;
+            while (buckets < count * 2) {
+                buckets *= 2;
+            }
+        }
+        if (count + buckets > 0) {
+            children = (size_t*)parson_malloc((count * 2 + buckets) * sizeof(size_t));
+            if (children == NULL) {
+                return JSONFailure;
+            }
+            table = children + count * 2;
+        }
+        for (i = 0; i < count; i++) {
+            if ((object != NULL && snapshot_write_string(sw, object->names[i], &children[count + i]) == JSONFailure) ||
+                json_value_write_snapshot_r(sw, array != NULL ? array->items[i] : object->values[i],
+                                            &children[i]) == JSONFailure) {
+                parson_free(children);
+                return JSONFailure;
+            }
+        }
+        *position = sw->writer->position;
+        snapshot_write_u32(sw, type);
+        snapshot_write_u32(sw, count);
+        if (object != NULL) {
+            snapshot_write_u32(sw, buckets);
+        }
+        for (i = 0; i < count; i++) {
+            if (object != NULL) {
+                snapshot_write_u32(sw, *position - children[count + i]);
+            }
+            snapshot_write_u32(sw, *position - children[i]);
+        }
+        for (i = 0; i < buckets; i++) {
+            table[i] = 0;
+        }
+        for (i = 0; i < count && buckets > 0; i++) {
+            mask = snapshot_hash(object->names[i], strlen(object->names[i])) & (buckets - 1);
+            while (table[mask] != 0) {
+                mask = (mask + 1) & (buckets - 1);
+            }
+            table[mask] = i + 1;
+        }
+        for (i = 0; i < buckets; i++) {
+            snapshot_write_u32(sw, table[i]);
+        }
+        parson_free(children);
+        return sw->writer->failed ? JSONFailure : JSONSuccess;
+    }
+    *position = sw->writer->position;
+    snapshot_write_u32(sw, type);
+    switch (type) {
+        case JSONNumber:
+            num = json_value_get_number(value);
+            memcpy(native, &one, sizeof(double));
+            if (native[7] == 0x3F) {
+                memcpy(number, &num, sizeof(double));
+            } else {
+                memcpy(native, &num, sizeof(double));
+                for (i = 0; i < 8; i++) {
+                    number[i] = native[7 - i];
+                }
+            }
+            binary_write(sw->writer, number, 8);
+            break;
+        case JSONBoolean:
+            snapshot_write_u32(sw, (size_t)json_value_get_boolean(value));
+            break;
+        case JSONNull:
+            break;
+        default:
+            return JSONFailure;
+    }
+    return sw->writer->failed ? JSONFailure : JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_write_snapshot_internal
+** 功能描述: 把指定的“树形结构” JSON 数据写成快照镜像，写入指定的二进制编码器中
+** 注     释: 镜像格式为：16 字节文件头（SNAPSHOT_MAGIC、版本号和两个保留字段），节点数据，8 字节文件尾
+**         : （根节点到文件尾的距离和 SNAPSHOT_MAGIC），所有整数都是 4 字节小端格式
+** 输	 入: value - 需要写入的“树形结构” JSON 数据
+**         : writer - 我们要操作的二进制编码器
+** 输	 出: JSON_Status - 执行状态，镜像超过 4GB 时返回 JSONFailure
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status json_value_write_snapshot_internal(const JSON_Value *value, JSON_Binary_Writer *writer) {
+    JSON_Snapshot_Writer sw;
+    size_t root = 0;
+    JSON_Status status = JSONFailure;
+    sw.writer = writer;
+    sw.capacity = SNAPSHOT_STRINGS_CAPACITY;
+    sw.count = 0;
+    sw.strings = (const char**)parson_malloc(sw.capacity * sizeof(char*));
+    sw.positions = (size_t*)parson_malloc(sw.capacity * sizeof(size_t));
+    if (sw.strings != NULL && sw.positions != NULL) {
+        memset((void*)sw.strings, 0, sw.capacity * sizeof(char*));
+        binary_write(writer, SNAPSHOT_MAGIC, 4);
+        snapshot_write_u32(&sw, SNAPSHOT_VERSION);
+        snapshot_write_u32(&sw, 0);
+        snapshot_write_u32(&sw, 0);
+        if (json_value_write_snapshot_r(&sw, value, &root) == JSONSuccess) {
+            snapshot_write_u32(&sw, writer->position - root);
+            binary_write(writer, SNAPSHOT_MAGIC, 4);
+            if (!writer->failed && writer->position <= SNAPSHOT_MAX_SIZE) {
+                status = JSONSuccess;
+            }
+        }
+    }
+    parson_free((void*)sw.strings);
+    parson_free(sw.positions);
+    return status;
+}
+
+/*********************************************************************************************************
+** 函数名称: snapshot_object_getn
+** 功能描述: 在快照镜像中的 JSON object 节点中查找指定“键”的成员值
+** 注     释: 有散列表时通过散列表查找，否则顺序查找
+** 输	 入: node - 我们要查找的 JSON object 节点
+**         : name - 需要查找的“键”
+**         : name_len - “键”的长度
+** 输	 出: const unsigned char * - 找到的成员值节点
+**         : NULL - 没找到
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static const unsigned char * snapshot_object_getn(const unsigned char *node, const char *name, size_t name_len) {
+    size_t count = snapshot_get_u32(node + 4), buckets = snapshot_get_u32(node + 8);
+    const unsigned char *entries = node + 12, *table = entries + count * 8, *key = NULL;
+    size_t i = 0, mask = 0, index = 0;
+    if (buckets == 0) {
+        for (i = 0; i < count; i++) {
+            key = node - snapshot_get_u32(entries + i * 8);
+            if (snapshot_get_u32(key + 4) == name_len && memcmp(key + 8, name, name_len) == 0) {
+                return node - snapshot_get_u32(entries + i * 8 + 4);
+            }
+        }
+        return NULL;
+    }
+    mask = snapshot_hash(name, name_len) & (buckets - 1);
+    while ((index = snapshot_get_u32(table + mask * 4)) != 0) {
+        key = node - snapshot_get_u32(entries + (index - 1) * 8);
+        if (snapshot_get_u32(key + 4) == name_len && memcmp(key + 8, name, name_len) == 0) {
+            return node - snapshot_get_u32(entries + (index - 1) * 8 + 4);
+        }
+        mask = (mask + 1) & (buckets - 1);
+    }
+    return NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: compact_is_little_endian
+** 功能描述: 判断 double 是否按照小端格式存储，紧凑文档中的槽位按照本机的 double 格式存储
+** 输	 入: 
+** 输	 出: 1 - 小端格式
+**         : 0 - 大端格式
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static int compact_is_little_endian(void) {
+    const double one = 1.0;
+    unsigned char native[8];
+    memcpy(native, &one, sizeof(double));
+    return native[7] == 0x3F;
+}
+
+/*********************************************************************************************************
+** 函数名称: compact_put
+** 功能描述: 向紧凑文档的指定槽位中写入一个带类型标记的 NaN
+** 输	 入: slot - 需要写入的槽位
+**         : tag - 类型标记，COMPACT_NULL 到 COMPACT_COUNT
+**         : payload - 载荷，只保存低 32 位
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void compact_put(unsigned char *slot, int tag, size_t payload) {
+    unsigned char bits[8];
+    int i = 0, little = compact_is_little_endian();
+    snapshot_put_u32(bits, payload);
+    bits[4] = 0;
+    bits[5] = 0;
+    bits[6] = (unsigned char)(0xF0 | tag);
+    bits[7] = 0xFF;
+    for (i = 0; i < 8; i++) {
+        slot[i] = bits[little ? i : 7 - i];
+    }
+}
+
+/*********************************************************************************************************
+** 函数名称: compact_get_tag
+** 功能描述: 读取紧凑文档中指定槽位的类型标记
+** 输	 入: slot - 需要读取的槽位
+** 输	 出: int - 类型标记，槽位中保存的是数值时返回 0
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static int compact_get_tag(const unsigned char *slot) {
+    int little = compact_is_little_endian();
+    unsigned char high = slot[little ? 7 : 0], next = slot[little ? 6 : 1];
+    if (high != 0xFF || (next & 0xF0) != 0xF0) {
+        return 0;
+    }
+    return next & 0x0F;
+}
+
+/*********************************************************************************************************
+** 函数名称: compact_get_payload
+** 功能描述: 读取紧凑文档中指定槽位的载荷
+** 输	 入: slot - 需要读取的槽位，必须带有类型标记
+** 输	 出: size_t - 槽位的载荷
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static size_t compact_get_payload(const unsigned char *slot) {
+    unsigned char bits[4];
+    int i = 0, little = compact_is_little_endian();
+    for (i = 0; i < 4; i++) {
+        bits[i] = slot[little ? i : 7 - i];
+    }
+    return snapshot_get_u32(bits);
+}
+
+/*********************************************************************************************************
+** 函数名称: compact_write_string
+** 功能描述: 把指定的字符串写入紧凑文档的字符串区，并在指定的槽位中写入引用这个字符串的标记
+** 注     释: 编码器的 slots 为 NULL 时只统计长度，最近写入过的同一个“键”（同一个指针）只写入一次
+** 输	 入: cw - 我们要操作的紧凑文档编码器
+**         : slot - 引用字符串的槽位索引
+**         : string - 需要写入的字符串
+**         : is_name - 字符串是否是“键”
+** 输	 出: size_t - 字符串在字符串区中的位置
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static size_t compact_write_string(JSON_Compact_Writer *cw, size_t slot, const char *string, int is_name) {
+    size_t cache = ((size_t)string / sizeof(char*)) % COMPACT_NAME_CACHE, position = cw->string_end;
+    size_t len = strlen(string);
+    if (is_name && cw->names[cache] == string) {
+        position = cw->positions[cache];
+    } else {
+        if (cw->slots != NULL) {
+            memcpy(cw->slots + cw->string_base + position, string, len + 1);
+        }
+        cw->string_end += len + 1;
+        if (is_name) {
+            cw->names[cache] = string;
+            cw->positions[cache] = position;
+        }
+    }
+    if (cw->slots != NULL) {
+        compact_put(cw->slots + slot * COMPACT_SLOT_SIZE, COMPACT_STRING,
+                    cw->string_base + position - slot * COMPACT_SLOT_SIZE);
+    }
+    return position;
+}
+
+/*********************************************************************************************************
+** 函数名称: compact_write_value
+** 功能描述: 把指定的“树形结构” JSON 数据写入紧凑文档的指定槽位，JSON object 和 JSON array 的成员区紧接着
+**         : 已经使用的槽位分配
+** 注     释: 编码器的 slots 为 NULL 时只统计槽位个数和字符串长度，统计和写入按照相同的顺序访问字符串
+** 输	 入: cw - 我们要操作的紧凑文档编码器
+**         : slot - 需要写入的槽位索引
+**         : value - 需要写入的“树形结构” JSON 数据
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static void compact_write_value(JSON_Compact_Writer *cw, size_t slot, const JSON_Value *value) {
+    unsigned char *target = cw->slots != NULL ? cw->slots + slot * COMPACT_SLOT_SIZE : NULL;
+    const JSON_Object *object = NULL;
+    const JSON_Array *array = NULL;
+    size_t i = 0, body = cw->slot_count;
+    double number = 0.0;
+    switch (json_value_get_type(value)) {
+        case JSONObject:
+            object = json_value_get_object(value);
+            cw->slot_count += 1 + object->count * 2;
+            if (target != NULL) {
+                compact_put(target, COMPACT_OBJECT, body - slot);
+                compact_put(cw->slots + body * COMPACT_SLOT_SIZE, COMPACT_COUNT, object->count);
+            }
+            for (i = 0; i < object->count; i++) {
+                compact_write_string(cw, body + 1 + i * 2, object->names[i], 1);
+                compact_write_value(cw, body + 2 + i * 2, object->values[i]);
+            }
+            break;
+        case JSONArray:
+            array = json_value_get_array(value);
+            cw->slot_count += 1 + array->count;
+            if (target != NULL) {
+                compact_put(target, COMPACT_ARRAY, body - slot);
+                compact_put(cw->slots + body * COMPACT_SLOT_SIZE, COMPACT_COUNT, array->count);
+            }
+            for (i = 0; i < array->count; i++) {
+                compact_write_value(cw, body + 1 + i, array->items[i]);
+            }
+            break;
+        case JSONString:
+            compact_write_string(cw, slot, json_value_get_string(value), 0);
+            break;
+        case JSONNumber:
+            number = json_value_get_number(value);
+            if (target != NULL) {
+                memcpy(target, &number, sizeof(double));
+            }
+            break;
+        case JSONBoolean:
+            if (target != NULL) {
+                compact_put(target, COMPACT_BOOLEAN, (size_t)json_value_get_boolean(value));
+            }
+            break;
+        default:
+            if (target != NULL) {
+                compact_put(target, COMPACT_NULL, 0);
+            }
+            break;
+    }
+}
+
+/*********************************************************************************************************
+** 函数名称: compact_object_getn
+** 功能描述: 在紧凑文档的指定 JSON object 中按顺序查找指定“键”的成员值
+** 输	 入: object - 我们要查询的 JSON object 槽位
+**         : name - 需要查找的“键”
+**         : name_len - “键”的长度
+** 输	 出: const unsigned char * - 找到的成员值槽位
+**         : NULL - 不是 JSON object 或者没找到
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static const unsigned char * compact_object_getn(const unsigned char *object, const char *name, size_t name_len) {
+    const unsigned char *body = NULL, *key = NULL;
+    const char *string = NULL;
+    size_t i = 0, count = 0;
+    if (object == NULL || compact_get_tag(object) != COMPACT_OBJECT) {
+        return NULL;
+    }
+    body = object + compact_get_payload(object) * COMPACT_SLOT_SIZE;
+    count = compact_get_payload(body);
+    for (i = 0; i < count; i++) {
+        key = body + (1 + i * 2) * COMPACT_SLOT_SIZE;
+        string = (const char*)key + compact_get_payload(key);
+        if (strncmp(string, name, name_len) == 0 && string[name_len] == '\0') {
+            return key + COMPACT_SLOT_SIZE;
+        }
+    }
+    return NULL;
+}
+
+/* Parser API */
+/*********************************************************************************************************
+** 函数名称: json_parse_file
+** 功能描述: 读取指定的 JSON 文件内容（序列化格式）并把读取到的“序列化”格式 JSON 数据解析并转换成“树形结构”
+**         : JSON 表示格式
+** 输	 入: filename - 存储“序列化”格式 JSON 数据的文件名
+** 输	 出: output_value - 解析转换后的“树形结构” JSON 数据
+**		   : NULL - 执行失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_parse_file(const char *filename) {
+    char *file_contents = read_file(filename);
+    JSON_Value *output_value = NULL;
+    if (file_contents == NULL) {
+        return NULL;
+    }
+    output_value = json_parse_string(file_contents);
+    parson_free(file_contents);
+    return output_value;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_parse_file_with_comments
+** 功能描述: 读取指定的 JSON 文件内容（序列化格式）并把读取到的“序列化”格式 JSON 数据解析并转换成“树形结构” 
+**         : JSON 表示格式
+** 注     释: 这个函数除了包含解析 JSON 字符串功能外，还包含去除 JSON 字符串中注释信息的功能逻辑，所以如果在
+**         : JSON 文件中不仅包含 JSON 原始数据，还包含了注释信息，那么我们就可以调用这个接口来解析
+** 输	 入: filename - 存储“序列化”格式 JSON 数据的文件名
+** 输	 出: output_value - 解析转换后的“树形结构” JSON 数据
+**		   : NULL - 执行失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_parse_file_with_comments(const char *filename) {
+    char *file_contents = read_file(filename);
+    JSON_Value *output_value = NULL;
+    if (file_contents == NULL) {
+        return NULL;
+    }
+    output_value = json_parse_string_with_comments(file_contents);
+    parson_free(file_contents);
+    return output_value;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_parse_string
+** 功能描述: 解析指定的 JSON 字符串数据（序列化格式）并转换成能表示 JSON 数据树形结构的表示形式
+** 输	 入: string - 序列化格式的 JSON 字符串数据
+** 输	 出: JSON_Value - 和序列化 JSON 字符串对应的 JSON 数据结构表示形式的数据
+**		   : NULL - 执行失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_parse_string(const char *string) {
+    if (string == NULL) {
+        return NULL;
+    }
+    if (string[0] == '\xEF' && string[1] == '\xBB' && string[2] == '\xBF') {
+        string = string + 3; /* Support for UTF-8 BOM */
+    }
+    return parse_root_value((const char**)&string, 0, NULL);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_parse_string_with_comments
+** 功能描述: 解析指定的 JSON 字符串数据（序列化格式）并转换成能表示 JSON 数据树形结构的表示形式
+** 注     释: 这个函数除了包含解析 JSON 字符串功能外，还包含去除 JSON 字符串中注释信息的功能逻辑，所以如果
+**         : 我们的 JSON 文件中不仅包含 JSON 原始数据，还包含了注释信息，那么我们就可以调用这个接口来解析
+**         : 注释信息在解析时和空白字符一起跳过，不需要复制和修改输入的字符串
+** 输	 入: string - 序列化格式的 JSON 字符串数据
+** 输	 出: JSON_Value - 和序列化 JSON 字符串对应的 JSON 数据结构表示形式的数据
+**		   : NULL - 执行失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_parse_string_with_comments(const char *string) {
+    if (string == NULL) {
+        return NULL;
+    }
+    return parse_root_value((const char**)&string, 1, NULL);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_parse_string_reuse
+** 功能描述: 解析指定的 JSON 字符串数据，尽量重复使用上一次解析的结果中的节点、字符串和存储空间
+** 注     释: 新的结果和 recycled 结构相同的部分（同样位置上同样类型的成员）重复使用原来的 JSON_Value，“键”和
+**         : 字符串的长度不超过原来的长度时也重复使用原来的字符串，所以重复解析结构相同的数据时基本不需要分配内存。
+**         : 成员按照位置匹配，“键”的顺序不同时仍然可以重复使用，只是内容会被覆盖
+** 输	 入: recycled - 上一次解析的结果（必须是根节点），不管解析是否成功都会被重复使用或者释放，可以为 NULL
+**         : string - 序列化格式的 JSON 字符串数据
+** 输	 出: JSON_Value - 和序列化 JSON 字符串对应的 JSON 数据结构表示形式的数据
+**		   : NULL - 执行失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_parse_string_reuse(JSON_Value *recycled, const char *string) {
+    if (recycled != NULL && VALUE_PARENT(recycled) != NULL) {
+        return NULL;
+    }
+    if (string == NULL) {
+        json_value_free(recycled);
+        return NULL;
+    }
+    if (string[0] == '\xEF' && string[1] == '\xBB' && string[2] == '\xBF') {
+        string = string + 3; /* Support for UTF-8 BOM */
+    }
+    return parse_root_value((const char**)&string, 0, recycled);
+}
+
+/* JSON Object API */
+/*********************************************************************************************************
+** 函数名称: json_object_get_value
+** 功能描述: 在指定的 JSON object 中，通过“键值对”中的“键”标识符获取与其对应的“值”标识符的内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “键值对”的“键”标识符
+** 输	 出: JSON_Value - 读取到的 JSON_Value 变量
+**		   : NULL - 执行失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_object_get_value(const JSON_Object *object, const char *name) {
+    if (object == NULL || name == NULL) {
+        return NULL;
+    }
+    return json_object_getn_value(object, name, strlen(name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_get_string
+** 功能描述: 在指定的 JSON object 中，通过 JSONString 类型变量的“键值对”中的“键”标识符获取与其对应的“值”
+**         : 标识符的内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “键值对”的“键”标识符
+** 输	 出: string - 读取到的 JSONString 类型 string 变量值
+**		   : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+const char * json_object_get_string(const JSON_Object *object, const char *name) {
+    return json_value_get_string(json_object_get_value(object, name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_get_number
+** 功能描述: 在指定的 JSON object 中，通过 JSONNumber 类型变量的“键值对”中的“键”标识符获取与其对应的“值”
+**         : 标识符的内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “键值对”的“键”标识符
+** 输	 出: double - 读取到的 JSONNumber 类型 number 变量值
+**		   : 0 - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+double json_object_get_number(const JSON_Object *object, const char *name) {
+    return json_value_get_number(json_object_get_value(object, name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_get_object
+** 功能描述: 在指定的 JSON object 中，通过 JSONObject 类型变量的“键值对”中的“键”标识符获取与其对应的“值”
+**         : 标识符的内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “键值对”的“键”标识符
+** 输	 出: JSON_Object - 读取到的 JSONObject 类型 object 变量值
+**		   : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Object * json_object_get_object(const JSON_Object *object, const char *name) {
+    return json_value_get_object(json_object_get_value(object, name));
+}
+
+/*********************************************************************************************************
 ** 函数名称: json_object_get_array
 ** 功能描述: 在指定的 JSON object 中，通过 JSONArray 类型变量的“键值对”中的“键”标识符获取与其对应的“值”
 **         : 标识符的内容
 ** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “键值对”的“键”标识符
+**         : name - “键值对”的“键”标识符
+** 输	 出: JSON_Array - 读取到的 JSONArray 类型 array 变量值
+**		   : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Array * json_object_get_array(const JSON_Object *object, const char *name) {
+    return json_value_get_array(json_object_get_value(object, name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_get_boolean
+** 功能描述: 在指定的 JSON object 中，通过 JSONBoolean 类型变量的“键值对”中的“键”标识符获取与其对应的“值”
+**         : 标识符的内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “键值对”的“键”标识符
+** 输	 出: JSONBoolean - 读取到的 JSONBoolean 类型 boolean 变量值
+**		   : -1 - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+int json_object_get_boolean(const JSON_Object *object, const char *name) {
+    return json_value_get_boolean(json_object_get_value(object, name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_dotget_value
+** 功能描述: 在指定的 JSON object 中，通过“点”描述法获取对应路径位置上的 JSON_Value 变量
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “点”描述法的 JSON_Value 变量路径
+** 输	 出: JSON_Value - 读取到的 JSON_Value 变量
+**		   : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_object_dotget_value(const JSON_Object *object, const char *name) {
+    const char *dot_position = strchr(name, '.');
+    if (!dot_position) {
+        return json_object_get_value(object, name);
+    }
+    object = json_value_get_object(json_object_getn_value(object, name, dot_position - name));
+    return json_object_dotget_value(object, dot_position + 1);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_dotget_string
+** 功能描述: 在指定的 JSON object 中，通过 JSONString 类型变量的“点”描述法获取对应路径位置上的 JSON_Value 变量
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “点”描述法的 JSON_Value 变量路径
+** 输	 出: string - 读取到的 JSONString 类型 string 变量值
+**		   : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+const char * json_object_dotget_string(const JSON_Object *object, const char *name) {
+    return json_value_get_string(json_object_dotget_value(object, name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_dotget_number
+** 功能描述: 在指定的 JSON object 中，通过 JSONNumber 类型变量的“点”描述法获取对应路径位置上的 JSON_Value 变量
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “点”描述法的 JSON_Value 变量路径
+** 输	 出: double - 读取到的 JSONNumber 类型 number 变量值
+**		   : 0 - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+double json_object_dotget_number(const JSON_Object *object, const char *name) {
+    return json_value_get_number(json_object_dotget_value(object, name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_dotget_object
+** 功能描述: 在指定的 JSON object 中，通过 JSONObject 类型变量的“点”描述法获取对应路径位置上的 JSON_Value 变量
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “点”描述法的 JSON_Value 变量路径
+** 输	 出: JSON_Object - 读取到的 JSONObject 类型 object 变量值
+**		   : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Object * json_object_dotget_object(const JSON_Object *object, const char *name) {
+    return json_value_get_object(json_object_dotget_value(object, name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_dotget_array
+** 功能描述: 在指定的 JSON object 中，通过 JSONArray 类型变量的“点”描述法获取对应路径位置上的 JSON_Value 变量
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “点”描述法的 JSON_Value 变量路径
 ** 输	 出: JSON_Array - 读取到的 JSONArray 类型 array 变量值
 **		   : NULL - 读取失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Array * json_object_get_array(const JSON_Object *object, const char *name) {
-    return json_value_get_array(json_object_get_value(object, name));
+JSON_Array * json_object_dotget_array(const JSON_Object *object, const char *name) {
+    return json_value_get_array(json_object_dotget_value(object, name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_dotget_boolean
+** 功能描述: 在指定的 JSON object 中，通过 JSONBoolean 类型变量的“点”描述法获取对应路径位置上的 JSON_Value 变量
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “点”描述法的 JSON_Value 变量路径
+** 输	 出: JSONBoolean - 读取到的 JSONBoolean 类型 boolean 变量值
+**		   : -1 - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+int json_object_dotget_boolean(const JSON_Object *object, const char *name) {
+    return json_value_get_boolean(json_object_dotget_value(object, name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_get_count
+** 功能描述: 获取指定 JSON object 中已经存储的“键值对”个数
+** 输	 入: object - 我们要操作的 JSON object 对象
+** 输	 出: size_t - “键值对”个数
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_object_get_count(const JSON_Object *object) {
+    return object ? object->count : 0;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_get_name
+** 功能描述: 获取指定 JSON object 中指定索引位置的“键值对”的“键”标识符内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : index - “键”标识符索引值
+** 输	 出: string - “键”标识符内容
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+const char * json_object_get_name(const JSON_Object *object, size_t index) {
+    if (object == NULL || index >= json_object_get_count(object)) {
+        return NULL;
+    }
+    return object->names[index];
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_get_value_at
+** 功能描述: 获取指定 JSON object 中指定索引位置的“键值对”的“值”标识符内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : index - “值”标识符索引值
+** 输	 出: string - “值”标识符内容
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_object_get_value_at(const JSON_Object *object, size_t index) {
+    if (object == NULL || index >= json_object_get_count(object)) {
+        return NULL;
+    }
+    return object->values[index];
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_get_wrapping_value
+** 功能描述: 获取指定 JSON object 所属的 JSON_Value 的指针
+** 输	 入: object - 我们要操作的 JSON object 对象
+** 输	 出: JSON_Value - 指定 JSON object 所属的 JSON_Value 的指针
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value *json_object_get_wrapping_value(const JSON_Object *object) {
+    return object->wrapping_value;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_has_value
+** 功能描述: 判断指定的 JSON object 中是否存在指定“键”标识符的“键值对”数据内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “键值对”的“键”标识符
+** 输	 出: 1 - “键值对”数据存在
+**         : 0 - “键值对”数据不存在
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+int json_object_has_value (const JSON_Object *object, const char *name) {
+    return json_object_get_value(object, name) != NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_has_value_of_type
+** 功能描述: 判断指定的 JSON object 中是否存在指定“键”标识符及 JSON_Value_Type 的“键值对”数据内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “键值对”的“键”标识符
+**         : type - “键值对”的“值”标识符数据类型
+** 输	 出: 1 - “键值对”数据及类型存在
+**         : 0 - “键值对”数据及类型不存在
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+int json_object_has_value_of_type(const JSON_Object *object, const char *name, JSON_Value_Type type) {
+    JSON_Value *val = json_object_get_value(object, name);
+    return val != NULL && json_value_get_type(val) == type;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_has_value_of_type
+** 功能描述: 判断指定的 JSON object 中是否存在“点”描述法指定的“键值对”数据内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “点”描述法的 JSON_Value 变量路径
+** 输	 出: JSON_Value - 读取到的 JSON_Value 变量
+**		   : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+int json_object_dothas_value (const JSON_Object *object, const char *name) {
+    return json_object_dotget_value(object, name) != NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_dothas_value_of_type
+** 功能描述: 判断指定的 JSON object 中是否存在“点”描述法及 JSON_Value_Type 指定的“键值对”数据内容
+** 输	 入: object - 我们要操作的 JSON object 对象
+**         : name - “点”描述法的 JSON_Value 变量路径
+**         : type - “键值对”的“值”标识符数据类型
+** 输	 出: 1 - “键值对”数据及类型存在
+**         : 0 - “键值对”数据及类型不存在
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+int json_object_dothas_value_of_type(const JSON_Object *object, const char *name, JSON_Value_Type type) {
+    JSON_Value *val = json_object_dotget_value(object, name);
+    return val != NULL && json_value_get_type(val) == type;
+}
+
+/* JSON Array API */
+/*********************************************************************************************************
+** 函数名称: json_array_get_value
+** 功能描述: 获取指定的 JSON array 中指定索引位置处的 JSON_Value 成员数据内容
+** 输	 入: array - 我们要操作的 JSON array 对象
+**         : index - 数组元素索引值
+** 输	 出: JSON_Value - 读取到的数组成员
+**         : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_array_get_value(const JSON_Array *array, size_t index) {
+    if (array == NULL || index >= json_array_get_count(array)) {
+        return NULL;
+    }
+    return array->items[index];
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_get_string
+** 功能描述: 在指定的 JSON array 中，通过 JSONString 类型变量的“索引下标值”获取与其对应的内容
+** 输	 入: array - 我们要操作的 JSON array 对象
+**         : index - JSONString 类型变量的“索引下标值”
+** 输	 出: JSON_Value - 读取到的 JSONString 类型 string 变量值
+**         : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+const char * json_array_get_string(const JSON_Array *array, size_t index) {
+    return json_value_get_string(json_array_get_value(array, index));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_get_number
+** 功能描述: 在指定的 JSON array 中，通过 JSONNumber 类型变量的“索引下标值”获取与其对应的内容
+** 输	 入: array - 我们要操作的 JSON array 对象
+**         : index - JSONNumber 类型变量的“索引下标值”
+** 输	 出: double - 读取到的 JSONNumber 类型 number 变量值
+**         : 0 - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+double json_array_get_number(const JSON_Array *array, size_t index) {
+    return json_value_get_number(json_array_get_value(array, index));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_get_object
+** 功能描述: 在指定的 JSON array 中，通过 JSONObject 类型变量的“索引下标值”获取与其对应的内容
+** 输	 入: array - 我们要操作的 JSON array 对象
+**         : index - JSONObject 类型变量的“索引下标值”
+** 输	 出: double - 读取到的 JSONObject 类型 object 变量值
+**         : 0 - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Object * json_array_get_object(const JSON_Array *array, size_t index) {
+    return json_value_get_object(json_array_get_value(array, index));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_get_array
+** 功能描述: 在指定的 JSON array 中，通过 JSONArray 类型变量的“索引下标值”获取与其对应的内容
+** 输	 入: array - 我们要操作的 JSON array 对象
+**         : index - JSONArray 类型变量的“索引下标值”
+** 输	 出: double - 读取到的 JSONArray 类型 array 变量值
+**         : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Array * json_array_get_array(const JSON_Array *array, size_t index) {
+    return json_value_get_array(json_array_get_value(array, index));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_get_boolean
+** 功能描述: 在指定的 JSON array 中，通过 JSONBoolean 类型变量的“索引下标值”获取与其对应的内容
+** 输	 入: array - 我们要操作的 JSON array 对象
+**         : index - JSONBoolean 类型变量的“索引下标值”
+** 输	 出: double - 读取到的 JSONBoolean 类型 boolean 变量值
+**         : -1 - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+int json_array_get_boolean(const JSON_Array *array, size_t index) {
+    return json_value_get_boolean(json_array_get_value(array, index));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_get_count
+** 功能描述: 获取指定的 JSON_Array 中已经存储的 JSON_Value 成员个数
+** 输	 入: array - 我们要操作的 JSON array 对象
+** 输	 出: size_t - JSON_Array 成员个数
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_array_get_count(const JSON_Array *array) {
+    return array ? array->count : 0;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_get_numbers
+** 功能描述: 把指定 JSON array 开头的 JSON_Number 类型成员的值复制到指定的 double 数组中
+** 注     释: 遇到第一个不是 JSON_Number 类型的成员时停止复制
+** 输	 入: array - 我们要操作的 JSON array 对象
+**         : numbers - 保存成员值的数组
+**         : count - numbers 数组最多可以保存的成员个数
+** 输	 出: size_t - 复制的成员个数
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_array_get_numbers(const JSON_Array *array, double *numbers, size_t count) {
+    const JSON_Value *value = NULL;
+    size_t i = 0;
+    if (array == NULL || numbers == NULL) {
+        return 0;
+    }
+    count = MIN(count, array->count);
+    for (i = 0; i < count; i++) {
+        value = array->items[i];
+        if (value->type != JSONNumber) {
+            break;
+        }
+        numbers[i] = value->value.number;
+    }
+    return i;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_get_strings
+** 功能描述: 把指定 JSON array 开头的 JSON_String 类型成员的字符串指针复制到指定的数组中
+** 注     释: 遇到第一个不是 JSON_String 类型的成员时停止复制，字符串属于 JSON array，不需要释放
+** 输	 入: array - 我们要操作的 JSON array 对象
+**         : strings - 保存字符串指针的数组
+**         : count - strings 数组最多可以保存的成员个数
+** 输	 出: size_t - 复制的成员个数
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_array_get_strings(const JSON_Array *array, const char **strings, size_t count) {
+    const JSON_Value *value = NULL;
+    size_t i = 0;
+    if (array == NULL || strings == NULL) {
+        return 0;
+    }
+    count = MIN(count, array->count);
+    for (i = 0; i < count; i++) {
+        value = array->items[i];
+        if (value->type != JSONString) {
+            break;
+        }
+        strings[i] = value->value.string;
+    }
+    return i;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_get_booleans
+** 功能描述: 把指定 JSON array 开头的 JSON_Boolean 类型成员的值（0 或者 1）复制到指定的 int 数组中
+** 注     释: 遇到第一个不是 JSON_Boolean 类型的成员时停止复制
+** 输	 入: array - 我们要操作的 JSON array 对象
+**         : booleans - 保存成员值的数组
+**         : count - booleans 数组最多可以保存的成员个数
+** 输	 出: size_t - 复制的成员个数
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_array_get_booleans(const JSON_Array *array, int *booleans, size_t count) {
+    const JSON_Value *value = NULL;
+    size_t i = 0;
+    if (array == NULL || booleans == NULL) {
+        return 0;
+    }
+    count = MIN(count, array->count);
+    for (i = 0; i < count; i++) {
+        value = array->items[i];
+        if (value->type != JSONBoolean) {
+            break;
+        }
+        booleans[i] = value->value.boolean;
+    }
+    return i;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_get_wrapping_value
+** 功能描述: 获取指定的 JSON_Array 所属 JSON_Value 的指针
+** 输	 入: array - 我们要操作的 JSON array 对象
+** 输	 出: JSON_Value - JSON_Array 所属 JSON_Value 的指针
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_array_get_wrapping_value(const JSON_Array *array) {
+    return array->wrapping_value;
+}
+
+/* JSON Value API */
+/*********************************************************************************************************
+** 函数名称: json_value_get_type
+** 功能描述: 获取指定 JSON_Value 对应的变量类型
+** 输	 入: value - 我们要操作的 JSON_Value 对象
+** 输	 出: JSON_Value_Type - JSON_Value 对象类型
+**         : JSONError - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value_Type json_value_get_type(const JSON_Value *value) {
+    return value ? value->type : JSONError;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_get_object
+** 功能描述: 获取指定的 JSONObject 类型的 JSON_Value 所对应的变量值
+** 输	 入: value - 我们要操作的 JSON_Value 对象
+** 输	 出: JSON_Object - JSON_Object 变量值
+**         : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Object * json_value_get_object(const JSON_Value *value) {
+    return json_value_get_type(value) == JSONObject ? value->value.object : NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_get_array
+** 功能描述: 获取指定的 JSONArray 类型的 JSON_Value 所对应的变量值
+** 输	 入: value - 我们要操作的 JSON_Value 对象
+** 输	 出: JSON_Array - JSONArray 变量值
+**         : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Array * json_value_get_array(const JSON_Value *value) {
+    return json_value_get_type(value) == JSONArray ? value->value.array : NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_get_string
+** 功能描述: 获取指定的 JSONString 类型的 JSON_Value 所对应的变量值
+** 输	 入: value - 我们要操作的 JSON_Value 对象
+** 输	 出: string - JSONString 变量值
+**         : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+const char * json_value_get_string(const JSON_Value *value) {
+    return json_value_get_type(value) == JSONString ? value->value.string : NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_get_number
+** 功能描述: 获取指定的 JSONNumber 类型的 JSON_Value 所对应的变量值
+** 输	 入: value - 我们要操作的 JSON_Value 对象
+** 输	 出: double - JSONNumber 变量值
+**         : 0 - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+double json_value_get_number(const JSON_Value *value) {
+    return json_value_get_type(value) == JSONNumber ? value->value.number : 0;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_get_boolean
+** 功能描述: 获取指定的 JSONBoolean 类型的 JSON_Value 所对应的变量值
+** 输	 入: value - 我们要操作的 JSON_Value 对象
+** 输	 出: JSONBoolean - JSONBoolean 变量值
+**         : -1 - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+int json_value_get_boolean(const JSON_Value *value) {
+    return json_value_get_type(value) == JSONBoolean ? value->value.boolean : -1;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_get_parent
+** 功能描述: 获取指定 JSON_Value 在“树形结构”表示形式中父节点的指针
+** 注     释: 冻结的 JSON_Value 可能被多个父节点共享，没有父节点指针
+** 输	 入: value - 我们要操作的 JSON_Value 对象
+** 输	 出: JSON_Value - 父节点的指针
+**         : NULL - 读取失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_value_get_parent (const JSON_Value *value) {
+    return value ? VALUE_PARENT(value) : NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_detach
+** 功能描述: 把指定的 JSON_Value 从它的父节点中移除，但是不释放，使它成为一个可以添加到其他 JSON 数据中
+**         : 的根节点，不需要复制
+** 注     释: 在父节点中查找它的位置需要遍历父节点的成员；父节点是 JSON object 时和 json_object_remove 一样
+**         : 用最后一个“键值对”填补删除的位置。冻结的 JSON_Value 不能被移除，定义 PARSON_NO_PARENT 时
+**         : 没有父节点指针，总是返回 NULL，需要使用 json_object_take_value 和 json_array_take_value
+** 输	 入: value - 我们要移除的 JSON_Value
+** 输	 出: JSON_Value - 移除的 JSON_Value（没有父节点时就是它自己），属于调用者
+**         : NULL - 冻结的 JSON_Value，或者定义了 PARSON_NO_PARENT
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_value_detach(JSON_Value *value) {
+#ifdef PARSON_NO_PARENT
+    (void)value;
+    return NULL;
+#else
+    JSON_Value *parent = NULL, *taken = NULL;
+    JSON_Object *object = NULL;
+    JSON_Array *array = NULL;
+    size_t i = 0;
+    if (value == NULL || IS_FROZEN(value)) {
+        return NULL;
+    }
+    parent = VALUE_PARENT(value);
+    switch (json_value_get_type(parent)) {
+        case JSONObject:
+            object = json_value_get_object(parent);
+            for (i = 0; i < object->count; i++) {
+                if (object->values[i] == value) {
+                    return json_object_remove_index(object, i, &taken, 0) == JSONSuccess ? taken : NULL;
+                }
+            }
+            return NULL;
+        case JSONArray:
+            array = json_value_get_array(parent);
+            for (i = 0; i < array->count; i++) {
+                if (array->items[i] == value) {
+                    return json_array_take_value(array, i);
+                }
+            }
+            return NULL;
+        default:
+            return value; /* already a root */
+    }
+#endif
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_get_member
+** 功能描述: 获取指定 JSON object 或者 JSON array 中指定索引的成员
+** 输	 入: value - 我们要操作的 JSON_Value 对象
+**         : index - 成员索引
+** 输	 出: JSON_Value - 找到的成员
+**         : NULL - 不是 JSON object 或者 JSON array，或者索引越界
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Value * json_value_get_member(const JSON_Value *value, size_t index) {
+    if (json_value_get_type(value) == JSONObject) {
+        return json_object_get_value_at(json_value_get_object(value), index);
+    }
+    return json_array_get_value(json_value_get_array(value), index);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_init
+** 功能描述: 创建一个指向指定根节点的游标
+** 输	 入: root - 游标遍历的根节点
+** 输	 出: JSON_Cursor - 新创建的游标
+**         : NULL - 执行失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Cursor * json_cursor_init(const JSON_Value *root) {
+    JSON_Cursor *cursor = NULL;
+    if (root == NULL) {
+        return NULL;
+    }
+    cursor = (JSON_Cursor*)parson_malloc(sizeof(JSON_Cursor));
+    if (cursor == NULL) {
+        return NULL;
+    }
+    cursor->capacity = STARTING_CAPACITY;
+    cursor->values = (JSON_Value**)parson_malloc(cursor->capacity * sizeof(JSON_Value*));
+    cursor->indexes = (size_t*)parson_malloc(cursor->capacity * sizeof(size_t));
+    if (cursor->values == NULL || cursor->indexes == NULL) {
+        json_cursor_free(cursor);
+        return NULL;
+    }
+    cursor->values[0] = (JSON_Value*)root;
+    cursor->indexes[0] = 0;
+    cursor->depth = 0;
+    return cursor;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_free
+** 功能描述: 释放指定的游标，不会释放游标遍历的 JSON 数据
+** 输	 入: cursor - 需要释放的游标
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+void json_cursor_free(JSON_Cursor *cursor) {
+    if (cursor == NULL) {
+        return;
+    }
+    parson_free(cursor->values);
+    parson_free(cursor->indexes);
+    parson_free(cursor);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_value
+** 功能描述: 获取指定游标当前指向的节点
+** 输	 入: cursor - 我们要查询的游标
+** 输	 出: JSON_Value - 当前节点
+**         : NULL - cursor 为 NULL
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_cursor_value(const JSON_Cursor *cursor) {
+    return cursor ? cursor->values[cursor->depth] : NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_parent
+** 功能描述: 获取指定游标当前指向的节点在遍历路径上的父节点
+** 注     释: 不需要 JSON_Value 中的 parent 指针，对于共享子树返回的是遍历时经过的父节点
+** 输	 入: cursor - 我们要查询的游标
+** 输	 出: JSON_Value - 父节点
+**         : NULL - 当前节点是根节点
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_cursor_parent(const JSON_Cursor *cursor) {
+    return cursor && cursor->depth > 0 ? cursor->values[cursor->depth - 1] : NULL;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_depth
+** 功能描述: 获取指定游标当前指向的节点的深度
+** 输	 入: cursor - 我们要查询的游标
+** 输	 出: size_t - 当前节点的深度，根节点的深度为 0
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_cursor_depth(const JSON_Cursor *cursor) {
+    return cursor ? cursor->depth : 0;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_index
+** 功能描述: 获取指定游标当前指向的节点在父节点中的成员索引
+** 输	 入: cursor - 我们要查询的游标
+** 输	 出: size_t - 成员索引，当前节点是根节点时返回 0
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_cursor_index(const JSON_Cursor *cursor) {
+    return cursor && cursor->depth > 0 ? cursor->indexes[cursor->depth] : 0;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_name
+** 功能描述: 获取指定游标当前指向的节点在父节点（JSON object）中的“键”
+** 输	 入: cursor - 我们要查询的游标
+** 输	 出: const char * - 当前节点的“键”
+**         : NULL - 当前节点是根节点或者父节点不是 JSON object
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+const char * json_cursor_name(const JSON_Cursor *cursor) {
+    JSON_Value *parent = json_cursor_parent(cursor);
+    if (json_value_get_type(parent) != JSONObject) {
+        return NULL;
+    }
+    return json_object_get_name(json_value_get_object(parent), cursor->indexes[cursor->depth]);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_down
+** 功能描述: 把指定游标移动到当前节点（JSON object 或者 JSON array）的指定索引的成员
+** 输	 入: cursor - 我们要操作的游标
+**         : index - 成员索引
+** 输	 出: JSON_Status - 执行状态，失败时游标保持不变
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_cursor_down(JSON_Cursor *cursor, size_t index) {
+    JSON_Value *member = NULL, **values = NULL;
+    size_t *indexes = NULL, new_capacity = 0;
+    if (cursor == NULL) {
+        return JSONFailure;
+    }
+    member = json_value_get_member(cursor->values[cursor->depth], index);
+    if (member == NULL) {
+        return JSONFailure;
+    }
+    if (cursor->depth + 1 >= cursor->capacity) {
+        new_capacity = cursor->capacity * 2;
+        values = (JSON_Value**)parson_malloc(new_capacity * sizeof(JSON_Value*));
+        indexes = (size_t*)parson_malloc(new_capacity * sizeof(size_t));
+        if (values == NULL || indexes == NULL) {
+            parson_free(values);
+            parson_free(indexes);
+            return JSONFailure;
+        }
+        memcpy(values, cursor->values, cursor->capacity * sizeof(JSON_Value*));
+        memcpy(indexes, cursor->indexes, cursor->capacity * sizeof(size_t));
+        parson_free(cursor->values);
+        parson_free(cursor->indexes);
+        cursor->values = values;
+        cursor->indexes = indexes;
+        cursor->capacity = new_capacity;
+    }
+    cursor->depth++;
+    cursor->values[cursor->depth] = member;
+    cursor->indexes[cursor->depth] = index;
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_member
+** 功能描述: 把指定游标移动到当前节点（JSON object）中指定“键”的成员
+** 输	 入: cursor - 我们要操作的游标
+**         : name - 成员的“键”
+** 输	 出: JSON_Status - 执行状态，失败时游标保持不变
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_cursor_member(JSON_Cursor *cursor, const char *name) {
+    JSON_Object *object = json_value_get_object(json_cursor_value(cursor));
+    size_t i = 0;
+    if (object == NULL || name == NULL || !json_object_find_index(object, name, strlen(name), &i)) {
+        return JSONFailure;
+    }
+    return json_cursor_down(cursor, i);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_up
+** 功能描述: 把指定游标移动到当前节点的父节点
+** 输	 入: cursor - 我们要操作的游标
+** 输	 出: JSON_Status - 执行状态，当前节点是根节点时返回 JSONFailure
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_cursor_up(JSON_Cursor *cursor) {
+    if (cursor == NULL || cursor->depth == 0) {
+        return JSONFailure;
+    }
+    cursor->depth--;
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_next
+** 功能描述: 按照先序遍历的顺序把指定游标移动到下一个节点：当前节点有成员时移动到第一个成员，否则移动到
+**         : 当前节点或者最近的祖先节点的下一个兄弟节点
+** 输	 入: cursor - 我们要操作的游标
+** 输	 出: JSON_Status - 执行状态，已经遍历完所有节点时返回 JSONFailure，游标保持不变
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_cursor_next(JSON_Cursor *cursor) {
+    JSON_Value *sibling = NULL;
+    size_t depth = 0;
+    if (cursor == NULL) {
+        return JSONFailure;
+    }
+    if (json_value_get_member(cursor->values[cursor->depth], 0) != NULL) {
+        return json_cursor_down(cursor, 0);
+    }
+    for (depth = cursor->depth; depth > 0; depth--) {
+        sibling = json_value_get_member(cursor->values[depth - 1], cursor->indexes[depth] + 1);
+        if (sibling != NULL) {
+            cursor->depth = depth;
+            cursor->values[depth] = sibling;
+            cursor->indexes[depth]++;
+            return JSONSuccess;
+        }
+    }
+    return JSONFailure;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_cursor_seek
+** 功能描述: 从根节点开始按照先序遍历查找指定的节点，并把游标移动到这个节点，这样就可以通过 json_cursor_parent
+**         : 得到它的父节点（以及整个路径）
+** 输	 入: cursor - 我们要操作的游标
+**         : value - 需要查找的节点
+** 输	 出: JSON_Status - 执行状态，没有找到时游标回到根节点并返回 JSONFailure
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_cursor_seek(JSON_Cursor *cursor, const JSON_Value *value) {
+    if (cursor == NULL || value == NULL) {
+        return JSONFailure;
+    }
+    cursor->depth = 0;
+    do {
+        if (cursor->values[cursor->depth] == value) {
+            return JSONSuccess;
+        }
+    } while (json_cursor_next(cursor) == JSONSuccess);
+    cursor->depth = 0;
+    return JSONFailure;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_free
+** 功能描述: 释放 JSON “键值对”中的“值”标识符占用的内存资源
+** 注     释: 冻结的 JSON_Value 只释放一个引用，最后一个引用释放时才释放内存
+** 输	 入: value - 我们要操作的 JSON_Value 对象
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+void json_value_free(JSON_Value *value) {
+    if (value != NULL && IS_FROZEN(value) && ATOMIC_ADD_INT(&value->refcount, -1) != 0) {
+        return; /* still shared */
+    }
+    switch (json_value_get_type(value)) {
+        case JSONObject:
+            json_object_free(value->value.object);
+            break;
+        case JSONString:
+            parson_free_string(value->value.string);
+            break;
+        case JSONArray:
+            json_array_free(value->value.array);
+            break;
+        default:
+            break;
+    }
+    parson_pool_free(value, sizeof(JSON_Value));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_init_object
+** 功能描述: 创建并初始化一个 JSON_Object 类型的 JSON_Value 变量
+** 输	 入: 
+** 输	 出: JSON_Value - 创建的 JSON_Object 变量
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_value_init_object(void) {
+    JSON_Value *new_value = (JSON_Value*)parson_pool_alloc(sizeof(JSON_Value));
+    if (!new_value) {
+        return NULL;
+    }
+    SET_VALUE_PARENT(new_value, NULL);
+    new_value->refcount = 0;
+    new_value->type = JSONObject;
+    new_value->value.object = json_object_init(new_value);
+    if (!new_value->value.object) {
+        parson_pool_free(new_value, sizeof(JSON_Value));
+        return NULL;
+    }
+    return new_value;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_init_array
+** 功能描述: 创建并初始化一个 JSON_Array 类型的 JSON_Value 变量
+** 输	 入: 
+** 输	 出: JSON_Value - 创建的 JSON_Array 变量
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_value_init_array(void) {
+    JSON_Value *new_value = (JSON_Value*)parson_pool_alloc(sizeof(JSON_Value));
+    if (!new_value) {
+        return NULL;
+    }
+    SET_VALUE_PARENT(new_value, NULL);
+    new_value->refcount = 0;
+    new_value->type = JSONArray;
+    new_value->value.array = json_array_init(new_value);
+    if (!new_value->value.array) {
+        parson_pool_free(new_value, sizeof(JSON_Value));
+        return NULL;
+    }
+    return new_value;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_init_array_with_capacity
+** 功能描述: 创建并初始化一个 JSON_Array 类型的 JSON_Value 变量，并预先分配可以存储指定个数成员的空间
+** 注     释: 追加不超过 capacity 个成员时不会再重新分配数组空间
+** 输	 入: capacity - 预先分配的成员个数，为 0 时和 json_value_init_array 相同
+** 输	 出: JSON_Value - 创建的 JSON_Array 变量
+**         : NULL - 内存不足
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_value_init_array_with_capacity(size_t capacity) {
+    JSON_Value *new_value = json_value_init_array();
+    if (new_value == NULL || capacity == 0) {
+        return new_value;
+    }
+    if (json_array_resize(json_value_get_array(new_value), capacity) == JSONFailure) {
+        json_value_free(new_value);
+        return NULL;
+    }
+    return new_value;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_init_string
+** 功能描述: 创建并初始化一个 JSON_String 类型的 JSON_Value 变量
+** 输	 入: string - JSON_String 类型的 JSON_Value 变量初始值
+** 输	 出: JSON_Value - 创建的 JSON_String 变量
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_value_init_string(const char *string) {
+    char *copy = NULL;
+    JSON_Value *value;
+    size_t string_len = 0;
+    if (string == NULL) {
+        return NULL;
+    }
+    string_len = strlen(string);
+    if (!is_valid_utf8(string, string_len)) {
+        return NULL;
+    }
+    copy = parson_strndup(string, string_len);
+    if (copy == NULL) {
+        return NULL;
+    }
+    value = json_value_init_string_no_copy(copy);
+    if (value == NULL) {
+        parson_free_string(copy);
+    }
+    return value;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_init_number
+** 功能描述: 创建并初始化一个 JSON_Number 类型的 JSON_Value 变量
+** 输	 入: number - JSON_Number 类型的 JSON_Value 变量初始值
+** 输	 出: JSON_Value - 创建的 JSON_Number 变量
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_value_init_number(double number) {
+    JSON_Value *new_value = NULL;
+    if (IS_NUMBER_INVALID(number)) {
+        return NULL;
+    }
+    new_value = (JSON_Value*)parson_pool_alloc(sizeof(JSON_Value));
+    if (new_value == NULL) {
+        return NULL;
+    }
+    SET_VALUE_PARENT(new_value, NULL);
+    new_value->refcount = 0;
+    new_value->type = JSONNumber;
+    new_value->value.number = number;
+    return new_value;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_init_boolean
+** 功能描述: 创建并初始化一个 JSON_Bool 类型的 JSON_Value 变量
+** 输	 入: boolean - JSON_Bool 类型的 JSON_Value 变量初始值
+** 输	 出: JSON_Value - 创建的 JSON_Bool 变量
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_value_init_boolean(int boolean) {
+    JSON_Value *new_value = (JSON_Value*)parson_pool_alloc(sizeof(JSON_Value));
+    if (!new_value) {
+        return NULL;
+    }
+    SET_VALUE_PARENT(new_value, NULL);
+    new_value->refcount = 0;
+    new_value->type = JSONBoolean;
+    new_value->value.boolean = boolean ? 1 : 0;
+    return new_value;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_init_null
+** 功能描述: 创建并初始化一个 JSON_Null 类型的 JSON_Value 变量
+** 输	 入: boolean - JSON_Bool 类型的 JSON_Value 变量初始值
+** 输	 出: JSON_Value - 创建的 JSON_Null 变量
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_value_init_null(void) {
+    JSON_Value *new_value = (JSON_Value*)parson_pool_alloc(sizeof(JSON_Value));
+    if (!new_value) {
+        return NULL;
+    }
+    SET_VALUE_PARENT(new_value, NULL);
+    new_value->refcount = 0;
+    new_value->type = JSONNull;
+    return new_value;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_deep_copy
+** 功能描述: 分别递归遍历指定的“树形结构” JSON 数据，为每一个节点对象分配新的内存空间并复制对应的数据内容
+**         : 到新空间中，然后返回“新构建”数的根节点 JSON_Value 地址
+** 输	 入: value - 需要被复制的树形结构 JSON 数据
+** 输	 出: JSON_Value - 新复制的树形结构 JSON 数据
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_value_deep_copy(const JSON_Value *value) {
+    size_t i = 0;
+    JSON_Value *return_value = NULL, *temp_value_copy = NULL, *temp_value = NULL;
+    const char *temp_string = NULL, *temp_key = NULL;
+    char *temp_string_copy = NULL;
+    JSON_Array *temp_array = NULL, *temp_array_copy = NULL;
+    JSON_Object *temp_object = NULL, *temp_object_copy = NULL;
+
+    switch (json_value_get_type(value)) {
+        case JSONArray:
+            temp_array = json_value_get_array(value);
+            return_value = json_value_init_array();
+            if (return_value == NULL) {
+                return NULL;
+            }
+            temp_array_copy = json_value_get_array(return_value);
+
+            /* 分别遍历 JSON 数组结构中的每一个成员，并复制到新分配的内存空间中
+             * 如果数组当前 JSON 树形结构深度不是一，则会执行递归拷贝，复制整个
+             * JSON 树中的所有数据到新分配的对应空间中 */
+            for (i = 0; i < json_array_get_count(temp_array); i++) {
+                temp_value = json_array_get_value(temp_array, i);
+                temp_value_copy = json_value_deep_copy(temp_value);
+                if (temp_value_copy == NULL) {
+                    json_value_free(return_value);
+                    return NULL;
+                }
+                if (json_array_add(temp_array_copy, temp_value_copy) == JSONFailure) {
+                    json_value_free(return_value);
+                    json_value_free(temp_value_copy);
+                    return NULL;
+                }
+            }
+            return return_value;
+        case JSONObject:
+            temp_object = json_value_get_object(value);
+            return_value = json_value_init_object();
+            if (return_value == NULL) {
+                return NULL;
+            }
+
+            /* 分别遍历 JSON 对象结构中的每一个成员，并复制到新分配的内存空间中
+             * 如果数组当前 JSON 树形结构深度不是一，则会执行递归拷贝，复制整个
+             * JSON 树中的所有数据到新分配的对应空间中 */
+            temp_object_copy = json_value_get_object(return_value);
+            for (i = 0; i < json_object_get_count(temp_object); i++) {
+                temp_key = json_object_get_name(temp_object, i);
+                temp_value = json_object_get_value(temp_object, temp_key);
+                temp_value_copy = json_value_deep_copy(temp_value);
+                if (temp_value_copy == NULL) {
+                    json_value_free(return_value);
+                    return NULL;
+                }
+                if (json_object_add(temp_object_copy, temp_key, temp_value_copy) == JSONFailure) {
+                    json_value_free(return_value);
+                    json_value_free(temp_value_copy);
+                    return NULL;
+                }
+            }
+            return return_value;
+        case JSONBoolean:
+            return json_value_init_boolean(json_value_get_boolean(value));
+        case JSONNumber:
+            return json_value_init_number(json_value_get_number(value));
+        case JSONString:
+            temp_string = json_value_get_string(value);
+            if (temp_string == NULL) {
+                return NULL;
+            }
+            temp_string_copy = parson_strdup(temp_string);
+            if (temp_string_copy == NULL) {
+                return NULL;
+            }
+            return_value = json_value_init_string_no_copy(temp_string_copy);
+            if (return_value == NULL) {
+                parson_free_string(temp_string_copy);
+            }
+            return return_value;
+        case JSONNull:
+            return json_value_init_null();
+        case JSONError:
+            return NULL;
+        default:
+            return NULL;
+    }
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialization_options_init_legacy
+** 功能描述: 生成没有 _with_options 后缀的序列化接口所使用的序列化选项，其中是否转义 '/' 字符由全局设置
+**         : json_set_escape_slashes 决定
+** 输	 入: options - 需要初始化的序列化选项
+**         : pretty - 格式化选项，为 NULL 时不添加格式化空白字符
+** 输	 出: 
+** 全局变量: parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+static void json_serialization_options_init_legacy(JSON_Serialization_Options *options, const JSON_Pretty_Options *pretty) {
+    *options = parson_default_options;
+    options->escape_slashes = parson_escape_slashes;
+    options->pretty = pretty;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialization_size_internal
+** 功能描述: 计算对指定的“树形结构” JSON 数据按照指定的序列化选项“序列化”后的字符串所占用的内存空间大小
+** 输	 入: value - 需要被转换的“树形结构” JSON 数据
+**         : options - 序列化选项
+** 输	 出: size_t - 序列化后所需要的内存空间大小，失败时返回 0
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static size_t json_serialization_size_internal(const JSON_Value *value, const JSON_Serialization_Options *options) {
+    JSON_Serializer ser; /* recursively allocating buffers on stack is a bad idea, so let's do it only once */
+    JSON_Output out;
+    json_output_init(&out, NULL, 0, 0);
+    if (json_serializer_init(&ser, &out, options) == JSONFailure ||
+        json_serialize_to_buffer_r(value, &ser, 0) == JSONFailure) {
+        return 0;
+    }
+    return out.length + 1;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_buffer_internal
+** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据按照指定的序列化选项转换成与其对应的“序列化”格式的
+**         : 字符串数据并把转换后的结果存储到我们指定的缓存空间中
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : buf - 用来存储转换后的、“序列化”格式的字符串缓冲区
+**         : buf_size_in_bytes - 用来存储“序列化”字符串的缓冲区空间大小
+**         : options - 序列化选项
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status json_serialize_to_buffer_internal(const JSON_Value *value, char *buf, size_t buf_size_in_bytes,
+                                                     const JSON_Serialization_Options *options) {
+    JSON_Serializer ser;
+    JSON_Output out;
+    if (buf == NULL || buf_size_in_bytes == 0) {
+        return JSONFailure;
+    }
+    json_output_init(&out, buf, buf_size_in_bytes - 1, 0);
+    if (json_serializer_init(&ser, &out, options) == JSONFailure ||
+        json_serialize_to_buffer_r(value, &ser, 0) == JSONFailure) {
+        return JSONFailure;
+    }
+    return json_output_finish(&out);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_string_internal
+** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据按照指定的序列化选项转换成与其对应的“序列化”格式的
+**         : 字符串数据，并返回动态分配的字符串地址
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : options - 序列化选项
+** 输	 出: string - 序列化后字符串指针
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static char * json_serialize_to_string_internal(const JSON_Value *value, const JSON_Serialization_Options *options) {
+    JSON_Serializer ser;
+    JSON_Output out;
+    size_t size = 0;
+    char *buf = NULL;
+    if (!options->canonical && options->pretty == NULL && !options->ascii_only &&
+        options->float_precision == MAX_FLOAT_PRECISION) {
+        /* the size of compact output is cached, so allocate the exact size once */
+        size = json_serialization_size_internal(value, options);
+        if (size == 0) {
+            return NULL;
+        }
+        buf = (char*)parson_malloc(size);
+        if (buf == NULL) {
+            return NULL;
+        }
+        if (json_serialize_to_buffer_internal(value, buf, size, options) == JSONFailure) {
+            parson_free(buf);
+            return NULL;
+        }
+        return buf;
+    }
+    json_output_init(&out, NULL, 0, 1);
+    if (json_serializer_init(&ser, &out, options) == JSONFailure ||
+        json_serialize_to_buffer_r(value, &ser, 0) == JSONFailure ||
+        json_output_finish(&out) == JSONFailure) {
+        parson_free(out.data);
+        return NULL;
+    }
+    return out.data;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_file_internal
+** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据按照指定的序列化选项转换成与其对应的“序列化”格式的
+**         : 字符串数据并把转换后的结果存储到我们指定的文件中
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : filename - 用来存储转换后的、“序列化”格式的字符串文件名
+**         : options - 序列化选项
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static JSON_Status json_serialize_to_file_internal(const JSON_Value *value, const char *filename,
+                                                   const JSON_Serialization_Options *options) {
+    JSON_Status return_code = JSONSuccess;
+    FILE *fp = NULL;
+    char *serialized_string = json_serialize_to_string_internal(value, options);
+    if (serialized_string == NULL) {
+        return JSONFailure;
+    }
+    fp = fopen(filename, "w");
+    if (fp == NULL) {
+        json_free_serialized_string(serialized_string);
+        return JSONFailure;
+    }
+    if (fputs(serialized_string, fp) == EOF) {
+        return_code = JSONFailure;
+    }
+    if (fclose(fp) == EOF) {
+        return_code = JSONFailure;
+    }
+    json_free_serialized_string(serialized_string);
+    return return_code;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialization_size
+** 功能描述: 计算对指定的“树形结构” JSON 数据“序列化”后的字符串所占用的内存空间大小
+** 注     释: 这个接口计算的是没有添加格式化空格来提高可阅读性时所占用的内存空间大小
+** 输	 入: value - 需要被转换的“树形结构” JSON 数据
+** 输	 出: size_t - 序列化后所需要的内存空间大小
+** 全局变量: parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_serialization_size(const JSON_Value *value) {
+    JSON_Serialization_Options options;
+    json_serialization_options_init_legacy(&options, NULL);
+    return json_serialization_size_internal(value, &options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_buffer
+** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据并把转换后的
+**         : 结果存储到我们指定的缓存空间中
+** 注     释: 这个转换接口没有添加格式化空格来提高可阅读性，所以占用空间比较少
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : buf - 用来存储转换后的、“序列化”格式的字符串缓冲区
+** 输	 出: buf_size_in_bytes - 用来存储“序列化”字符串的缓冲区空间大小
+** 全局变量: parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_serialize_to_buffer(const JSON_Value *value, char *buf, size_t buf_size_in_bytes) {
+    JSON_Serialization_Options options;
+    json_serialization_options_init_legacy(&options, NULL);
+    return json_serialize_to_buffer_internal(value, buf, buf_size_in_bytes, &options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_file
+** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据并把转换后的
+**         : 结果存储到我们指定的文件中
+** 注     释: 这个转换接口没有添加格式化空格来提高可阅读性，所以占用空间比较少
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : filename - 用来存储转换后的、“序列化”格式的字符串文件名
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_serialize_to_file(const JSON_Value *value, const char *filename) {
+    JSON_Serialization_Options options;
+    json_serialization_options_init_legacy(&options, NULL);
+    return json_serialize_to_file_internal(value, filename, &options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_string
+** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据，并返回字
+**         : 符串地址
+** 注     释: 这个转换接口没有添加格式化空格来提高可阅读性，所以占用空间比较少
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+** 输	 出: string - 序列化后字符串指针
+** 全局变量: parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+char * json_serialize_to_string(const JSON_Value *value) {
+    JSON_Serialization_Options options;
+    json_serialization_options_init_legacy(&options, NULL);
+    return json_serialize_to_string_internal(value, &options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialization_size_pretty
+** 功能描述: 计算如果把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据
+**         : 并在“序列化”后的字符串中是否需要添加格式化空格所需要的缓冲区空间大小
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+** 输	 出: size_t - 我们序列化指定“树形结构” JSON 数据需要的缓冲区空间大小
+** 全局变量: parson_default_pretty, parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_serialization_size_pretty(const JSON_Value *value) {
+    JSON_Serialization_Options options;
+    json_serialization_options_init_legacy(&options, &parson_default_pretty);
+    return json_serialization_size_internal(value, &options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_buffer_pretty
+** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据，并在
+**         : “序列化”字符串时添加格式化空格来提高可阅读性，然后把转换后的结果存储到我们指定的缓存空间中
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : buf - 用来存储转换后的、“序列化”格式的字符串缓冲区
+**         : buf 缓冲区长度
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: parson_default_pretty, parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_serialize_to_buffer_pretty(const JSON_Value *value, char *buf, size_t buf_size_in_bytes) {
+    JSON_Serialization_Options options;
+    json_serialization_options_init_legacy(&options, &parson_default_pretty);
+    return json_serialize_to_buffer_internal(value, buf, buf_size_in_bytes, &options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_file_pretty
+** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据，并在
+**         : “序列化”字符串时添加格式化空格来提高可阅读性，然后把转换后的结果存储到我们指定的文件中
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : filename - 存储“序列化” JSON 的文件名
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: parson_default_pretty, parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_serialize_to_file_pretty(const JSON_Value *value, const char *filename) {
+    JSON_Serialization_Options options;
+    json_serialization_options_init_legacy(&options, &parson_default_pretty);
+    return json_serialize_to_file_internal(value, filename, &options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_string_pretty
+** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据，并在
+**         : “序列化”字符串时添加格式化空格来提高可阅读性，然后把转换后的结果存储到我们动态分配的内存
+**         : 空间中并返回内存首地址（即字符串地址）
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+** 输	 出: string - 序列化后字符串地址
+** 全局变量: parson_default_pretty, parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+char * json_serialize_to_string_pretty(const JSON_Value *value) {
+    JSON_Serialization_Options options;
+    json_serialization_options_init_legacy(&options, &parson_default_pretty);
+    return json_serialize_to_string_internal(value, &options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_pretty_options_init
+** 功能描述: 使用默认的格式化选项（4 个空格缩进、"\n" 换行、": " 分隔“键值对”）初始化指定的格式化选项
+** 输	 入: options - 需要初始化的格式化选项
+** 输	 出: 
+** 全局变量: parson_default_pretty
+** 调用模块: 
+*********************************************************************************************************/
+void json_pretty_options_init(JSON_Pretty_Options *options) {
+    if (options != NULL) {
+        *options = parson_default_pretty;
+    }
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialization_size_pretty_with_options
+** 功能描述: 计算按照指定的序列化选项“序列化”指定的“树形结构” JSON 数据所需要的缓冲区空间大小
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : options - 格式化选项
+** 输	 出: size_t - 所需要的缓冲区空间大小，失败时返回 0
+** 全局变量: parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_serialization_size_pretty_with_options(const JSON_Value *value, const JSON_Pretty_Options *options) {
+    JSON_Serialization_Options serialization_options;
+    if (options == NULL) {
+        return 0;
+    }
+    json_serialization_options_init_legacy(&serialization_options, options);
+    return json_serialization_size_internal(value, &serialization_options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_buffer_pretty_with_options
+** 功能描述: 按照指定的序列化选项“序列化”指定的“树形结构” JSON 数据，并把结果存储到我们指定的缓存空间中
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : buf - 用来存储转换后的、“序列化”格式的字符串缓冲区
+**         : buf_size_in_bytes - buf 缓冲区长度
+**         : options - 格式化选项
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_serialize_to_buffer_pretty_with_options(const JSON_Value *value, char *buf, size_t buf_size_in_bytes,
+                                                         const JSON_Pretty_Options *options) {
+    JSON_Serialization_Options serialization_options;
+    if (options == NULL) {
+        return JSONFailure;
+    }
+    json_serialization_options_init_legacy(&serialization_options, options);
+    return json_serialize_to_buffer_internal(value, buf, buf_size_in_bytes, &serialization_options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_file_pretty_with_options
+** 功能描述: 按照指定的序列化选项“序列化”指定的“树形结构” JSON 数据，并把结果存储到我们指定的文件中
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : filename - 存储“序列化” JSON 的文件名
+**         : options - 格式化选项
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_serialize_to_file_pretty_with_options(const JSON_Value *value, const char *filename,
+                                                       const JSON_Pretty_Options *options) {
+    JSON_Serialization_Options serialization_options;
+    if (options == NULL) {
+        return JSONFailure;
+    }
+    json_serialization_options_init_legacy(&serialization_options, options);
+    return json_serialize_to_file_internal(value, filename, &serialization_options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_string_pretty_with_options
+** 功能描述: 按照指定的序列化选项“序列化”指定的“树形结构” JSON 数据，并返回动态分配的字符串地址
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : options - 格式化选项
+** 输	 出: string - 序列化后字符串地址，失败时返回 NULL
+** 全局变量: parson_escape_slashes
+** 调用模块: 
+*********************************************************************************************************/
+char * json_serialize_to_string_pretty_with_options(const JSON_Value *value, const JSON_Pretty_Options *options) {
+    JSON_Serialization_Options serialization_options;
+    if (options == NULL) {
+        return NULL;
+    }
+    json_serialization_options_init_legacy(&serialization_options, options);
+    return json_serialize_to_string_internal(value, &serialization_options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialization_options_init
+** 功能描述: 使用默认的序列化选项（转义 '/' 字符、不转义非 ASCII 字符、17 位有效数字、不排序、不格式化）
+**         : 初始化指定的序列化选项
+** 注     释: 默认选项与全局设置 json_set_escape_slashes 无关
+** 输	 入: options - 需要初始化的序列化选项
+** 输	 出: 
+** 全局变量: parson_default_options
+** 调用模块: 
+*********************************************************************************************************/
+void json_serialization_options_init(JSON_Serialization_Options *options) {
+    if (options != NULL) {
+        *options = parson_default_options;
+    }
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialization_size_with_options
+** 功能描述: 计算按照指定的序列化选项“序列化”指定的“树形结构” JSON 数据所需要的缓冲区空间大小
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : options - 序列化选项
+** 输	 出: size_t - 所需要的缓冲区空间大小，失败时返回 0
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_serialization_size_with_options(const JSON_Value *value, const JSON_Serialization_Options *options) {
+    if (options == NULL) {
+        return 0;
+    }
+    return json_serialization_size_internal(value, options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_buffer_with_options
+** 功能描述: 按照指定的序列化选项“序列化”指定的“树形结构” JSON 数据，并把结果存储到我们指定的缓存空间中
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : buf - 用来存储转换后的、“序列化”格式的字符串缓冲区
+**         : buf_size_in_bytes - buf 缓冲区长度
+**         : options - 序列化选项
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_serialize_to_buffer_with_options(const JSON_Value *value, char *buf, size_t buf_size_in_bytes,
+                                                  const JSON_Serialization_Options *options) {
+    if (options == NULL) {
+        return JSONFailure;
+    }
+    return json_serialize_to_buffer_internal(value, buf, buf_size_in_bytes, options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_file_with_options
+** 功能描述: 按照指定的序列化选项“序列化”指定的“树形结构” JSON 数据，并把结果存储到我们指定的文件中
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : filename - 存储“序列化” JSON 的文件名
+**         : options - 序列化选项
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_serialize_to_file_with_options(const JSON_Value *value, const char *filename,
+                                                const JSON_Serialization_Options *options) {
+    if (options == NULL) {
+        return JSONFailure;
+    }
+    return json_serialize_to_file_internal(value, filename, options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_serialize_to_string_with_options
+** 功能描述: 按照指定的序列化选项“序列化”指定的“树形结构” JSON 数据，并返回动态分配的字符串地址
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+**         : options - 序列化选项
+** 输	 出: string - 序列化后字符串地址，失败时返回 NULL
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+char * json_serialize_to_string_with_options(const JSON_Value *value, const JSON_Serialization_Options *options) {
+    if (options == NULL) {
+        return NULL;
+    }
+    return json_serialize_to_string_internal(value, options);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_get_boolean
-** 功能描述: 在指定的 JSON object 中，通过 JSONBoolean 类型变量的“键值对”中的“键”标识符获取与其对应的“值”
-**         : 标识符的内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “键值对”的“键”标识符
-** 输	 出: JSONBoolean - 读取到的 JSONBoolean 类型 boolean 变量值
-**		   : -1 - 读取失败
+** 函数名称: json_serialize_to_string_canonical
+** 功能描述: 把指定的“树形结构” JSON 数据转换成 RFC 8785（JCS）规定的规范格式字符串，并返回动态分配的字符串
+**         : 地址，常用于计算 JSON 数据的摘要或者签名
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+** 输	 出: string - 序列化后字符串地址，失败时返回 NULL
+** 全局变量: parson_default_options
+** 调用模块: 
+*********************************************************************************************************/
+char * json_serialize_to_string_canonical(const JSON_Value *value) {
+    JSON_Serialization_Options options = parson_default_options;
+    options.canonical = 1;
+    return json_serialize_to_string_internal(value, &options);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_free_serialized_string
+** 功能描述: 释放指定的“序列化” JSON 字符串数据所占用的内存空间
+** 输	 入: string - 需要释放的“序列化” JSON 字符串数据
+** 输	 出: 
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-int json_object_get_boolean(const JSON_Object *object, const char *name) {
-    return json_value_get_boolean(json_object_get_value(object, name));
+void json_free_serialized_string(char *string) {
+    parson_free(string);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_dotget_value
-** 功能描述: 在指定的 JSON object 中，通过“点”描述法获取对应路径位置上的 JSON_Value 变量
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “点”描述法的 JSON_Value 变量路径
-** 输	 出: JSON_Value - 读取到的 JSON_Value 变量
-**		   : NULL - 读取失败
+** 函数名称: json_value_set_serialization_cache
+** 功能描述: 打开或者关闭指定 JSON_Value 及其当前包含的所有 JSON object 和 JSON array 的序列化结果缓存
+** 注     释: 打开缓存后，紧凑格式序列化时会保存每个容器的序列化结果，内容没有变化的容器在下次序列化时直接
+**         : 复制保存的结果，关闭缓存时释放已经保存的结果
+** 输	 入: value - 我们要操作的 JSON_Value 变量
+**         : enabled - 是否打开序列化结果缓存
+** 输	 出: JSON_Status - 操作状态
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_object_dotget_value(const JSON_Object *object, const char *name) {
-    const char *dot_position = strchr(name, '.');
-    if (!dot_position) {
-        return json_object_get_value(object, name);
+JSON_Status json_value_set_serialization_cache(JSON_Value *value, int enabled) {
+    JSON_Serialization_Cache *cache = json_value_get_cache(value);
+    JSON_Object *object = NULL;
+    JSON_Array *array = NULL;
+    size_t i = 0;
+    if (cache == NULL || IS_FROZEN(value)) {
+        return JSONFailure;
     }
-    object = json_value_get_object(json_object_getn_value(object, name, dot_position - name));
-    return json_object_dotget_value(object, dot_position + 1);
+    cache->fragment_enabled = enabled ? 1 : 0;
+    if (!enabled) {
+        parson_free(cache->fragment);
+        cache->fragment = NULL;
+    }
+    if (json_value_get_type(value) == JSONObject) {
+        object = json_value_get_object(value);
+        for (i = 0; i < json_object_get_count(object); i++) {
+            json_value_set_serialization_cache(object->values[i], enabled);
+        }
+    } else {
+        array = json_value_get_array(value);
+        for (i = 0; i < json_array_get_count(array); i++) {
+            json_value_set_serialization_cache(array->items[i], enabled);
+        }
+    }
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_dotget_string
-** 功能描述: 在指定的 JSON object 中，通过 JSONString 类型变量的“点”描述法获取对应路径位置上的 JSON_Value 变量
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “点”描述法的 JSON_Value 变量路径
-** 输	 出: string - 读取到的 JSONString 类型 string 变量值
-**		   : NULL - 读取失败
+** 函数名称: json_value_freeze
+** 功能描述: 冻结指定的 JSON 数据，冻结之后多个线程可以不加锁地同时读取它
+** 注     释: 冻结时会生成所有的内部索引和缓存（紧凑格式序列化长度、JSON object 的排序索引，以及打开了序列化结果
+**         : 缓存时的序列化结果），冻结之后的读取（包括序列化）不会再修改任何数据，所有修改操作都返回 JSONFailure
+**         : 冻结是单向操作，冻结之后调用者持有一个引用，已经冻结的共享子树保持不变
+** 输	 入: value - 我们要冻结的 JSON 数据，必须是根节点
+** 输	 出: JSON_Status - 执行状态
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-const char * json_object_dotget_string(const JSON_Object *object, const char *name) {
-    return json_value_get_string(json_object_dotget_value(object, name));
+JSON_Status json_value_freeze(JSON_Value *value) {
+    JSON_Serialization_Options options;
+    JSON_Serialization_Cache *cache = json_value_get_cache(value);
+    char *serialized = NULL;
+    if (value == NULL || VALUE_PARENT(value) != NULL) {
+        return JSONFailure;
+    }
+    if (IS_FROZEN(value)) {
+        return JSONSuccess;
+    }
+    json_serialization_options_init_legacy(&options, NULL);
+    if (json_value_freeze_r(value, 0) == JSONFailure || json_serialization_size_internal(value, &options) == 0) {
+        return JSONFailure;
+    }
+    if (cache != NULL && cache->fragment_enabled) {
+        serialized = json_serialize_to_string_internal(value, &options);
+        if (serialized == NULL) {
+            return JSONFailure;
+        }
+        parson_free(serialized);
+    }
+    json_value_freeze_r(value, 1);
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_dotget_number
-** 功能描述: 在指定的 JSON object 中，通过 JSONNumber 类型变量的“点”描述法获取对应路径位置上的 JSON_Value 变量
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “点”描述法的 JSON_Value 变量路径
-** 输	 出: double - 读取到的 JSONNumber 类型 number 变量值
-**		   : 0 - 读取失败
+** 函数名称: json_value_is_frozen
+** 功能描述: 判断指定的 JSON_Value 是否已经被冻结
+** 输	 入: value - 我们要判断的 JSON_Value
+** 输	 出: 1 - 已经冻结
+**         : 0 - 没有冻结或者 value 为 NULL
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-double json_object_dotget_number(const JSON_Object *object, const char *name) {
-    return json_value_get_number(json_object_dotget_value(object, name));
+int json_value_is_frozen(const JSON_Value *value) {
+    return value ? IS_FROZEN(value) : 0;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_dotget_object
-** 功能描述: 在指定的 JSON object 中，通过 JSONObject 类型变量的“点”描述法获取对应路径位置上的 JSON_Value 变量
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “点”描述法的 JSON_Value 变量路径
-** 输	 出: JSON_Object - 读取到的 JSONObject 类型 object 变量值
-**		   : NULL - 读取失败
+** 函数名称: json_value_share
+** 功能描述: 获取指定 JSON_Value 的一个新的共享引用，没有冻结的 JSON_Value 会先被冻结
+** 注     释: 返回的引用可以添加到任意 JSON object 或者 JSON array 中（转移所有权），或者用 json_value_free 释放，
+**         : 引用计数使用原子操作修改，不同的线程可以同时创建和释放共享同一个子树的文档
+** 输	 入: value - 我们要共享的 JSON_Value，没有冻结时必须是根节点
+** 输	 出: JSON_Value - value 本身（多了一个引用）
+**         : NULL - value 不能被冻结
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Object * json_object_dotget_object(const JSON_Object *object, const char *name) {
-    return json_value_get_object(json_object_dotget_value(object, name));
+JSON_Value * json_value_share(JSON_Value *value) {
+    if (value == NULL || (!IS_FROZEN(value) && json_value_freeze(value) == JSONFailure)) {
+        return NULL;
+    }
+    ATOMIC_ADD_INT(&value->refcount, 1);
+    return value;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_dotget_array
-** 功能描述: 在指定的 JSON object 中，通过 JSONArray 类型变量的“点”描述法获取对应路径位置上的 JSON_Value 变量
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “点”描述法的 JSON_Value 变量路径
-** 输	 出: JSON_Array - 读取到的 JSONArray 类型 array 变量值
-**		   : NULL - 读取失败
+** 函数名称: json_object_unshare_value
+** 功能描述: 获取指定 JSON object 中指定“键”标识符对应的成员，如果成员是共享的，先把它替换成私有的副本
+** 注     释: 副本只复制一层，它的成员仍然是共享的，需要修改更深的成员时逐层调用或者使用 dotset 系列函数
+** 输	 入: object - 我们要操作的 JSON object，不能是冻结的
+**         : name - “键值对”的“键”标识符
+** 输	 出: JSON_Value - 可以修改的成员
+**         : NULL - 没有找到对应的成员、object 已经冻结或者内存不足
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Array * json_object_dotget_array(const JSON_Object *object, const char *name) {
-    return json_value_get_array(json_object_dotget_value(object, name));
+JSON_Value * json_object_unshare_value(JSON_Object *object, const char *name) {
+    if (object == NULL || name == NULL || IS_FROZEN(object->wrapping_value)) {
+        return NULL;
+    }
+    return json_object_unsharen_value(object, name, strlen(name));
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_dotget_boolean
-** 功能描述: 在指定的 JSON object 中，通过 JSONBoolean 类型变量的“点”描述法获取对应路径位置上的 JSON_Value 变量
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “点”描述法的 JSON_Value 变量路径
-** 输	 出: JSONBoolean - 读取到的 JSONBoolean 类型 boolean 变量值
-**		   : -1 - 读取失败
+** 函数名称: json_array_unshare_value
+** 功能描述: 获取指定 JSON array 中指定索引的成员，如果成员是共享的，先把它替换成私有的副本
+** 输	 入: array - 我们要操作的 JSON array，不能是冻结的
+**         : index - 成员的索引值
+** 输	 出: JSON_Value - 可以修改的成员
+**         : NULL - 索引越界、array 已经冻结或者内存不足
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-int json_object_dotget_boolean(const JSON_Object *object, const char *name) {
-    return json_value_get_boolean(json_object_dotget_value(object, name));
+JSON_Value * json_array_unshare_value(JSON_Array *array, size_t index) {
+    if (array == NULL || IS_FROZEN(array->wrapping_value) || index >= json_array_get_count(array)) {
+        return NULL;
+    }
+    return json_value_unshare(&array->items[index], array->wrapping_value);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_get_count
-** 功能描述: 获取指定 JSON object 中已经存储的“键值对”个数
-** 输	 入: object - 我们要操作的 JSON object 对象
-** 输	 出: size_t - “键值对”个数
+** 函数名称: json_value_with
+** 功能描述: 创建指定 JSON 数据的一个新版本，新版本中“点表示法”路径指定的成员被设置成指定的内容
+** 注     释: 原来的版本会被冻结并保持不变，新版本和它共享所有没有修改的子树，只复制路径上的 JSON object，
+**         : 新版本没有冻结，可以继续修改，用它创建下一个版本时才会被冻结
+** 输	 入: root - 原来的版本，必须是 JSON object 类型的根节点
+**         : path - “点表示法”表示的成员路径
+**         : value - 成员的新内容，成功时所有权转移给新版本
+** 输	 出: JSON_Value - 新的版本
+**         : NULL - 参数不合法或者内存不足，这时 value 的所有权不变
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-size_t json_object_get_count(const JSON_Object *object) {
-    return object ? object->count : 0;
+JSON_Value * json_value_with(JSON_Value *root, const char *path, JSON_Value *value) {
+    JSON_Value *new_root = NULL;
+    if (json_value_get_type(root) != JSONObject || path == NULL || value == NULL ||
+        json_value_freeze(root) == JSONFailure) {
+        return NULL;
+    }
+    new_root = json_value_copy_shared(root);
+    if (new_root == NULL) {
+        return NULL;
+    }
+    if (json_object_dotset_value(json_value_get_object(new_root), path, value) == JSONFailure) {
+        json_value_free(new_root);
+        return NULL;
+    }
+    return new_root;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_get_name
-** 功能描述: 获取指定 JSON object 中指定索引位置的“键值对”的“键”标识符内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : index - “键”标识符索引值
-** 输	 出: string - “键”标识符内容
+** 函数名称: json_value_without
+** 功能描述: 创建指定 JSON 数据的一个新版本，新版本中删除了“点表示法”路径指定的成员
+** 注     释: 和 json_value_with 一样，原来的版本被冻结并和新版本共享所有没有修改的子树
+** 输	 入: root - 原来的版本，必须是 JSON object 类型的根节点
+**         : path - “点表示法”表示的成员路径
+** 输	 出: JSON_Value - 新的版本
+**         : NULL - 参数不合法、成员不存在或者内存不足
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-const char * json_object_get_name(const JSON_Object *object, size_t index) {
-    if (object == NULL || index >= json_object_get_count(object)) {
+JSON_Value * json_value_without(JSON_Value *root, const char *path) {
+    JSON_Value *new_root = NULL;
+    if (json_value_get_type(root) != JSONObject || path == NULL || json_value_freeze(root) == JSONFailure ||
+        json_object_dotget_value(json_value_get_object(root), path) == NULL) {
         return NULL;
     }
-    return object->names[index];
+    new_root = json_value_copy_shared(root);
+    if (new_root == NULL) {
+        return NULL;
+    }
+    if (json_object_dotremove(json_value_get_object(new_root), path) == JSONFailure) {
+        json_value_free(new_root);
+        return NULL;
+    }
+    return new_root;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_get_value_at
-** 功能描述: 获取指定 JSON object 中指定索引位置的“键值对”的“值”标识符内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : index - “值”标识符索引值
-** 输	 出: string - “值”标识符内容
+** 函数名称: json_publisher_count_readers
+** 功能描述: 统计指定发布器在指定 epoch 中正在读取的读者个数
+** 输	 入: publisher - 我们要查询的发布器
+**         : epoch - 我们要统计的 epoch（0 或 1）
+** 输	 出: long - 读者个数
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_object_get_value_at(const JSON_Object *object, size_t index) {
-    if (object == NULL || index >= json_object_get_count(object)) {
+static long json_publisher_count_readers(JSON_Publisher *publisher, long epoch) {
+    long count = 0;
+    size_t i = 0;
+    for (i = 0; i < PUBLISHER_STRIPES; i++) {
+        count += ATOMIC_LOAD_LONG(&publisher->readers[epoch][i].count);
+    }
+    return count;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_publisher_stripe
+** 功能描述: 为当前线程选择一个读者计数器，不同线程的栈地址不同，所以通常会选到不同的计数器（缓存行）
+** 输	 入: 
+** 输	 出: size_t - 读者计数器序号
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+static size_t json_publisher_stripe(void) {
+    char marker = 0;
+    size_t hash = ((size_t)&marker >> 12) & 0xFFFFFFFFUL;
+    hash = (hash * 2654435761UL) & 0xFFFFFFFFUL;
+    return (hash >> 24) % PUBLISHER_STRIPES;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_publisher_init
+** 功能描述: 创建一个用来发布冻结的 JSON 数据根节点的发布器，读者不需要加锁就可以读取当前发布的根节点
+** 注     释: 编译器不支持原子操作时返回 NULL
+** 输	 入: root - 初始发布的根节点，会被冻结，可以为 NULL，之后由发布器负责释放
+** 输	 出: JSON_Publisher * - 创建的发布器
+**         : NULL - 创建失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Publisher * json_publisher_init(JSON_Value *root) {
+    JSON_Publisher *publisher = NULL;
+    if (!PARSON_HAS_ATOMICS || (root != NULL && json_value_freeze(root) == JSONFailure)) {
         return NULL;
     }
-    return object->values[index];
+    publisher = (JSON_Publisher*)parson_malloc(sizeof(JSON_Publisher));
+    if (publisher == NULL) {
+        return NULL;
+    }
+    memset(publisher, 0, sizeof(JSON_Publisher));
+    publisher->root = root; /* not shared with readers yet */
+    return publisher;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_get_wrapping_value
-** 功能描述: 获取指定 JSON object 所属的 JSON_Value 的指针
-** 输	 入: object - 我们要操作的 JSON object 对象
-** 输	 出: JSON_Value - 指定 JSON object 所属的 JSON_Value 的指针
+** 函数名称: json_publisher_free
+** 功能描述: 释放指定的发布器、当前发布的根节点以及所有等待释放的根节点
+** 注     释: 调用时不能有读者正在读取
+** 输	 入: publisher - 我们要释放的发布器
+** 输	 出: 
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value *json_object_get_wrapping_value(const JSON_Object *object) {
-    return object->wrapping_value;
+void json_publisher_free(JSON_Publisher *publisher) {
+    size_t epoch = 0, i = 0;
+    if (publisher == NULL) {
+        return;
+    }
+    json_value_free(publisher->root);
+    for (epoch = 0; epoch < 2; epoch++) {
+        for (i = 0; i < publisher->retired_count[epoch]; i++) {
+            json_value_free(publisher->retired[epoch][i]);
+        }
+        parson_free(publisher->retired[epoch]);
+    }
+    parson_free(publisher);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_has_value
-** 功能描述: 判断指定的 JSON object 中是否存在指定“键”标识符的“键值对”数据内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “键值对”的“键”标识符
-** 输	 出: 1 - “键值对”数据存在
-**         : 0 - “键值对”数据不存在
+** 函数名称: json_publisher_publish
+** 功能描述: 冻结指定的根节点并通过原子操作替换当前发布的根节点，被替换的根节点在没有读者使用之后释放
+** 注     释: 被替换的根节点加入当前 epoch 的待释放列表，然后调用 json_publisher_reclaim 释放已经没有读者使用的
+**         : 根节点，这个函数不会等待读者
+** 输	 入: publisher - 我们要操作的发布器
+**         : root - 新的根节点，成功后由发布器负责释放
+** 输	 出: JSON_Status - 执行状态
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-int json_object_has_value (const JSON_Object *object, const char *name) {
-    return json_object_get_value(object, name) != NULL;
+JSON_Status json_publisher_publish(JSON_Publisher *publisher, JSON_Value *root) {
+    JSON_Value **new_retired = NULL, *old_root = NULL;
+    long epoch = 0;
+    size_t new_capacity = 0;
+    if (publisher == NULL || root == NULL || root == publisher->root || json_value_freeze(root) == JSONFailure) {
+        return JSONFailure;
+    }
+    epoch = ATOMIC_LOAD_LONG(&publisher->epoch);
+    if (publisher->retired_count[epoch] == publisher->retired_capacity[epoch]) {
+        new_capacity = MAX(publisher->retired_capacity[epoch] * 2, PUBLISHER_RETIRED_CAPACITY);
+        new_retired = (JSON_Value**)parson_malloc(new_capacity * sizeof(JSON_Value*));
+        if (new_retired == NULL) {
+            return JSONFailure;
+        }
+        if (publisher->retired_count[epoch] > 0) {
+            memcpy(new_retired, publisher->retired[epoch], publisher->retired_count[epoch] * sizeof(JSON_Value*));
+        }
+        parson_free(publisher->retired[epoch]);
+        publisher->retired[epoch] = new_retired;
+        publisher->retired_capacity[epoch] = new_capacity;
+    }
+    old_root = (JSON_Value*)ATOMIC_EXCHANGE_PTR(&publisher->root, root);
+    if (old_root != NULL) {
+        publisher->retired[epoch][publisher->retired_count[epoch]++] = old_root;
+    }
+    json_publisher_reclaim(publisher);
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_has_value_of_type
-** 功能描述: 判断指定的 JSON object 中是否存在指定“键”标识符及 JSON_Value_Type 的“键值对”数据内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “键值对”的“键”标识符
-**         : type - “键值对”的“值”标识符数据类型
-** 输	 出: 1 - “键值对”数据及类型存在
-**         : 0 - “键值对”数据及类型不存在
+** 函数名称: json_publisher_reclaim
+** 功能描述: 释放指定发布器中已经没有读者使用的、被替换下来的根节点，不会等待读者
+** 注     释: 在 epoch e 中被替换的根节点只可能被 epoch e 和更早的读者使用。上一个 epoch 的读者全部结束后，释放
+**         : 上一个 epoch 的待释放列表，当前 epoch 有待释放的根节点时切换到另一个 epoch，之后新的读者只能读到
+**         : 新的根节点，等原来 epoch 的读者全部结束后就可以释放这些根节点
+** 输	 入: publisher - 我们要操作的发布器
+** 输	 出: size_t - 还在等待释放的根节点个数
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-int json_object_has_value_of_type(const JSON_Object *object, const char *name, JSON_Value_Type type) {
-    JSON_Value *val = json_object_get_value(object, name);
-    return val != NULL && json_value_get_type(val) == type;
+size_t json_publisher_reclaim(JSON_Publisher *publisher) {
+    long epoch = 0, previous = 0, round = 0;
+    size_t i = 0;
+    if (publisher == NULL) {
+        return 0;
+    }
+    for (round = 0; round < 2; round++) {
+        epoch = ATOMIC_LOAD_LONG(&publisher->epoch);
+        previous = 1 - epoch;
+        if (json_publisher_count_readers(publisher, previous) != 0) {
+            break;
+        }
+        for (i = 0; i < publisher->retired_count[previous]; i++) {
+            json_value_free(publisher->retired[previous][i]);
+        }
+        publisher->retired_count[previous] = 0;
+        if (publisher->retired_count[epoch] == 0) {
+            break;
+        }
+        ATOMIC_STORE_LONG(&publisher->epoch, previous); /* readers of the old roots are now all in epoch */
+    }
+    return publisher->retired_count[0] + publisher->retired_count[1];
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_has_value_of_type
-** 功能描述: 判断指定的 JSON object 中是否存在“点”描述法指定的“键值对”数据内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “点”描述法的 JSON_Value 变量路径
-** 输	 出: JSON_Value - 读取到的 JSON_Value 变量
-**		   : NULL - 读取失败
+** 函数名称: json_publisher_acquire
+** 功能描述: 读者开始读取，返回当前发布的根节点，读取完成后需要用返回的 token 调用 json_publisher_release
+** 注     释: 先在当前 epoch 的读者计数器上加一，再确认 epoch 没有被切换，这样发布者看到计数器为 0 时，不会有读者
+**         : 在这个 epoch 中读到被替换下来的根节点
+** 输	 入: publisher - 我们要读取的发布器
+** 输	 出: token - 传递给 json_publisher_release 的读者标识
+**         : const JSON_Value * - 当前发布的根节点，在 json_publisher_release 之前一直有效
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-int json_object_dothas_value (const JSON_Object *object, const char *name) {
-    return json_object_dotget_value(object, name) != NULL;
+const JSON_Value * json_publisher_acquire(JSON_Publisher *publisher, int *token) {
+    size_t stripe = json_publisher_stripe();
+    long epoch = 0;
+    if (publisher == NULL || token == NULL) {
+        return NULL;
+    }
+    for (;;) {
+        epoch = ATOMIC_LOAD_LONG(&publisher->epoch);
+        ATOMIC_ADD_LONG(&publisher->readers[epoch][stripe].count, 1);
+        if (ATOMIC_LOAD_LONG(&publisher->epoch) == epoch) {
+            break;
+        }
+        ATOMIC_ADD_LONG(&publisher->readers[epoch][stripe].count, -1);
+    }
+    *token = (int)(epoch | (long)(stripe << 1));
+    return (const JSON_Value*)ATOMIC_LOAD_PTR(&publisher->root);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_publisher_release
+** 功能描述: 读者结束读取，之后不能再使用 json_publisher_acquire 返回的根节点
+** 输	 入: publisher - 我们要读取的发布器
+**         : token - json_publisher_acquire 返回的读者标识
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+void json_publisher_release(JSON_Publisher *publisher, int token) {
+    if (publisher == NULL) {
+        return;
+    }
+    ATOMIC_ADD_LONG(&publisher->readers[token & 1][(token >> 1) % PUBLISHER_STRIPES].count, -1);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_reclaimer_init
+** 功能描述: 创建一个延迟释放 JSON 数据的回收器
+** 输	 入: 
+** 输	 出: JSON_Reclaimer - 新创建的回收器
+**         : NULL - 内存不足
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Reclaimer * json_reclaimer_init(void) {
+    JSON_Reclaimer *reclaimer = (JSON_Reclaimer*)parson_malloc(sizeof(JSON_Reclaimer));
+    if (reclaimer == NULL) {
+        return NULL;
+    }
+    reclaimer->incoming = NULL;
+    reclaimer->pending = NULL;
+    return reclaimer;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_reclaimer_free
+** 功能描述: 释放回收器中所有等待释放的 JSON 数据，然后释放回收器
+** 输	 入: reclaimer - 我们要释放的回收器
+** 输	 出: 
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+void json_reclaimer_free(JSON_Reclaimer *reclaimer) {
+    if (reclaimer == NULL) {
+        return;
+    }
+    json_reclaimer_step(reclaimer, (size_t)-1);
+    parson_free(reclaimer);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_value_free_deferred
+** 功能描述: 把指定的 JSON 数据交给回收器，由以后的 json_reclaimer_step 调用释放
+** 注     释: 只修改根节点的 parent 指针，执行时间和 JSON 数据的大小无关，多个线程可以同时调用。冻结的 JSON_Value
+**         : 和 json_value_free 一样只释放一个引用，还有其他引用时不交给回收器
+** 输	 入: reclaimer - 回收器
+**         : value - 我们要释放的 JSON 数据，必须是根节点
+** 输	 出: JSON_Status - 执行状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_value_free_deferred(JSON_Reclaimer *reclaimer, JSON_Value *value) {
+#ifdef PARSON_NO_PARENT
+    JSON_Reclaim_Link *head = NULL, *link = NULL;
+    if (reclaimer == NULL || value == NULL) {
+        return JSONFailure;
+    }
+    link = (JSON_Reclaim_Link*)parson_pool_alloc(sizeof(JSON_Reclaim_Link));
+    if (link == NULL) {
+        return JSONFailure;
+    }
+    if (IS_FROZEN(value) && ATOMIC_ADD_INT(&value->refcount, -1) != 0) {
+        parson_pool_free(link, sizeof(JSON_Reclaim_Link));
+        return JSONSuccess; /* still shared */
+    }
+    link->value = value;
+    do {
+        head = (JSON_Reclaim_Link*)ATOMIC_LOAD_PTR(&reclaimer->incoming);
+        link->next = head;
+    } while (!ATOMIC_CAS_PTR(&reclaimer->incoming, head, link));
+#else
+    JSON_Value *head = NULL;
+    if (reclaimer == NULL || value == NULL || value->parent != NULL) {
+        return JSONFailure;
+    }
+    if (IS_FROZEN(value) && ATOMIC_ADD_INT(&value->refcount, -1) != 0) {
+        return JSONSuccess; /* still shared */
+    }
+    do {
+        head = (JSON_Value*)ATOMIC_LOAD_PTR(&reclaimer->incoming);
+        value->parent = head;
+    } while (!ATOMIC_CAS_PTR(&reclaimer->incoming, head, value));
+#endif
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_object_dothas_value_of_type
-** 功能描述: 判断指定的 JSON object 中是否存在“点”描述法及 JSON_Value_Type 指定的“键值对”数据内容
-** 输	 入: object - 我们要操作的 JSON object 对象
-**         : name - “点”描述法的 JSON_Value 变量路径
-**         : type - “键值对”的“值”标识符数据类型
-** 输	 出: 1 - “键值对”数据及类型存在
-**         : 0 - “键值对”数据及类型不存在
+** 函数名称: json_reclaimer_step
+** 功能描述: 释放回收器中最多指定个数的 JSON_Value
+** 注     释: 每次取出栈顶 JSON object 或者 JSON array 的最后一个成员压入栈中，没有成员的 JSON_Value 直接释放，
+**         : 所以每释放一个 JSON_Value 的工作量是常数，不需要递归。只释放共享成员的一个引用时也算一个
+**         : JSON_Value。同一时间只能有一个线程调用
+** 输	 入: reclaimer - 回收器
+**         : max_nodes - 最多释放的 JSON_Value 个数
+** 输	 出: size_t - 释放的 JSON_Value 个数，小于 max_nodes 表示已经没有等待释放的 JSON 数据
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-int json_object_dothas_value_of_type(const JSON_Object *object, const char *name, JSON_Value_Type type) {
-    JSON_Value *val = json_object_dotget_value(object, name);
-    return val != NULL && json_value_get_type(val) == type;
+size_t json_reclaimer_step(JSON_Reclaimer *reclaimer, size_t max_nodes) {
+    JSON_Value *value = NULL, *member = NULL;
+#ifdef PARSON_NO_PARENT
+    JSON_Reclaim_Link *link = NULL;
+#endif
+    JSON_Object *object = NULL;
+    JSON_Array *array = NULL;
+    size_t freed = 0;
+    if (reclaimer == NULL) {
+        return 0;
+    }
+    while (freed < max_nodes) {
+        if (reclaimer->pending == NULL) {
+#ifdef PARSON_NO_PARENT
+            reclaimer->pending = (JSON_Reclaim_Link*)ATOMIC_EXCHANGE_PTR(&reclaimer->incoming, NULL);
+#else
+            reclaimer->pending = (JSON_Value*)ATOMIC_EXCHANGE_PTR(&reclaimer->incoming, NULL);
+#endif
+            if (reclaimer->pending == NULL) {
+                break;
+            }
+        }
+#ifdef PARSON_NO_PARENT
+        value = reclaimer->pending->value;
+#else
+        value = reclaimer->pending;
+#endif
+        member = NULL;
+        if (json_value_get_type(value) == JSONObject && json_value_get_object(value)->count > 0) {
+            object = json_value_get_object(value);
+            object->count--;
+            if (object->shape == NULL) {
+                parson_free_string(object->names[object->count]);
+            }
+            member = object->values[object->count];
+        } else if (json_value_get_type(value) == JSONArray && json_value_get_array(value)->count > 0) {
+            array = json_value_get_array(value);
+            array->count--;
+            member = array->items[array->count];
+        }
+        if (member == NULL) { /* no members left */
+#ifdef PARSON_NO_PARENT
+            link = reclaimer->pending;
+            reclaimer->pending = link->next;
+            parson_pool_free(link, sizeof(JSON_Reclaim_Link));
+#else
+            reclaimer->pending = value->parent;
+#endif
+            json_value_free(value);
+            freed++;
+        } else if (!IS_FROZEN(member) || ATOMIC_ADD_INT(&member->refcount, -1) == 0) {
+#ifdef PARSON_NO_PARENT
+            link = NULL;
+            if (json_value_get_type(member) == JSONObject || json_value_get_type(member) == JSONArray) {
+                link = (JSON_Reclaim_Link*)parson_pool_alloc(sizeof(JSON_Reclaim_Link));
+            }
+            if (link == NULL) { /* scalars, or no memory for the link */
+                json_value_free(member);
+                freed++;
+                continue;
+            }
+            link->value = member;
+            link->next = reclaimer->pending;
+            reclaimer->pending = link;
+#else
+            member->parent = value;
+            reclaimer->pending = member;
+#endif
+        } else {
+            freed++; /* released a reference to a shared value */
+        }
+    }
+    return freed;
 }
 
-/* JSON Array API */
 /*********************************************************************************************************
-** 函数名称: json_array_get_value
-** 功能描述: 获取指定的 JSON array 中指定索引位置处的 JSON_Value 成员数据内容
-** 输	 入: array - 我们要操作的 JSON array 对象
-**         : index - 数组元素索引值
-** 输	 出: JSON_Value - 读取到的数组成员
-**         : NULL - 读取失败
+** 函数名称: json_value_to_cbor
+** 功能描述: 把指定的“树形结构” JSON 数据直接编码成 CBOR（RFC 8949）格式的二进制数据
+** 注     释: 整数使用 CBOR 整数编码，字符串带长度前缀，JSON array 和 JSON object 带成员个数前缀
+** 输	 入: value - 需要编码的“树形结构” JSON 数据
+** 输	 出: size - 编码后的数据长度
+**         : unsigned char * - 编码后的数据，需要通过 json_free_cbor 释放
+**         : NULL - 编码失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_array_get_value(const JSON_Array *array, size_t index) {
-    if (array == NULL || index >= json_array_get_count(array)) {
+unsigned char * json_value_to_cbor(const JSON_Value *value, size_t *size) {
+    JSON_Output out;
+    JSON_Binary_Writer writer;
+    json_output_init(&out, NULL, 0, 1);
+    binary_writer_init(&writer, &out, NULL, NULL);
+    if (size == NULL || json_value_write_cbor_r(value, &writer) == JSONFailure) {
+        parson_free(out.data);
         return NULL;
     }
-    return array->items[index];
+    *size = out.length;
+    return (unsigned char*)out.data;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_array_get_string
-** 功能描述: 在指定的 JSON array 中，通过 JSONString 类型变量的“索引下标值”获取与其对应的内容
-** 输	 入: array - 我们要操作的 JSON array 对象
-**         : index - JSONString 类型变量的“索引下标值”
-** 输	 出: JSON_Value - 读取到的 JSONString 类型 string 变量值
-**         : NULL - 读取失败
+** 函数名称: json_free_cbor
+** 功能描述: 释放 json_value_to_cbor 返回的 CBOR 数据
+** 输	 入: data - 需要释放的 CBOR 数据
+** 输	 出: 
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-const char * json_array_get_string(const JSON_Array *array, size_t index) {
-    return json_value_get_string(json_array_get_value(array, index));
+void json_free_cbor(unsigned char *data) {
+    parson_free(data);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_array_get_number
-** 功能描述: 在指定的 JSON array 中，通过 JSONNumber 类型变量的“索引下标值”获取与其对应的内容
-** 输	 入: array - 我们要操作的 JSON array 对象
-**         : index - JSONNumber 类型变量的“索引下标值”
-** 输	 出: double - 读取到的 JSONNumber 类型 number 变量值
-**         : 0 - 读取失败
+** 函数名称: json_value_from_cbor
+** 功能描述: 把指定的 CBOR 格式二进制数据直接解码成与其对应的“树形结构” JSON 数据
+** 注     释: 数据中必须正好包含一个 CBOR 数据项
+** 输	 入: data - 需要解码的 CBOR 数据
+**         : size - CBOR 数据长度
+** 输	 出: JSON_Value - 解码后的“树形结构” JSON 数据
+**         : NULL - 解码失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-double json_array_get_number(const JSON_Array *array, size_t index) {
-    return json_value_get_number(json_array_get_value(array, index));
+JSON_Value * json_value_from_cbor(const void *data, size_t size) {
+    JSON_Cbor_Reader reader;
+    JSON_Value *output_value = NULL;
+    if (data == NULL) {
+        return NULL;
+    }
+    reader.data = (const unsigned char*)data;
+    reader.remaining = size;
+    reader.read_fun = NULL;
+    reader.context = NULL;
+    output_value = json_value_read_cbor_r(&reader, 0);
+    if (output_value != NULL && reader.remaining != 0) {
+        json_value_free(output_value);
+        return NULL;
+    }
+    return output_value;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_array_get_object
-** 功能描述: 在指定的 JSON array 中，通过 JSONObject 类型变量的“索引下标值”获取与其对应的内容
-** 输	 入: array - 我们要操作的 JSON array 对象
-**         : index - JSONObject 类型变量的“索引下标值”
-** 输	 出: double - 读取到的 JSONObject 类型 object 变量值
-**         : 0 - 读取失败
+** 函数名称: json_value_write_cbor
+** 功能描述: 把指定的“树形结构” JSON 数据编码成 CBOR 格式，并通过指定的写函数分批写出
+** 注     释: 编码后的数据先缓存在 BINARY_BUF_SIZE 字节的缓冲区中，所以写函数每次会收到一大块数据
+** 输	 入: value - 需要编码的“树形结构” JSON 数据
+**         : write_fun - 用来写出编码数据的函数
+**         : context - 传递给写函数的参数
+** 输	 出: JSON_Status - 执行状态，写函数失败时返回 JSONFailure
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Object * json_array_get_object(const JSON_Array *array, size_t index) {
-    return json_value_get_object(json_array_get_value(array, index));
+JSON_Status json_value_write_cbor(const JSON_Value *value, JSON_Write_Function write_fun, void *context) {
+    JSON_Binary_Writer *writer = NULL;
+    JSON_Status status = JSONFailure;
+    if (write_fun == NULL) {
+        return JSONFailure;
+    }
+    writer = (JSON_Binary_Writer*)parson_malloc(sizeof(JSON_Binary_Writer));
+    if (writer == NULL) {
+        return JSONFailure;
+    }
+    binary_writer_init(writer, NULL, write_fun, context);
+    if (json_value_write_cbor_r(value, writer) == JSONSuccess) {
+        status = binary_flush(writer);
+    }
+    parson_free(writer);
+    return status;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_array_get_array
-** 功能描述: 在指定的 JSON array 中，通过 JSONArray 类型变量的“索引下标值”获取与其对应的内容
-** 输	 入: array - 我们要操作的 JSON array 对象
-**         : index - JSONArray 类型变量的“索引下标值”
-** 输	 出: double - 读取到的 JSONArray 类型 array 变量值
-**         : NULL - 读取失败
+** 函数名称: json_value_read_cbor
+** 功能描述: 通过指定的读函数读取一个 CBOR 数据项，并直接解码成与其对应的“树形结构” JSON 数据
+** 注     释: 只读取一个数据项需要的数据，不会多读，所以可以从同一个数据流中依次读取多个数据项
+** 输	 入: read_fun - 用来读取编码数据的函数，每次必须读取指定长度的数据
+**         : context - 传递给读函数的参数
+** 输	 出: JSON_Value - 解码后的“树形结构” JSON 数据
+**         : NULL - 读取或者解码失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Array * json_array_get_array(const JSON_Array *array, size_t index) {
-    return json_value_get_array(json_array_get_value(array, index));
+JSON_Value * json_value_read_cbor(JSON_Read_Function read_fun, void *context) {
+    JSON_Cbor_Reader reader;
+    if (read_fun == NULL) {
+        return NULL;
+    }
+    reader.data = NULL;
+    reader.remaining = 0;
+    reader.read_fun = read_fun;
+    reader.context = context;
+    return json_value_read_cbor_r(&reader, 0);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_array_get_boolean
-** 功能描述: 在指定的 JSON array 中，通过 JSONBoolean 类型变量的“索引下标值”获取与其对应的内容
-** 输	 入: array - 我们要操作的 JSON array 对象
-**         : index - JSONBoolean 类型变量的“索引下标值”
-** 输	 出: double - 读取到的 JSONBoolean 类型 boolean 变量值
-**         : -1 - 读取失败
+** 函数名称: json_value_to_snapshot
+** 功能描述: 把指定的“树形结构” JSON 数据写成一个与地址无关的快照镜像，镜像可以直接保存到文件中，之后通过
+**         : mmap 映射到内存并用 json_snapshot_open 打开
+** 输	 入: value - 需要写入的“树形结构” JSON 数据
+** 输	 出: size - 镜像长度
+**         : void * - 快照镜像，需要通过 json_free_snapshot 释放
+**         : NULL - 执行失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-int json_array_get_boolean(const JSON_Array *array, size_t index) {
-    return json_value_get_boolean(json_array_get_value(array, index));
+void * json_value_to_snapshot(const JSON_Value *value, size_t *size) {
+    JSON_Output out;
+    JSON_Binary_Writer writer;
+    json_output_init(&out, NULL, 0, 1);
+    binary_writer_init(&writer, &out, NULL, NULL);
+    if (size == NULL || json_value_write_snapshot_internal(value, &writer) == JSONFailure) {
+        parson_free(out.data);
+        return NULL;
+    }
+    *size = out.length;
+    return out.data;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_array_get_count
-** 功能描述: 获取指定的 JSON_Array 中已经存储的 JSON_Value 成员个数
-** 输	 入: array - 我们要操作的 JSON array 对象
-** 输	 出: size_t - JSON_Array 成员个数
+** 函数名称: json_free_snapshot
+** 功能描述: 释放 json_value_to_snapshot 返回的快照镜像
+** 输	 入: image - 需要释放的快照镜像
+** 输	 出: 
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-size_t json_array_get_count(const JSON_Array *array) {
-    return array ? array->count : 0;
+void json_free_snapshot(void *image) {
+    parson_free(image);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_array_get_wrapping_value
-** 功能描述: 获取指定的 JSON_Array 所属 JSON_Value 的指针
-** 输	 入: array - 我们要操作的 JSON array 对象
-** 输	 出: JSON_Value - JSON_Array 所属 JSON_Value 的指针
+** 函数名称: json_value_write_snapshot
+** 功能描述: 把指定的“树形结构” JSON 数据写成快照镜像，并通过指定的写函数分批写出
+** 输	 入: value - 需要写入的“树形结构” JSON 数据
+**         : write_fun - 用来写出镜像数据的函数
+**         : context - 传递给写函数的参数
+** 输	 出: JSON_Status - 执行状态
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_array_get_wrapping_value(const JSON_Array *array) {
-    return array->wrapping_value;
+JSON_Status json_value_write_snapshot(const JSON_Value *value, JSON_Write_Function write_fun, void *context) {
+    JSON_Binary_Writer *writer = NULL;
+    JSON_Status status = JSONFailure;
+    if (write_fun == NULL) {
+        return JSONFailure;
+    }
+    writer = (JSON_Binary_Writer*)parson_malloc(sizeof(JSON_Binary_Writer));
+    if (writer == NULL) {
+        return JSONFailure;
+    }
+    binary_writer_init(writer, NULL, write_fun, context);
+    if (json_value_write_snapshot_internal(value, writer) == JSONSuccess) {
+        status = binary_flush(writer);
+    }
+    parson_free(writer);
+    return status;
 }
 
-/* JSON Value API */
 /*********************************************************************************************************
-** 函数名称: json_value_get_type
-** 功能描述: 获取指定 JSON_Value 对应的变量类型
-** 输	 入: value - 我们要操作的 JSON_Value 对象
-** 输	 出: JSON_Value_Type - JSON_Value 对象类型
-**         : JSONError - 读取失败
+** 函数名称: json_snapshot_open
+** 功能描述: 打开一个快照镜像并返回镜像中的根节点，只检查文件头和文件尾，不需要分配内存也不需要遍历镜像
+** 注     释: 镜像中的节点引用不会被检查，所以只能打开由 json_value_to_snapshot 或者 json_value_write_snapshot
+**         : 生成的镜像，返回的节点在镜像内存被释放或者解除映射之前一直有效
+** 输	 入: image - 快照镜像的起始地址，不需要对齐
+**         : size - 快照镜像的长度
+** 输	 出: const JSON_Snapshot_Value * - 镜像的根节点
+**         : NULL - 不是合法的快照镜像
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value_Type json_value_get_type(const JSON_Value *value) {
-    return value ? value->type : JSONError;
+const JSON_Snapshot_Value * json_snapshot_open(const void *image, size_t size) {
+    const unsigned char *bytes = (const unsigned char*)image;
+    size_t footer = 0, root = 0;
+    if (bytes == NULL || size < SNAPSHOT_HEADER_SIZE + SNAPSHOT_FOOTER_SIZE || size > SNAPSHOT_MAX_SIZE ||
+        memcmp(bytes, SNAPSHOT_MAGIC, 4) != 0 || snapshot_get_u32(bytes + 4) != SNAPSHOT_VERSION ||
+        memcmp(bytes + size - 4, SNAPSHOT_MAGIC, 4) != 0) {
+        return NULL;
+    }
+    footer = size - SNAPSHOT_FOOTER_SIZE;
+    root = snapshot_get_u32(bytes + footer);
+    if (root == 0 || root > footer - SNAPSHOT_HEADER_SIZE) {
+        return NULL;
+    }
+    return (const JSON_Snapshot_Value*)(bytes + footer - root);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_get_object
-** 功能描述: 获取指定的 JSONObject 类型的 JSON_Value 所对应的变量值
-** 输	 入: value - 我们要操作的 JSON_Value 对象
-** 输	 出: JSON_Object - JSON_Object 变量值
-**         : NULL - 读取失败
+** 函数名称: json_snapshot_to_value
+** 功能描述: 把快照镜像中的指定节点复制成一个普通的“树形结构” JSON 数据，用于需要修改数据的场景
+** 输	 入: value - 需要复制的快照节点
+** 输	 出: JSON_Value * - 复制出的“树形结构” JSON 数据
+**         : NULL - 执行失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Object * json_value_get_object(const JSON_Value *value) {
-    return json_value_get_type(value) == JSONObject ? value->value.object : NULL;
+JSON_Value * json_snapshot_to_value(const JSON_Snapshot_Value *value) {
+    JSON_Value *output_value = NULL, *item = NULL;
+    size_t i = 0, count = json_snapshot_get_count(value);
+    JSON_Status status = JSONSuccess;
+    switch (json_snapshot_get_type(value)) {
+        case JSONArray:
+            output_value = json_value_init_array();
+            if (output_value == NULL || (count > 0 && json_array_resize(json_value_get_array(output_value), count) == JSONFailure)) {
+                json_value_free(output_value);
+                return NULL;
+            }
+            for (i = 0; i < count && status == JSONSuccess; i++) {
+                item = json_snapshot_to_value(json_snapshot_array_get_value(value, i));
+                status = item == NULL ? JSONFailure : json_array_add(json_value_get_array(output_value), item);
+                if (status == JSONFailure) {
+                    json_value_free(item);
+                }
+            }
+            break;
+        case JSONObject:
+            output_value = json_value_init_object();
+            if (output_value == NULL || (count > 0 && json_object_resize(json_value_get_object(output_value), count) == JSONFailure)) {
+                json_value_free(output_value);
+                return NULL;
+            }
+            for (i = 0; i < count && status == JSONSuccess; i++) {
+                item = json_snapshot_to_value(json_snapshot_object_get_value_at(value, i));
+                status = item == NULL ? JSONFailure :
+                         json_object_add(json_value_get_object(output_value), json_snapshot_object_get_name(value, i), item);
+                if (status == JSONFailure) {
+                    json_value_free(item);
+                }
+            }
+            break;
+        case JSONString:
+            return json_value_init_string(json_snapshot_get_string(value));
+        case JSONNumber:
+            return json_value_init_number(json_snapshot_get_number(value));
+        case JSONBoolean:
+            return json_value_init_boolean(json_snapshot_get_boolean(value));
+        case JSONNull:
+            return json_value_init_null();
+        default:
+            return NULL;
+    }
+    if (status == JSONFailure) {
+        json_value_free(output_value);
+        return NULL;
+    }
+    return output_value;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_get_array
-** 功能描述: 获取指定的 JSONArray 类型的 JSON_Value 所对应的变量值
-** 输	 入: value - 我们要操作的 JSON_Value 对象
-** 输	 出: JSON_Array - JSONArray 变量值
-**         : NULL - 读取失败
+** 函数名称: json_snapshot_get_type
+** 功能描述: 获取指定的快照节点的数据类型
+** 输	 入: value - 我们要查询的快照节点
+** 输	 出: JSON_Value_Type - 节点的数据类型，value 为 NULL 时返回 JSONError
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Array * json_value_get_array(const JSON_Value *value) {
-    return json_value_get_type(value) == JSONArray ? value->value.array : NULL;
+JSON_Value_Type json_snapshot_get_type(const JSON_Snapshot_Value *value) {
+    return value ? (JSON_Value_Type)snapshot_get_u32((const unsigned char*)value) : JSONError;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_get_string
-** 功能描述: 获取指定的 JSONString 类型的 JSON_Value 所对应的变量值
-** 输	 入: value - 我们要操作的 JSON_Value 对象
-** 输	 出: string - JSONString 变量值
-**         : NULL - 读取失败
+** 函数名称: json_snapshot_get_string
+** 功能描述: 获取指定的 JSONString 类型快照节点的字符串，字符串直接指向镜像中的数据
+** 输	 入: value - 我们要查询的快照节点
+** 输	 出: const char * - 节点的字符串
+**         : NULL - 节点不是 JSONString 类型
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-const char * json_value_get_string(const JSON_Value *value) {
-    return json_value_get_type(value) == JSONString ? value->value.string : NULL;
+const char * json_snapshot_get_string(const JSON_Snapshot_Value *value) {
+    return json_snapshot_get_type(value) == JSONString ? (const char*)value + 8 : NULL;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_get_number
-** 功能描述: 获取指定的 JSONNumber 类型的 JSON_Value 所对应的变量值
-** 输	 入: value - 我们要操作的 JSON_Value 对象
-** 输	 出: double - JSONNumber 变量值
-**         : 0 - 读取失败
+** 函数名称: json_snapshot_get_string_len
+** 功能描述: 获取指定的 JSONString 类型快照节点的字符串长度
+** 输	 入: value - 我们要查询的快照节点
+** 输	 出: size_t - 字符串长度，节点不是 JSONString 类型时返回 0
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-double json_value_get_number(const JSON_Value *value) {
-    return json_value_get_type(value) == JSONNumber ? value->value.number : 0;
+size_t json_snapshot_get_string_len(const JSON_Snapshot_Value *value) {
+    return json_snapshot_get_type(value) == JSONString ? snapshot_get_u32((const unsigned char*)value + 4) : 0;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_get_boolean
-** 功能描述: 获取指定的 JSONBoolean 类型的 JSON_Value 所对应的变量值
-** 输	 入: value - 我们要操作的 JSON_Value 对象
-** 输	 出: JSONBoolean - JSONBoolean 变量值
-**         : -1 - 读取失败
+** 函数名称: json_snapshot_get_number
+** 功能描述: 获取指定的 JSONNumber 类型快照节点的数值
+** 输	 入: value - 我们要查询的快照节点
+** 输	 出: double - 节点的数值，节点不是 JSONNumber 类型时返回 0
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-int json_value_get_boolean(const JSON_Value *value) {
-    return json_value_get_type(value) == JSONBoolean ? value->value.boolean : -1;
+double json_snapshot_get_number(const JSON_Snapshot_Value *value) {
+    const unsigned char *number = (const unsigned char*)value + 4;
+    unsigned char native[8];
+    const double one = 1.0;
+    double num = 0.0;
+    int i = 0;
+    if (json_snapshot_get_type(value) != JSONNumber) {
+        return 0;
+    }
+    memcpy(native, &one, sizeof(double));
+    if (native[7] == 0x3F) {
+        memcpy(&num, number, sizeof(double));
+    } else {
+        for (i = 0; i < 8; i++) {
+            native[i] = number[7 - i];
+        }
+        memcpy(&num, native, sizeof(double));
+    }
+    return num;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_get_parent
-** 功能描述: 获取指定 JSON_Value 在“树形结构”表示形式中父节点的指针
-** 输	 入: value - 我们要操作的 JSON_Value 对象
-** 输	 出: JSON_Value - 父节点的指针
-**         : NULL - 读取失败
+** 函数名称: json_snapshot_get_boolean
+** 功能描述: 获取指定的 JSONBoolean 类型快照节点的值
+** 输	 入: value - 我们要查询的快照节点
+** 输	 出: int - 节点的值，节点不是 JSONBoolean 类型时返回 -1
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_value_get_parent (const JSON_Value *value) {
-    return value ? value->parent : NULL;
+int json_snapshot_get_boolean(const JSON_Snapshot_Value *value) {
+    return json_snapshot_get_type(value) == JSONBoolean ? (int)snapshot_get_u32((const unsigned char*)value + 4) : -1;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_free
-** 功能描述: 释放 JSON “键值对”中的“值”标识符占用的内存资源
-** 输	 入: value - 我们要操作的 JSON_Value 对象
-** 输	 出: 
+** 函数名称: json_snapshot_get_count
+** 功能描述: 获取指定的 JSONArray 类型快照节点的成员个数或者 JSONObject 类型快照节点的“键值对”个数
+** 输	 入: value - 我们要查询的快照节点
+** 输	 出: size_t - 成员个数，节点不是 JSONArray 或者 JSONObject 类型时返回 0
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-void json_value_free(JSON_Value *value) {
-    switch (json_value_get_type(value)) {
-        case JSONObject:
-            json_object_free(value->value.object);
-            break;
-        case JSONString:
-            parson_free(value->value.string);
-            break;
-        case JSONArray:
-            json_array_free(value->value.array);
-            break;
-        default:
-            break;
-    }
-    parson_free(value);
+size_t json_snapshot_get_count(const JSON_Snapshot_Value *value) {
+    JSON_Value_Type type = json_snapshot_get_type(value);
+    return type == JSONArray || type == JSONObject ? snapshot_get_u32((const unsigned char*)value + 4) : 0;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_init_object
-** 功能描述: 创建并初始化一个 JSON_Object 类型的 JSON_Value 变量
-** 输	 入: 
-** 输	 出: JSON_Value - 创建的 JSON_Object 变量
+** 函数名称: json_snapshot_array_get_value
+** 功能描述: 获取指定的 JSONArray 类型快照节点中指定索引的成员
+** 输	 入: array - 我们要查询的快照节点
+**         : index - 成员索引
+** 输	 出: const JSON_Snapshot_Value * - 找到的成员
+**         : NULL - 节点不是 JSONArray 类型或者索引越界
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_value_init_object(void) {
-    JSON_Value *new_value = (JSON_Value*)parson_malloc(sizeof(JSON_Value));
-    if (!new_value) {
-        return NULL;
-    }
-    new_value->parent = NULL;
-    new_value->type = JSONObject;
-    new_value->value.object = json_object_init(new_value);
-    if (!new_value->value.object) {
-        parson_free(new_value);
+const JSON_Snapshot_Value * json_snapshot_array_get_value(const JSON_Snapshot_Value *array, size_t index) {
+    const unsigned char *node = (const unsigned char*)array;
+    if (json_snapshot_get_type(array) != JSONArray || index >= snapshot_get_u32(node + 4)) {
         return NULL;
     }
-    return new_value;
+    return (const JSON_Snapshot_Value*)(node - snapshot_get_u32(node + 8 + index * 4));
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_init_array
-** 功能描述: 创建并初始化一个 JSON_Array 类型的 JSON_Value 变量
-** 输	 入: 
-** 输	 出: JSON_Value - 创建的 JSON_Array 变量
+** 函数名称: json_snapshot_object_get_value
+** 功能描述: 获取指定的 JSONObject 类型快照节点中指定“键”的成员值，成员较多时通过镜像中的散列表查找
+** 输	 入: object - 我们要查询的快照节点
+**         : name - 需要查找的“键”
+** 输	 出: const JSON_Snapshot_Value * - 找到的成员值
+**         : NULL - 节点不是 JSONObject 类型或者没找到
 ** 全局变量: 
-** 调用模块: 
-*********************************************************************************************************/
-JSON_Value * json_value_init_array(void) {
-    JSON_Value *new_value = (JSON_Value*)parson_malloc(sizeof(JSON_Value));
-    if (!new_value) {
-        return NULL;
-    }
-    new_value->parent = NULL;
-    new_value->type = JSONArray;
-    new_value->value.array = json_array_init(new_value);
-    if (!new_value->value.array) {
-        parson_free(new_value);
+** 调用模块: 
+*********************************************************************************************************/
+const JSON_Snapshot_Value * json_snapshot_object_get_value(const JSON_Snapshot_Value *object, const char *name) {
+    if (json_snapshot_get_type(object) != JSONObject || name == NULL) {
         return NULL;
     }
-    return new_value;
+    return (const JSON_Snapshot_Value*)snapshot_object_getn((const unsigned char*)object, name, strlen(name));
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_init_string
-** 功能描述: 创建并初始化一个 JSON_String 类型的 JSON_Value 变量
-** 输	 入: string - JSON_String 类型的 JSON_Value 变量初始值
-** 输	 出: JSON_Value - 创建的 JSON_String 变量
+** 函数名称: json_snapshot_object_dotget_value
+** 功能描述: 获取指定的 JSONObject 类型快照节点中通过“点”分隔的路径指定的成员值，例如 "a.b.c"
+** 输	 入: object - 我们要查询的快照节点
+**         : name - 需要查找的路径
+** 输	 出: const JSON_Snapshot_Value * - 找到的成员值
+**         : NULL - 没找到
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_value_init_string(const char *string) {
-    char *copy = NULL;
-    JSON_Value *value;
-    size_t string_len = 0;
-    if (string == NULL) {
-        return NULL;
-    }
-    string_len = strlen(string);
-    if (!is_valid_utf8(string, string_len)) {
+const JSON_Snapshot_Value * json_snapshot_object_dotget_value(const JSON_Snapshot_Value *object, const char *name) {
+    const char *dot_position = NULL;
+    if (json_snapshot_get_type(object) != JSONObject || name == NULL) {
         return NULL;
     }
-    copy = parson_strndup(string, string_len);
-    if (copy == NULL) {
-        return NULL;
-    }
-    value = json_value_init_string_no_copy(copy);
-    if (value == NULL) {
-        parson_free(copy);
+    while ((dot_position = strchr(name, '.')) != NULL) {
+        object = (const JSON_Snapshot_Value*)snapshot_object_getn((const unsigned char*)object, name, (size_t)(dot_position - name));
+        if (json_snapshot_get_type(object) != JSONObject) {
+            return NULL;
+        }
+        name = dot_position + 1;
     }
-    return value;
+    return json_snapshot_object_get_value(object, name);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_init_number
-** 功能描述: 创建并初始化一个 JSON_Number 类型的 JSON_Value 变量
-** 输	 入: number - JSON_Number 类型的 JSON_Value 变量初始值
-** 输	 出: JSON_Value - 创建的 JSON_Number 变量
+** 函数名称: json_snapshot_object_get_name
+** 功能描述: 获取指定的 JSONObject 类型快照节点中指定索引的“键”，成员顺序与写入快照时的顺序相同
+** 输	 入: object - 我们要查询的快照节点
+**         : index - 成员索引
+** 输	 出: const char * - 找到的“键”
+**         : NULL - 节点不是 JSONObject 类型或者索引越界
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_value_init_number(double number) {
-    JSON_Value *new_value = NULL;
-    if (IS_NUMBER_INVALID(number)) {
+const char * json_snapshot_object_get_name(const JSON_Snapshot_Value *object, size_t index) {
+    const unsigned char *node = (const unsigned char*)object;
+    if (json_snapshot_get_type(object) != JSONObject || index >= snapshot_get_u32(node + 4)) {
         return NULL;
     }
-    new_value = (JSON_Value*)parson_malloc(sizeof(JSON_Value));
-    if (new_value == NULL) {
-        return NULL;
-    }
-    new_value->parent = NULL;
-    new_value->type = JSONNumber;
-    new_value->value.number = number;
-    return new_value;
+    return (const char*)(node - snapshot_get_u32(node + 12 + index * 8)) + 8;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_init_boolean
-** 功能描述: 创建并初始化一个 JSON_Bool 类型的 JSON_Value 变量
-** 输	 入: boolean - JSON_Bool 类型的 JSON_Value 变量初始值
-** 输	 出: JSON_Value - 创建的 JSON_Bool 变量
+** 函数名称: json_snapshot_object_get_value_at
+** 功能描述: 获取指定的 JSONObject 类型快照节点中指定索引的成员值
+** 输	 入: object - 我们要查询的快照节点
+**         : index - 成员索引
+** 输	 出: const JSON_Snapshot_Value * - 找到的成员值
+**         : NULL - 节点不是 JSONObject 类型或者索引越界
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_value_init_boolean(int boolean) {
-    JSON_Value *new_value = (JSON_Value*)parson_malloc(sizeof(JSON_Value));
-    if (!new_value) {
+const JSON_Snapshot_Value * json_snapshot_object_get_value_at(const JSON_Snapshot_Value *object, size_t index) {
+    const unsigned char *node = (const unsigned char*)object;
+    if (json_snapshot_get_type(object) != JSONObject || index >= snapshot_get_u32(node + 4)) {
         return NULL;
     }
-    new_value->parent = NULL;
-    new_value->type = JSONBoolean;
-    new_value->value.boolean = boolean ? 1 : 0;
-    return new_value;
+    return (const JSON_Snapshot_Value*)(node - snapshot_get_u32(node + 16 + index * 8));
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_init_null
-** 功能描述: 创建并初始化一个 JSON_Null 类型的 JSON_Value 变量
-** 输	 入: boolean - JSON_Bool 类型的 JSON_Value 变量初始值
-** 输	 出: JSON_Value - 创建的 JSON_Null 变量
+** 函数名称: json_value_to_compact
+** 功能描述: 把指定的“树形结构” JSON 数据转换成一个只读的紧凑文档，文档只需要一次内存分配
+** 注     释: 每个值占用一个 8 字节的槽位，数值直接保存在槽位中，其他类型的值是带类型标记的 NaN，字符串和
+**         : 容器的成员区通过 32 位的相对距离引用，所以文档最大 4GB
+** 输	 入: value - 需要转换的“树形结构” JSON 数据
+** 输	 出: size - 文档占用的字节数，可以为 NULL
+**         : JSON_Compact_Value * - 文档的根节点，需要通过 json_free_compact 释放
+**         : NULL - 执行失败
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_value_init_null(void) {
-    JSON_Value *new_value = (JSON_Value*)parson_malloc(sizeof(JSON_Value));
-    if (!new_value) {
+JSON_Compact_Value * json_value_to_compact(const JSON_Value *value, size_t *size) {
+    JSON_Compact_Writer cw;
+    size_t base = 0, total = 0;
+    if (value == NULL) {
         return NULL;
     }
-    new_value->parent = NULL;
-    new_value->type = JSONNull;
-    return new_value;
+    memset(&cw, 0, sizeof(JSON_Compact_Writer)); /* first pass only counts slots and string bytes */
+    cw.slot_count = 1;
+    compact_write_value(&cw, 0, value);
+    base = cw.slot_count * COMPACT_SLOT_SIZE;
+    total = base + cw.string_end;
+    if (total > COMPACT_MAX_SIZE || total < base) {
+        return NULL;
+    }
+    memset(&cw, 0, sizeof(JSON_Compact_Writer));
+    cw.string_base = base;
+    cw.slots = (unsigned char*)parson_malloc(total);
+    if (cw.slots == NULL) {
+        return NULL;
+    }
+    cw.slot_count = 1;
+    compact_write_value(&cw, 0, value);
+    if (size != NULL) {
+        *size = total;
+    }
+    return (JSON_Compact_Value*)cw.slots;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_value_deep_copy
-** 功能描述: 分别递归遍历指定的“树形结构” JSON 数据，为每一个节点对象分配新的内存空间并复制对应的数据内容
-**         : 到新空间中，然后返回“新构建”数的根节点 JSON_Value 地址
-** 输	 入: value - 需要被复制的树形结构 JSON 数据
-** 输	 出: JSON_Value - 新复制的树形结构 JSON 数据
+** 函数名称: json_free_compact
+** 功能描述: 释放 json_value_to_compact 返回的紧凑文档
+** 输	 入: document - 需要释放的紧凑文档的根节点
+** 输	 出: 
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Value * json_value_deep_copy(const JSON_Value *value) {
-    size_t i = 0;
-    JSON_Value *return_value = NULL, *temp_value_copy = NULL, *temp_value = NULL;
-    const char *temp_string = NULL, *temp_key = NULL;
-    char *temp_string_copy = NULL;
-    JSON_Array *temp_array = NULL, *temp_array_copy = NULL;
-    JSON_Object *temp_object = NULL, *temp_object_copy = NULL;
+void json_free_compact(JSON_Compact_Value *document) {
+    parson_free(document);
+}
 
-    switch (json_value_get_type(value)) {
+/*********************************************************************************************************
+** 函数名称: json_compact_to_value
+** 功能描述: 把紧凑文档中的指定节点复制成一个普通的“树形结构” JSON 数据，用于需要修改数据的场景
+** 输	 入: value - 需要复制的紧凑文档节点
+** 输	 出: JSON_Value * - 复制出的“树形结构” JSON 数据
+**         : NULL - 执行失败
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_compact_to_value(const JSON_Compact_Value *value) {
+    JSON_Value *output_value = NULL, *item = NULL;
+    size_t i = 0, count = json_compact_get_count(value);
+    JSON_Status status = JSONSuccess;
+    switch (json_compact_get_type(value)) {
         case JSONArray:
-            temp_array = json_value_get_array(value);
-            return_value = json_value_init_array();
-            if (return_value == NULL) {
+            output_value = json_value_init_array();
+            if (output_value == NULL || (count > 0 && json_array_resize(json_value_get_array(output_value), count) == JSONFailure)) {
+                json_value_free(output_value);
                 return NULL;
             }
-            temp_array_copy = json_value_get_array(return_value);
-
-			// 分别遍历 JSON 数组结构中的每一个成员，并复制到新分配的内存空间中
-			// 如果数组当前 JSON 树形结构深度不是一，则会执行递归拷贝，复制整个
-			// JSON 树中的所有数据到新分配的对应空间中
-            for (i = 0; i < json_array_get_count(temp_array); i++) {
-                temp_value = json_array_get_value(temp_array, i);
-                temp_value_copy = json_value_deep_copy(temp_value);
-                if (temp_value_copy == NULL) {
-                    json_value_free(return_value);
-                    return NULL;
-                }
-                if (json_array_add(temp_array_copy, temp_value_copy) == JSONFailure) {
-                    json_value_free(return_value);
-                    json_value_free(temp_value_copy);
-                    return NULL;
+            for (i = 0; i < count && status == JSONSuccess; i++) {
+                item = json_compact_to_value(json_compact_array_get_value(value, i));
+                status = item == NULL ? JSONFailure : json_array_add(json_value_get_array(output_value), item);
+                if (status == JSONFailure) {
+                    json_value_free(item);
                 }
             }
-            return return_value;
+            break;
         case JSONObject:
-            temp_object = json_value_get_object(value);
-            return_value = json_value_init_object();
-            if (return_value == NULL) {
+            output_value = json_value_init_object();
+            if (output_value == NULL || (count > 0 && json_object_resize(json_value_get_object(output_value), count) == JSONFailure)) {
+                json_value_free(output_value);
                 return NULL;
             }
-
-			// 分别遍历 JSON 对象结构中的每一个成员，并复制到新分配的内存空间中
-			// 如果数组当前 JSON 树形结构深度不是一，则会执行递归拷贝，复制整个
-			// JSON 树中的所有数据到新分配的对应空间中
-            temp_object_copy = json_value_get_object(return_value);
-            for (i = 0; i < json_object_get_count(temp_object); i++) {
-                temp_key = json_object_get_name(temp_object, i);
-                temp_value = json_object_get_value(temp_object, temp_key);
-                temp_value_copy = json_value_deep_copy(temp_value);
-                if (temp_value_copy == NULL) {
-                    json_value_free(return_value);
-                    return NULL;
-                }
-                if (json_object_add(temp_object_copy, temp_key, temp_value_copy) == JSONFailure) {
-                    json_value_free(return_value);
-                    json_value_free(temp_value_copy);
-                    return NULL;
+            for (i = 0; i < count && status == JSONSuccess; i++) {
+                item = json_compact_to_value(json_compact_object_get_value_at(value, i));
+                status = item == NULL ? JSONFailure :
+                         json_object_add(json_value_get_object(output_value), json_compact_object_get_name(value, i), item);
+                if (status == JSONFailure) {
+                    json_value_free(item);
                 }
             }
-            return return_value;
-        case JSONBoolean:
-            return json_value_init_boolean(json_value_get_boolean(value));
-        case JSONNumber:
-            return json_value_init_number(json_value_get_number(value));
+            break;
         case JSONString:
-            temp_string = json_value_get_string(value);
-            if (temp_string == NULL) {
-                return NULL;
-            }
-            temp_string_copy = parson_strdup(temp_string);
-            if (temp_string_copy == NULL) {
-                return NULL;
-            }
-            return_value = json_value_init_string_no_copy(temp_string_copy);
-            if (return_value == NULL) {
-                parson_free(temp_string_copy);
-            }
-            return return_value;
+            return json_value_init_string(json_compact_get_string(value));
+        case JSONNumber:
+            return json_value_init_number(json_compact_get_number(value));
+        case JSONBoolean:
+            return json_value_init_boolean(json_compact_get_boolean(value));
         case JSONNull:
             return json_value_init_null();
-        case JSONError:
-            return NULL;
         default:
             return NULL;
     }
+    if (status == JSONFailure) {
+        json_value_free(output_value);
+        return NULL;
+    }
+    return output_value;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_serialization_size
-** 功能描述: 计算对指定的“树形结构” JSON 数据“序列化”后的字符串所占用的内存空间大小
-** 注     释: 这个接口计算的是没有添加格式化空格来提高可阅读性时所占用的内存空间大小
-** 输	 入: value - 需要被转换的“树形结构” JSON 数据
-** 输	 出: size_t - 序列化后所需要的内存空间大小
-** 全局变量: 
-** 调用模块: 
-*********************************************************************************************************/
-size_t json_serialization_size(const JSON_Value *value) {
-    char num_buf[NUM_BUF_SIZE]; /* recursively allocating buffer on stack is a bad idea, so let's do it only once */
-    int res = json_serialize_to_buffer_r(value, NULL, 0, 0, num_buf);
-    return res < 0 ? 0 : (size_t)(res + 1);
-}
-
-/*********************************************************************************************************
-** 函数名称: json_serialize_to_buffer
-** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据并把转换后的
-**         : 结果存储到我们指定的缓存空间中
-** 注     释: 这个转换接口没有添加格式化空格来提高可阅读性，所以占用空间比较少
-** 输	 入: value - 需要转换的“树形结构” JSON 数据
-**         : buf - 用来存储转换后的、“序列化”格式的字符串缓冲区
-** 输	 出: buf_size_in_bytes - 用来存储“序列化”字符串的缓冲区空间大小
+** 函数名称: json_compact_get_type
+** 功能描述: 获取指定的紧凑文档节点的数据类型
+** 输	 入: value - 我们要查询的紧凑文档节点
+** 输	 出: JSON_Value_Type - 节点的数据类型，value 为 NULL 时返回 JSONError
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Status json_serialize_to_buffer(const JSON_Value *value, char *buf, size_t buf_size_in_bytes) {
-    int written = -1;
-    size_t needed_size_in_bytes = json_serialization_size(value);
-    if (needed_size_in_bytes == 0 || buf_size_in_bytes < needed_size_in_bytes) {
-        return JSONFailure;
+JSON_Value_Type json_compact_get_type(const JSON_Compact_Value *value) {
+    if (value == NULL) {
+        return JSONError;
     }
-    written = json_serialize_to_buffer_r(value, buf, 0, 0, NULL);
-    if (written < 0) {
-        return JSONFailure;
+    switch (compact_get_tag((const unsigned char*)value)) {
+        case 0:               return JSONNumber;
+        case COMPACT_NULL:    return JSONNull;
+        case COMPACT_BOOLEAN: return JSONBoolean;
+        case COMPACT_STRING:  return JSONString;
+        case COMPACT_ARRAY:   return JSONArray;
+        case COMPACT_OBJECT:  return JSONObject;
+        default:              return JSONError;
     }
-    return JSONSuccess;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_serialize_to_file
-** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据并把转换后的
-**         : 结果存储到我们指定的文件中
-** 注     释: 这个转换接口没有添加格式化空格来提高可阅读性，所以占用空间比较少
-** 输	 入: value - 需要转换的“树形结构” JSON 数据
-**         : filename - 用来存储转换后的、“序列化”格式的字符串文件名
-** 输	 出: JSON_Status - 操作状态
+** 函数名称: json_compact_get_string
+** 功能描述: 获取指定的 JSONString 类型紧凑文档节点的字符串，字符串直接指向文档中的数据
+** 输	 入: value - 我们要查询的紧凑文档节点
+** 输	 出: const char * - 节点的字符串
+**         : NULL - 节点不是 JSONString 类型
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Status json_serialize_to_file(const JSON_Value *value, const char *filename) {
-    JSON_Status return_code = JSONSuccess;
-    FILE *fp = NULL;
-    char *serialized_string = json_serialize_to_string(value);
-    if (serialized_string == NULL) {
-        return JSONFailure;
-    }
-    fp = fopen(filename, "w");
-    if (fp == NULL) {
-        json_free_serialized_string(serialized_string);
-        return JSONFailure;
-    }
-    if (fputs(serialized_string, fp) == EOF) {
-        return_code = JSONFailure;
-    }
-    if (fclose(fp) == EOF) {
-        return_code = JSONFailure;
+const char * json_compact_get_string(const JSON_Compact_Value *value) {
+    const unsigned char *slot = (const unsigned char*)value;
+    if (json_compact_get_type(value) != JSONString) {
+        return NULL;
     }
-    json_free_serialized_string(serialized_string);
-    return return_code;
+    return (const char*)slot + compact_get_payload(slot);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_serialize_to_string
-** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据，并返回字
-**         : 符串地址
-** 注     释: 这个转换接口没有添加格式化空格来提高可阅读性，所以占用空间比较少
-** 输	 入: value - 需要转换的“树形结构” JSON 数据
-** 输	 出: string - 序列化后字符串指针
+** 函数名称: json_compact_get_number
+** 功能描述: 获取指定的 JSONNumber 类型紧凑文档节点的数值
+** 输	 入: value - 我们要查询的紧凑文档节点
+** 输	 出: double - 节点的数值，节点不是 JSONNumber 类型时返回 0
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-char * json_serialize_to_string(const JSON_Value *value) {
-    JSON_Status serialization_result = JSONFailure;
-    size_t buf_size_bytes = json_serialization_size(value);
-    char *buf = NULL;
-    if (buf_size_bytes == 0) {
-        return NULL;
-    }
-    buf = (char*)parson_malloc(buf_size_bytes);
-    if (buf == NULL) {
-        return NULL;
-    }
-    serialization_result = json_serialize_to_buffer(value, buf, buf_size_bytes);
-    if (serialization_result == JSONFailure) {
-        json_free_serialized_string(buf);
-        return NULL;
+double json_compact_get_number(const JSON_Compact_Value *value) {
+    double number = 0.0;
+    if (json_compact_get_type(value) != JSONNumber) {
+        return 0;
     }
-    return buf;
+    memcpy(&number, value, sizeof(double));
+    return number;
 }
 
 /*********************************************************************************************************
-** 函数名称: json_serialization_size_pretty
-** 功能描述: 计算如果把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据
-**         : 并在“序列化”后的字符串中是否需要添加格式化空格所需要的缓冲区空间大小
-** 输	 入: value - 需要转换的“树形结构” JSON 数据
-** 输	 出: size_t - 我们序列化指定“树形结构” JSON 数据需要的缓冲区空间大小
+** 函数名称: json_compact_get_boolean
+** 功能描述: 获取指定的 JSONBoolean 类型紧凑文档节点的值
+** 输	 入: value - 我们要查询的紧凑文档节点
+** 输	 出: int - 节点的值，节点不是 JSONBoolean 类型时返回 -1
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-size_t json_serialization_size_pretty(const JSON_Value *value) {
-    char num_buf[NUM_BUF_SIZE]; /* recursively allocating buffer on stack is a bad idea, so let's do it only once */
-    int res = json_serialize_to_buffer_r(value, NULL, 0, 1, num_buf);
-    return res < 0 ? 0 : (size_t)(res + 1);
+int json_compact_get_boolean(const JSON_Compact_Value *value) {
+    if (json_compact_get_type(value) != JSONBoolean) {
+        return -1;
+    }
+    return (int)compact_get_payload((const unsigned char*)value);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_serialize_to_buffer_pretty
-** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据，并在
-**         : “序列化”字符串时添加格式化空格来提高可阅读性，然后把转换后的结果存储到我们指定的缓存空间中
-** 输	 入: value - 需要转换的“树形结构” JSON 数据
-**         : buf - 用来存储转换后的、“序列化”格式的字符串缓冲区
-**         : buf 缓冲区长度
-** 输	 出: JSON_Status - 操作状态
+** 函数名称: json_compact_get_count
+** 功能描述: 获取指定的 JSONArray 类型紧凑文档节点的成员个数或者 JSONObject 类型节点的“键值对”个数
+** 输	 入: value - 我们要查询的紧凑文档节点
+** 输	 出: size_t - 成员个数，节点不是 JSONArray 或者 JSONObject 类型时返回 0
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Status json_serialize_to_buffer_pretty(const JSON_Value *value, char *buf, size_t buf_size_in_bytes) {
-    int written = -1;
-    size_t needed_size_in_bytes = json_serialization_size_pretty(value);
-    if (needed_size_in_bytes == 0 || buf_size_in_bytes < needed_size_in_bytes) {
-        return JSONFailure;
-    }
-    written = json_serialize_to_buffer_r(value, buf, 0, 1, NULL);
-    if (written < 0) {
-        return JSONFailure;
+size_t json_compact_get_count(const JSON_Compact_Value *value) {
+    const unsigned char *slot = (const unsigned char*)value;
+    JSON_Value_Type type = json_compact_get_type(value);
+    if (type != JSONArray && type != JSONObject) {
+        return 0;
     }
-    return JSONSuccess;
+    return compact_get_payload(slot + compact_get_payload(slot) * COMPACT_SLOT_SIZE);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_serialize_to_file_pretty
-** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据，并在
-**         : “序列化”字符串时添加格式化空格来提高可阅读性，然后把转换后的结果存储到我们指定的文件中
-** 输	 入: value - 需要转换的“树形结构” JSON 数据
-**         : filename - 存储“序列化” JSON 的文件名
-** 输	 出: JSON_Status - 操作状态
+** 函数名称: json_compact_array_get_value
+** 功能描述: 获取指定的 JSONArray 类型紧凑文档节点中指定索引的成员
+** 输	 入: array - 我们要查询的紧凑文档节点
+**         : index - 成员索引
+** 输	 出: const JSON_Compact_Value * - 找到的成员
+**         : NULL - 节点不是 JSONArray 类型或者索引越界
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-JSON_Status json_serialize_to_file_pretty(const JSON_Value *value, const char *filename) {
-    JSON_Status return_code = JSONSuccess;
-    FILE *fp = NULL;
-    char *serialized_string = json_serialize_to_string_pretty(value);
-    if (serialized_string == NULL) {
-        return JSONFailure;
-    }
-    fp = fopen(filename, "w");
-    if (fp == NULL) {
-        json_free_serialized_string(serialized_string);
-        return JSONFailure;
-    }
-    if (fputs(serialized_string, fp) == EOF) {
-        return_code = JSONFailure;
-    }
-    if (fclose(fp) == EOF) {
-        return_code = JSONFailure;
-    }
-    json_free_serialized_string(serialized_string);
-    return return_code;
+const JSON_Compact_Value * json_compact_array_get_value(const JSON_Compact_Value *array, size_t index) {
+    const unsigned char *slot = (const unsigned char*)array;
+    if (json_compact_get_type(array) != JSONArray || index >= json_compact_get_count(array)) {
+        return NULL;
+    }
+    return (const JSON_Compact_Value*)(slot + (compact_get_payload(slot) + 1 + index) * COMPACT_SLOT_SIZE);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_serialize_to_string_pretty
-** 功能描述: 把指定的 JSON 数据“树形结构”的表示形式数据转换成与其对应的“序列化”格式的字符串数据，并在
-**         : “序列化”字符串时添加格式化空格来提高可阅读性，然后把转换后的结果存储到我们动态分配的内存
-**         : 空间中并返回内存首地址（即字符串地址）
-** 输	 入: value - 需要转换的“树形结构” JSON 数据
-** 输	 出: string - 序列化后字符串地址
+** 函数名称: json_compact_object_get_value
+** 功能描述: 获取指定的 JSONObject 类型紧凑文档节点中指定“键”的成员值
+** 输	 入: object - 我们要查询的紧凑文档节点
+**         : name - 需要查找的“键”
+** 输	 出: const JSON_Compact_Value * - 找到的成员值
+**         : NULL - 节点不是 JSONObject 类型或者没找到
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-char * json_serialize_to_string_pretty(const JSON_Value *value) {
-    JSON_Status serialization_result = JSONFailure;
-    size_t buf_size_bytes = json_serialization_size_pretty(value);
-    char *buf = NULL;
-    if (buf_size_bytes == 0) {
+const JSON_Compact_Value * json_compact_object_get_value(const JSON_Compact_Value *object, const char *name) {
+    if (name == NULL) {
         return NULL;
     }
-    buf = (char*)parson_malloc(buf_size_bytes);
-    if (buf == NULL) {
+    return (const JSON_Compact_Value*)compact_object_getn((const unsigned char*)object, name, strlen(name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_compact_object_dotget_value
+** 功能描述: 获取指定的 JSONObject 类型紧凑文档节点中通过“点”分隔的路径指定的成员值，例如 "a.b.c"
+** 输	 入: object - 我们要查询的紧凑文档节点
+**         : name - 需要查找的路径
+** 输	 出: const JSON_Compact_Value * - 找到的成员值
+**         : NULL - 没找到
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+const JSON_Compact_Value * json_compact_object_dotget_value(const JSON_Compact_Value *object, const char *name) {
+    const unsigned char *slot = (const unsigned char*)object;
+    const char *dot_position = NULL;
+    if (name == NULL) {
         return NULL;
     }
-    serialization_result = json_serialize_to_buffer_pretty(value, buf, buf_size_bytes);
-    if (serialization_result == JSONFailure) {
-        json_free_serialized_string(buf);
+    while ((dot_position = strchr(name, '.')) != NULL) {
+        slot = compact_object_getn(slot, name, (size_t)(dot_position - name));
+        name = dot_position + 1;
+    }
+    return (const JSON_Compact_Value*)compact_object_getn(slot, name, strlen(name));
+}
+
+/*********************************************************************************************************
+** 函数名称: json_compact_object_get_name
+** 功能描述: 获取指定的 JSONObject 类型紧凑文档节点中指定索引的“键”，成员顺序与转换时的顺序相同
+** 输	 入: object - 我们要查询的紧凑文档节点
+**         : index - 成员索引
+** 输	 出: const char * - 找到的“键”
+**         : NULL - 节点不是 JSONObject 类型或者索引越界
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+const char * json_compact_object_get_name(const JSON_Compact_Value *object, size_t index) {
+    const unsigned char *slot = (const unsigned char*)object;
+    if (json_compact_get_type(object) != JSONObject || index >= json_compact_get_count(object)) {
         return NULL;
     }
-    return buf;
+    slot += (compact_get_payload(slot) + 1 + index * 2) * COMPACT_SLOT_SIZE;
+    return (const char*)slot + compact_get_payload(slot);
 }
 
 /*********************************************************************************************************
-** 函数名称: json_free_serialized_string
-** 功能描述: 释放指定的“序列化” JSON 字符串数据所占用的内存空间
-** 输	 入: string - 需要释放的“序列化” JSON 字符串数据
-** 输	 出: 
+** 函数名称: json_compact_object_get_value_at
+** 功能描述: 获取指定的 JSONObject 类型紧凑文档节点中指定索引的成员值
+** 输	 入: object - 我们要查询的紧凑文档节点
+**         : index - 成员索引
+** 输	 出: const JSON_Compact_Value * - 找到的成员值
+**         : NULL - 节点不是 JSONObject 类型或者索引越界
 ** 全局变量: 
 ** 调用模块: 
 *********************************************************************************************************/
-void json_free_serialized_string(char *string) {
-    parson_free(string);
+const JSON_Compact_Value * json_compact_object_get_value_at(const JSON_Compact_Value *object, size_t index) {
+    const unsigned char *slot = (const unsigned char*)object;
+    if (json_compact_get_type(object) != JSONObject || index >= json_compact_get_count(object)) {
+        return NULL;
+    }
+    return (const JSON_Compact_Value*)(slot + (compact_get_payload(slot) + 2 + index * 2) * COMPACT_SLOT_SIZE);
 }
 
 /*********************************************************************************************************
 ** 函数名称: json_array_remove
 ** 功能描述: 在“树形结构”中，把指定 JSON_Array 的指定数组索引所对应的成员从数组中移除并释放与其对应的内存空间
+** 注     释: 后面的成员依次前移，数组成员的顺序保持不变
 ** 输	 入: array - 我们要操作的 JSON_Array 对象
 **         : ix - 我们要移除并释放的数组成员索引值
 ** 输	 出: JSON_Status - 操作状态
@@ -2518,17 +7430,123 @@ void json_free_serialized_string(char *string) {
 ** 调用模块: 
 *********************************************************************************************************/
 JSON_Status json_array_remove(JSON_Array *array, size_t ix) {
-    size_t to_move_bytes = 0;
-    if (array == NULL || ix >= json_array_get_count(array)) {
+    return json_array_erase_range(array, ix, 1);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_erase_range
+** 功能描述: 在“树形结构”中，把指定 JSON_Array 中从指定索引开始的连续多个成员从数组中移除并释放
+** 注     释: 后面的成员通过一次 memmove 前移，数组成员的顺序保持不变
+** 输	 入: array - 我们要操作的 JSON_Array 对象
+**         : ix - 第一个要移除的数组成员索引值
+**         : count - 要移除的成员个数，范围超出数组时什么也不做并返回 JSONFailure
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_array_erase_range(JSON_Array *array, size_t ix, size_t count) {
+    return json_array_splice(array, ix, count, NULL, 0);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_insert_value
+** 功能描述: 在“树形结构”中，把指定的 JSON_Value 插入到指定 JSON_Array 的指定数组索引位置
+** 注     释: 从这个位置开始的成员通过一次 memmove 后移，插入成功后 value 属于 JSON_Array
+** 输	 入: array - 我们要操作的 JSON_Array 对象
+**         : ix - 插入位置，等于数组成员个数时追加到数组末尾
+**         : value - 我们要插入的数组成员
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_array_insert_value(JSON_Array *array, size_t ix, JSON_Value *value) {
+    return json_array_splice(array, ix, 0, &value, 1);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_splice
+** 功能描述: 在“树形结构”中，把指定 JSON_Array 中从指定索引开始的连续多个成员替换成另外一组成员
+** 注     释: 先检查参数并准备好数组空间，再释放被移除的成员，后面的成员只通过一次 memmove 移动到新位置，
+**         : 所以失败时数组保持不变，调用者仍然拥有 values 中的成员；成功后 values 中的成员属于 JSON_Array。
+**         : 重复的成员通过两两比较检查，插入的成员通常很少。定义了 PARSON_NO_PARENT 时不能检查成员是否已经属于
+**         : 其他 JSON 数据，由调用者保证
+** 输	 入: array - 我们要操作的 JSON_Array 对象
+**         : ix - 第一个要移除的数组成员索引值，也是插入位置
+**         : remove_count - 要移除的成员个数
+**         : values - 要插入的成员数组，不能有 NULL、重复或者已经有父节点的成员
+**         : insert_count - 要插入的成员个数
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_array_splice(JSON_Array *array, size_t ix, size_t remove_count,
+                              JSON_Value * const *values, size_t insert_count) {
+    JSON_Value *wrapping_value = NULL;
+    size_t i = 0, j = 0, new_count = 0;
+    if (array == NULL || IS_FROZEN(array->wrapping_value) || ix > array->count ||
+        remove_count > array->count - ix || (values == NULL && insert_count > 0) ||
+        insert_count > (size_t)-1 / sizeof(JSON_Value*) - array->count) {
         return JSONFailure;
     }
-    json_value_free(json_array_get_value(array, ix));
-    to_move_bytes = (json_array_get_count(array) - 1 - ix) * sizeof(JSON_Value*);
-    memmove(array->items + ix, array->items + ix + 1, to_move_bytes);
-    array->count -= 1;
+    for (i = 0; i < insert_count; i++) {
+        if (values[i] == NULL || VALUE_PARENT(values[i]) != NULL) {
+            return JSONFailure;
+        }
+        for (j = 0; j < i; j++) {
+            if (values[j] == values[i]) { /* it would be freed twice */
+                return JSONFailure;
+            }
+        }
+    }
+    new_count = array->count - remove_count + insert_count;
+    if (new_count > array->capacity &&
+        json_array_resize(array, MAX(MAX(new_count, array->capacity * 2), STARTING_CAPACITY)) == JSONFailure) {
+        return JSONFailure;
+    }
+    for (i = ix; i < ix + remove_count; i++) {
+        json_value_free(array->items[i]);
+    }
+    memmove(array->items + ix + insert_count, array->items + ix + remove_count,
+            (array->count - ix - remove_count) * sizeof(JSON_Value*));
+    wrapping_value = json_array_get_wrapping_value(array);
+    for (i = 0; i < insert_count; i++) {
+        if (!IS_FROZEN(values[i])) { /* shared values have no parent */
+            SET_VALUE_PARENT(values[i], wrapping_value);
+        }
+        array->items[ix + i] = values[i];
+    }
+    array->count = new_count;
+    json_value_invalidate_cache(wrapping_value);
     return JSONSuccess;
 }
 
+/*********************************************************************************************************
+** 函数名称: json_array_take_value
+** 功能描述: 在“树形结构”中，把指定 JSON_Array 的指定数组索引所对应的成员从数组中移除，但是不释放，而是
+**         : 把它返回给调用者，调用者可以把它添加到其他 JSON 数据中，不需要复制
+** 注     释: 和 json_array_remove 一样保持数组成员的顺序，返回的 JSON_Value 没有父节点
+** 输	 入: array - 我们要操作的 JSON_Array 对象
+**         : ix - 我们要取出的数组成员索引值
+** 输	 出: JSON_Value - 取出的 JSON_Value，属于调用者
+**         : NULL - 索引超出范围或者 JSON_Array 是冻结的
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_array_take_value(JSON_Array *array, size_t ix) {
+    JSON_Value *taken = NULL;
+    if (array == NULL || IS_FROZEN(array->wrapping_value) || ix >= json_array_get_count(array)) {
+        return NULL;
+    }
+    taken = array->items[ix];
+    memmove(array->items + ix, array->items + ix + 1, (array->count - 1 - ix) * sizeof(JSON_Value*));
+    array->count -= 1;
+    if (!IS_FROZEN(taken)) { /* shared values have no parent */
+        SET_VALUE_PARENT(taken, NULL);
+    }
+    json_value_invalidate_cache(array->wrapping_value);
+    return taken;
+}
+
 /*********************************************************************************************************
 ** 函数名称: json_array_replace_value
 ** 功能描述: 在“树形结构”中，设置指定 JSON_Array 的指定数组索引所对应成员的数据内容
@@ -2540,12 +7558,16 @@ JSON_Status json_array_remove(JSON_Array *array, size_t ix) {
 ** 调用模块: 
 *********************************************************************************************************/
 JSON_Status json_array_replace_value(JSON_Array *array, size_t ix, JSON_Value *value) {
-    if (array == NULL || value == NULL || value->parent != NULL || ix >= json_array_get_count(array)) {
+    if (array == NULL || value == NULL || VALUE_PARENT(value) != NULL ||
+        IS_FROZEN(array->wrapping_value) || ix >= json_array_get_count(array)) {
         return JSONFailure;
     }
     json_value_free(json_array_get_value(array, ix));
-    value->parent = json_array_get_wrapping_value(array);
+    if (!IS_FROZEN(value)) {
+        SET_VALUE_PARENT(value, json_array_get_wrapping_value(array));
+    }
     array->items[ix] = value;
+    json_value_invalidate_cache(array->wrapping_value);
     return JSONSuccess;
 }
 
@@ -2646,16 +7668,61 @@ JSON_Status json_array_replace_null(JSON_Array *array, size_t i) {
 *********************************************************************************************************/
 JSON_Status json_array_clear(JSON_Array *array) {
     size_t i = 0;
-    if (array == NULL) {
+    if (array == NULL || IS_FROZEN(array->wrapping_value)) {
         return JSONFailure;
     }
     for (i = 0; i < json_array_get_count(array); i++) {
         json_value_free(json_array_get_value(array, i));
     }
     array->count = 0;
+    json_value_invalidate_cache(array->wrapping_value);
     return JSONSuccess;
 }
 
+/*********************************************************************************************************
+** 函数名称: json_array_reserve
+** 功能描述: 保证指定的 JSON array 至少可以存储指定个数的成员，在这之前追加成员不会再重新分配数组空间
+** 输	 入: array - 我们要操作的 JSON_Array 对象
+**         : capacity - 需要保证的成员个数，不大于当前容量时什么也不做
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_array_reserve(JSON_Array *array, size_t capacity) {
+    if (array == NULL || IS_FROZEN(array->wrapping_value)) {
+        return JSONFailure;
+    }
+    if (capacity <= array->capacity) {
+        return JSONSuccess;
+    }
+    return json_array_resize(array, capacity);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_shrink_to_fit
+** 功能描述: 把指定的 JSON array 的容量缩小到当前成员个数，释放多余的数组空间
+** 注     释: 没有成员时释放整个数组空间
+** 输	 入: array - 我们要操作的 JSON_Array 对象
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_array_shrink_to_fit(JSON_Array *array) {
+    if (array == NULL || IS_FROZEN(array->wrapping_value)) {
+        return JSONFailure;
+    }
+    if (array->count == array->capacity) {
+        return JSONSuccess;
+    }
+    if (array->count == 0) {
+        parson_free(array->items);
+        array->items = NULL;
+        array->capacity = 0;
+        return JSONSuccess;
+    }
+    return json_array_resize(array, array->count);
+}
+
 /*********************************************************************************************************
 ** 函数名称: json_array_append_value
 ** 功能描述: 向指定的 JSON array 中追加一个新的 JSON_Value 成员
@@ -2665,7 +7732,7 @@ JSON_Status json_array_clear(JSON_Array *array) {
 ** 调用模块: 
 *********************************************************************************************************/
 JSON_Status json_array_append_value(JSON_Array *array, JSON_Value *value) {
-    if (array == NULL || value == NULL || value->parent != NULL) {
+    if (array == NULL || value == NULL || VALUE_PARENT(value) != NULL || IS_FROZEN(array->wrapping_value)) {
         return JSONFailure;
     }
     return json_array_add(array, value);
@@ -2751,6 +7818,51 @@ JSON_Status json_array_append_null(JSON_Array *array) {
     return JSONSuccess;
 }
 
+/*********************************************************************************************************
+** 函数名称: json_array_append_numbers
+** 功能描述: 向指定的 JSON array 中追加一组 JSON_Number 类型的成员
+** 注     释: 有不合法的数字（NaN 或者无穷大）或者内存不足时什么也不追加
+** 输	 入: array - 我们要操作的 JSON_Array 对象
+**         : numbers - 成员值数组
+**         : count - 成员个数
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_array_append_numbers(JSON_Array *array, const double *numbers, size_t count) {
+    return json_array_add_many(array, JSONNumber, numbers, count);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_append_strings
+** 功能描述: 向指定的 JSON array 中追加一组 JSON_String 类型的成员，字符串会被复制
+** 注     释: 有 NULL 或者不合法的 UTF-8 字符串或者内存不足时什么也不追加
+** 输	 入: array - 我们要操作的 JSON_Array 对象
+**         : strings - 字符串数组
+**         : count - 成员个数
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_array_append_strings(JSON_Array *array, const char * const *strings, size_t count) {
+    return json_array_add_many(array, JSONString, strings, count);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_array_append_booleans
+** 功能描述: 向指定的 JSON array 中追加一组 JSON_Boolean 类型的成员，非 0 值表示 true
+** 注     释: 内存不足时什么也不追加
+** 输	 入: array - 我们要操作的 JSON_Array 对象
+**         : booleans - 成员值数组
+**         : count - 成员个数
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_array_append_booleans(JSON_Array *array, const int *booleans, size_t count) {
+    return json_array_add_many(array, JSONBoolean, booleans, count);
+}
+
 /*********************************************************************************************************
 ** 函数名称: json_object_set_value
 ** 功能描述: 设置指定 JSON object 中指定“键”描述符所对应的“值”描述符内容，如果指定的 JSON object 中已经
@@ -2766,7 +7878,8 @@ JSON_Status json_array_append_null(JSON_Array *array) {
 JSON_Status json_object_set_value(JSON_Object *object, const char *name, JSON_Value *value) {
     size_t i = 0;
     JSON_Value *old_value;
-    if (object == NULL || name == NULL || value == NULL || value->parent != NULL) {
+    if (object == NULL || name == NULL || value == NULL || VALUE_PARENT(value) != NULL ||
+        IS_FROZEN(object->wrapping_value)) {
         return JSONFailure;
     }
     old_value = json_object_get_value(object, name);
@@ -2774,8 +7887,11 @@ JSON_Status json_object_set_value(JSON_Object *object, const char *name, JSON_Va
         json_value_free(old_value);
         for (i = 0; i < json_object_get_count(object); i++) {
             if (strcmp(object->names[i], name) == 0) {
-                value->parent = json_object_get_wrapping_value(object);
+                if (!IS_FROZEN(value)) {
+                    SET_VALUE_PARENT(value, json_object_get_wrapping_value(object));
+                }
                 object->values[i] = value;
+                json_value_invalidate_cache(object->wrapping_value);
                 return JSONSuccess;
             }
         }
@@ -2797,7 +7913,12 @@ JSON_Status json_object_set_value(JSON_Object *object, const char *name, JSON_Va
 ** 调用模块: 
 *********************************************************************************************************/
 JSON_Status json_object_set_string(JSON_Object *object, const char *name, const char *string) {
-    return json_object_set_value(object, name, json_value_init_string(string));
+    JSON_Value *value = json_value_init_string(string);
+    if (json_object_set_value(object, name, value) == JSONFailure) {
+        json_value_free(value);
+        return JSONFailure;
+    }
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
@@ -2813,7 +7934,12 @@ JSON_Status json_object_set_string(JSON_Object *object, const char *name, const
 ** 调用模块: 
 *********************************************************************************************************/
 JSON_Status json_object_set_number(JSON_Object *object, const char *name, double number) {
-    return json_object_set_value(object, name, json_value_init_number(number));
+    JSON_Value *value = json_value_init_number(number);
+    if (json_object_set_value(object, name, value) == JSONFailure) {
+        json_value_free(value);
+        return JSONFailure;
+    }
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
@@ -2829,7 +7955,12 @@ JSON_Status json_object_set_number(JSON_Object *object, const char *name, double
 ** 调用模块: 
 *********************************************************************************************************/
 JSON_Status json_object_set_boolean(JSON_Object *object, const char *name, int boolean) {
-    return json_object_set_value(object, name, json_value_init_boolean(boolean));
+    JSON_Value *value = json_value_init_boolean(boolean);
+    if (json_object_set_value(object, name, value) == JSONFailure) {
+        json_value_free(value);
+        return JSONFailure;
+    }
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
@@ -2845,7 +7976,12 @@ JSON_Status json_object_set_boolean(JSON_Object *object, const char *name, int b
 ** 调用模块: 
 *********************************************************************************************************/
 JSON_Status json_object_set_null(JSON_Object *object, const char *name) {
-    return json_object_set_value(object, name, json_value_init_null());
+    JSON_Value *value = json_value_init_null();
+    if (json_object_set_value(object, name, value) == JSONFailure) {
+        json_value_free(value);
+        return JSONFailure;
+    }
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
@@ -2853,6 +7989,7 @@ JSON_Status json_object_set_null(JSON_Object *object, const char *name) {
 ** 功能描述: 设置指定 JSON object 中通过“点”描述法指定“键”描述符所对应的“值”描述符内容，如果指定的 JSON object
 **         : 中已经有了我们指定的“键”描述符所对应的“键值对”，则更新这个“键值对”的内容，如果没有对应的“键值对”
 **         : 则向这个 JSON object 中添加一个新的“键值对”
+** 注     释: 路径上共享的 JSON object 会先被替换成私有的副本（写时复制）
 ** 输	 入: object - 我们要操作的 JSON object
 **         : name - “点”描述法指定的“键值对”的“键”描述符
 **         : value - “键值对”的“值”描述符
@@ -2866,7 +8003,7 @@ JSON_Status json_object_dotset_value(JSON_Object *object, const char *name, JSON
     JSON_Object *temp_object = NULL, *new_object = NULL;
     JSON_Status status = JSONFailure;
     size_t name_len = 0;
-    if (object == NULL || name == NULL || value == NULL) {
+    if (object == NULL || name == NULL || value == NULL || IS_FROZEN(object->wrapping_value)) {
         return JSONFailure;
     }
     dot_pos = strchr(name, '.');
@@ -2880,6 +8017,10 @@ JSON_Status json_object_dotset_value(JSON_Object *object, const char *name, JSON
         if (json_value_get_type(temp_value) != JSONObject) {
             return JSONFailure;
         }
+        temp_value = json_object_unsharen_value(object, name, name_len); /* copy on write */
+        if (temp_value == NULL) {
+            return JSONFailure;
+        }
         temp_object = json_value_get_object(temp_value);
         return json_object_dotset_value(temp_object, dot_pos + 1, value);
     }
@@ -2895,7 +8036,7 @@ JSON_Status json_object_dotset_value(JSON_Object *object, const char *name, JSON
     }
     status = json_object_addn(object, name, name_len, new_value);
     if (status != JSONSuccess) {
-        json_object_dotremove_internal(new_object, dot_pos + 1, 0);
+        json_object_dotremove_internal(new_object, dot_pos + 1, &temp_value); /* value still belongs to the caller */
         json_value_free(new_value);
         return JSONFailure;
     }
@@ -3009,7 +8150,76 @@ JSON_Status json_object_dotset_null(JSON_Object *object, const char *name) {
 ** 调用模块: 
 *********************************************************************************************************/
 JSON_Status json_object_remove(JSON_Object *object, const char *name) {
-    return json_object_remove_internal(object, name, 1);
+    return json_object_remove_internal(object, name, NULL, 0);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_remove_ordered
+** 功能描述: 从指定的 JSON object 中删除指定“键”标识符对应的成员并释放“值”标识符所占用的资源，剩下的
+**         : “键值对”保持原来的顺序
+** 输	 入: object - 我们要操作的 JSON object
+**         : name - “键值对”的“键”标识符
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_object_remove_ordered(JSON_Object *object, const char *name) {
+    return json_object_remove_internal(object, name, NULL, 1);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_remove_many
+** 功能描述: 从指定的 JSON object 中删除一组“键”标识符对应的成员并释放“值”标识符所占用的资源，剩下的
+**         : “键值对”保持原来的顺序
+** 注     释: 只遍历一次“键值对”，删除的同时把保留的“键值对”向前紧缩；不存在的“键”会被忽略。使用共享
+**         : “键”列表的 JSON object 先通过哈希索引判断是否有需要删除的“键”，没有时“键”列表保持共享
+** 输	 入: object - 我们要操作的 JSON object
+**         : names - 要删除的“键”标识符数组
+**         : count - 要删除的“键”标识符个数
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_object_remove_many(JSON_Object *object, const char * const *names, size_t count) {
+    size_t i = 0, j = 0, kept = 0, found = 0;
+    if (object == NULL || (names == NULL && count > 0) || IS_FROZEN(object->wrapping_value)) {
+        return JSONFailure;
+    }
+    for (j = 0; j < count; j++) {
+        if (names[j] == NULL) {
+            return JSONFailure;
+        }
+        if (!found && object->shape != NULL) {
+            found = json_object_find_index(object, names[j], strlen(names[j]), &i);
+        }
+    }
+    if (object->shape != NULL && !found) {
+        return JSONSuccess; /* nothing to remove, keys stay shared */
+    }
+    if (json_object_own_names(object) == JSONFailure) {
+        return JSONFailure;
+    }
+    for (i = 0; i < object->count; i++) {
+        for (j = 0; j < count; j++) {
+            if (strcmp(object->names[i], names[j]) == 0) {
+                break;
+            }
+        }
+        if (j < count) {
+            parson_free_string(object->names[i]);
+            json_value_free(object->values[i]);
+            continue;
+        }
+        object->names[kept] = object->names[i];
+        object->values[kept] = object->values[i];
+        kept++;
+    }
+    if (kept != object->count) {
+        object->count = kept;
+        json_object_invalidate_order(object);
+        json_value_invalidate_cache(object->wrapping_value);
+    }
+    return JSONSuccess;
 }
 
 /*********************************************************************************************************
@@ -3023,7 +8233,46 @@ JSON_Status json_object_remove(JSON_Object *object, const char *name) {
 ** 调用模块: 
 *********************************************************************************************************/
 JSON_Status json_object_dotremove(JSON_Object *object, const char *name) {
-    return json_object_dotremove_internal(object, name, 1);
+    return json_object_dotremove_internal(object, name, NULL);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_take_value
+** 功能描述: 从指定的 JSON object 中删除指定“键”标识符对应的成员，但是不释放“值”标识符，而是把它返回给
+**         : 调用者，调用者可以把它添加到其他 JSON 数据中，不需要复制
+** 注     释: 和 json_object_remove 一样用最后一个“键值对”填补删除的位置，返回的 JSON_Value 没有父节点
+** 输	 入: object - 我们要操作的 JSON object
+**         : name - “键值对”的“键”标识符
+** 输	 出: JSON_Value - 取出的 JSON_Value，属于调用者
+**         : NULL - 没有找到对应的成员或者 JSON object 是冻结的
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_object_take_value(JSON_Object *object, const char *name) {
+    JSON_Value *taken = NULL;
+    if (json_object_remove_internal(object, name, &taken, 0) == JSONFailure) {
+        return NULL;
+    }
+    return taken;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_dottake_value
+** 功能描述: 从指定的 JSON object 中删除“点表示法”指定的成员，但是不释放“值”标识符，而是把它返回给调用者
+** 注     释: 路径上共享的 JSON object 会先被替换成私有的副本（写时复制），返回的 JSON_Value 没有父节点
+** 输	 入: object - 我们要操作的 JSON object
+**         : name - “点表示法”指定的“键值对”的“键”标识符
+** 输	 出: JSON_Value - 取出的 JSON_Value，属于调用者
+**         : NULL - 没有找到对应的成员或者 JSON object 是冻结的
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Value * json_object_dottake_value(JSON_Object *object, const char *name) {
+    JSON_Value *taken = NULL;
+    if (object == NULL || name == NULL || json_object_dotremove_internal(object, name, &taken) == JSONFailure) {
+        return NULL;
+    }
+    return taken;
 }
 
 /*********************************************************************************************************
@@ -3036,14 +8285,88 @@ JSON_Status json_object_dotremove(JSON_Object *object, const char *name) {
 *********************************************************************************************************/
 JSON_Status json_object_clear(JSON_Object *object) {
     size_t i = 0;
-    if (object == NULL) {
+    if (object == NULL || IS_FROZEN(object->wrapping_value)) {
         return JSONFailure;
     }
     for (i = 0; i < json_object_get_count(object); i++) {
-        parson_free(object->names[i]);
+        if (object->shape == NULL) {
+            parson_free_string(object->names[i]);
+        }
         json_value_free(object->values[i]);
     }
+    if (object->shape != NULL) { /* drop the shared keys, the object starts over like a new one */
+        json_shape_release(object->shape);
+        parson_free(object->values);
+        object->shape = NULL;
+        object->names = NULL;
+        object->values = NULL;
+        object->capacity = 0;
+    }
     object->count = 0;
+    json_object_invalidate_order(object);
+    json_value_invalidate_cache(object->wrapping_value);
+    return JSONSuccess;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_reserve
+** 功能描述: 保证指定的 JSON object 至少可以存储指定个数的“键值对”，在这之前添加成员不会再重新分配空间
+** 注     释: 使用共享“键”列表的 JSON object 会先复制一份私有的“键”列表
+** 输	 入: object - 我们要操作的 JSON object
+**         : capacity - 需要保证的“键值对”个数，不大于当前容量时什么也不做
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_object_reserve(JSON_Object *object, size_t capacity) {
+    if (object == NULL || IS_FROZEN(object->wrapping_value)) {
+        return JSONFailure;
+    }
+    if (capacity <= object->capacity) {
+        return JSONSuccess;
+    }
+    if (json_object_own_names(object) == JSONFailure) {
+        return JSONFailure;
+    }
+    return json_object_resize(object, capacity);
+}
+
+/*********************************************************************************************************
+** 函数名称: json_object_shrink_to_fit
+** 功能描述: 把指定的 JSON object 的容量缩小到当前“键值对”个数，释放多余的空间
+** 注     释: 使用共享“键”列表的 JSON object 只缩小“值”数组，“键”列表保持共享；没有成员时释放全部空间
+** 输	 入: object - 我们要操作的 JSON object
+** 输	 出: JSON_Status - 操作状态
+** 全局变量: 
+** 调用模块: 
+*********************************************************************************************************/
+JSON_Status json_object_shrink_to_fit(JSON_Object *object) {
+    JSON_Value **values = NULL;
+    if (object == NULL || IS_FROZEN(object->wrapping_value)) {
+        return JSONFailure;
+    }
+    if (object->count == object->capacity) {
+        return JSONSuccess;
+    }
+    if (object->count == 0) { /* objects without members have no shape */
+        parson_free(object->names);
+        parson_free(object->values);
+        object->names = NULL;
+        object->values = NULL;
+        object->capacity = 0;
+        return JSONSuccess;
+    }
+    if (object->shape == NULL) {
+        return json_object_resize(object, object->count);
+    }
+    values = (JSON_Value**)parson_malloc(object->count * sizeof(JSON_Value*));
+    if (values == NULL) {
+        return JSONFailure;
+    }
+    memcpy(values, object->values, object->count * sizeof(JSON_Value*));
+    parson_free(object->values);
+    object->values = values;
+    object->capacity = object->count;
     return JSONSuccess;
 }
 
@@ -3284,6 +8607,46 @@ void json_set_allocation_functions(JSON_Malloc_Function malloc_fun, JSON_Free_Fu
     parson_free = free_fun;
 }
 
+/*********************************************************************************************************
+** 函数名称: json_set_pool_limit
+** 功能描述: 设置每个线程的内存块池中每个大小等级最多缓存的空闲内存块个数，0 表示不使用内存块池
+** 注     释: 这是一个全局设置，需要在其他线程使用 parson 之前设置
+** 输	 入: blocks_per_size - 每个大小等级最多缓存的空闲内存块个数
+** 输	 出: 
+** 全局变量: parson_pool_limit
+** 调用模块: 
+*********************************************************************************************************/
+void json_set_pool_limit(size_t blocks_per_size) {
+    parson_pool_limit = PARSON_HAS_POOL ? blocks_per_size : 0;
+}
+
+/*********************************************************************************************************
+** 函数名称: json_pool_trim
+** 功能描述: 释放当前线程的内存块池中缓存的所有空闲内存块
+** 注     释: 线程退出之前需要调用，否则这个线程缓存的内存块会丢失
+** 输	 入: 
+** 输	 出: size_t - 释放的内存块个数
+** 全局变量: parson_pool
+** 调用模块: 
+*********************************************************************************************************/
+size_t json_pool_trim(void) {
+    size_t trimmed = 0;
+#if PARSON_HAS_POOL
+    JSON_Pool_Block *block = NULL;
+    size_t i = 0;
+    for (i = 0; i < POOL_CLASSES; i++) {
+        while (parson_pool.free_blocks[i] != NULL) {
+            block = parson_pool.free_blocks[i];
+            parson_pool.free_blocks[i] = block->next;
+            parson_free(block);
+            trimmed++;
+        }
+        parson_pool.counts[i] = 0;
+    }
+#endif
+    return trimmed;
+}
+
 void json_set_escape_slashes(int escape_slashes) {
     parson_escape_slashes = escape_slashes;
 }
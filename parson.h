@@ -56,12 +56,31 @@ typedef int JSON_Status;
 typedef void * (*JSON_Malloc_Function)(size_t);
 typedef void   (*JSON_Free_Function)(void *);
 
+/* Streaming callbacks used by json_value_write_cbor and json_value_read_cbor. A write function
+   must write all size bytes and a read function must read exactly size bytes, both return
+   JSONFailure on error. */
+typedef JSON_Status (*JSON_Write_Function)(void *context, const void *data, size_t size);
+typedef JSON_Status (*JSON_Read_Function)(void *context, void *data, size_t size);
+
 /* Call only once, before calling any other function from parson API. If not called, malloc and free
    from stdlib will be used for all allocations */
 void json_set_allocation_functions(JSON_Malloc_Function malloc_fun, JSON_Free_Function free_fun);
 
+/* Per-thread pools for values, objects, arrays and strings of up to 128 bytes. When enabled, freed
+   blocks are kept in the calling thread's pool (also when another thread allocated them) and reused
+   by later allocations of the same size on that thread, so bulk creation and destruction don't go
+   to the allocator. json_set_pool_limit sets how many free blocks of each size every thread keeps,
+   more are returned to the allocator; 0 (the default) disables pooling. It's a global setting, set
+   it before other threads use parson. json_pool_trim returns the blocks kept by the calling thread
+   to the allocator and returns how many; call it before a thread exits, as blocks kept by exited
+   threads are lost. Pooling is not available if the compiler has no thread local storage or when
+   PARSON_NO_POOL is defined. */
+void   json_set_pool_limit(size_t blocks_per_size);
+size_t json_pool_trim(void);
+
 /* Sets if slashes should be escaped or not when serializing JSON. By default slashes are escaped.
- This function sets a global setting and is not thread safe. */
+ This function sets a global setting and is not thread safe, use JSON_Serialization_Options
+ to choose escaping per call. */
 void json_set_escape_slashes(int escape_slashes);
 
 /* Parses first JSON value in a file, returns NULL in case of error */
@@ -71,14 +90,30 @@ JSON_Value * json_parse_file(const char *filename);
    returns NULL in case of error */
 JSON_Value * json_parse_file_with_comments(const char *filename);
 
-/*  Parses first JSON value in a string, returns NULL in case of error */
+/*  Parses first JSON value in a string, returns NULL in case of error.
+    Parsed objects with the same keys in the same order (e.g. records in an array) share one
+    read-only key list with a hash index; an object gets its own copy when its keys are changed. */
 JSON_Value * json_parse_string(const char *string);
 
 /*  Parses first JSON value in a string and ignores comments (/ * * / and //),
     returns NULL in case of error */
 JSON_Value * json_parse_string_with_comments(const char *string);
 
-/* Serialization */
+/* Parses first JSON value in a string like json_parse_string, but reuses nodes, key and string
+   buffers and container capacity of recycled (a root value returned by an earlier parse) wherever
+   the shape matches, so parsing a stream of similar messages allocates almost nothing:
+       value = json_parse_string_reuse(value, message);
+   recycled is always consumed, also on failure. Frozen (shared) members of recycled are released
+   instead of reused. Returns NULL in case of error, or if recycled has a parent (then it isn't consumed). */
+JSON_Value * json_parse_string_reuse(JSON_Value *recycled, const char *string);
+
+/* Serialization
+   Objects and arrays cache their compact serialized size, so computing sizes of a mostly
+   unchanged value is cheap and json_serialize_to_string allocates its result only once.
+   Because of the cache every serialization function (also the pretty, _with_options and
+   canonical ones) writes to the value it serializes, even though it takes a const pointer.
+   The same value must not be serialized from several threads at once, or while another thread
+   reads it, unless it was frozen with json_value_freeze first: frozen values are never written. */
 size_t      json_serialization_size(const JSON_Value *value); /* returns 0 on fail */
 JSON_Status json_serialize_to_buffer(const JSON_Value *value, char *buf, size_t buf_size_in_bytes);
 JSON_Status json_serialize_to_file(const JSON_Value *value, const char *filename);
@@ -90,8 +125,191 @@ JSON_Status json_serialize_to_buffer_pretty(const JSON_Value *value, char *buf,
 JSON_Status json_serialize_to_file_pretty(const JSON_Value *value, const char *filename);
 char *      json_serialize_to_string_pretty(const JSON_Value *value);
 
+/* Pretty serialization options. Call json_pretty_options_init to get the defaults used by
+   json_serialize_to_string_pretty (4 spaces, "\n", ": ") and change only the fields you need.
+   NULL newline or name_separator fall back to the defaults, newline is limited to 16 characters.
+   If scalars_per_line is not 0, arrays holding only scalars (no objects or arrays) are written
+   as [1, 2, 3] when they have at most scalars_per_line items, and scalars_per_line items per
+   line otherwise. */
+typedef struct json_pretty_options_t {
+    char        indent_char;      /* ' ' or '\t' */
+    size_t      indent_width;     /* indent_chars per nesting level */
+    const char *newline;          /* "\n" or "\r\n" */
+    const char *name_separator;   /* written between object names and values */
+    size_t      scalars_per_line; /* 0 puts every array item on its own line */
+} JSON_Pretty_Options;
+
+void        json_pretty_options_init(JSON_Pretty_Options *options);
+size_t      json_serialization_size_pretty_with_options(const JSON_Value *value, const JSON_Pretty_Options *options); /* returns 0 on fail */
+JSON_Status json_serialize_to_buffer_pretty_with_options(const JSON_Value *value, char *buf, size_t buf_size_in_bytes, const JSON_Pretty_Options *options);
+JSON_Status json_serialize_to_file_pretty_with_options(const JSON_Value *value, const char *filename, const JSON_Pretty_Options *options);
+char *      json_serialize_to_string_pretty_with_options(const JSON_Value *value, const JSON_Pretty_Options *options);
+
+/* Per-call serialization options. Unlike json_set_escape_slashes they don't touch any global state,
+   so serializers with different options can run concurrently (on different or frozen values). Call json_serialization_options_init
+   to get the defaults (escaped slashes, UTF-8 output, 17 significant digits, original member order,
+   no pretty printing). The functions without _with_options keep using json_set_escape_slashes.
+   canonical selects RFC 8785 (JCS) output and overrides all other options: no whitespace,
+   members sorted by name, unescaped slashes and UTF-8, and the shortest number format that
+   reads back exactly, written like JavaScript does. */
+typedef struct json_serialization_options_t {
+    int escape_slashes;                /* writes '/' as "\/" */
+    int ascii_only;                    /* writes non-ASCII characters as \uXXXX (surrogate pairs above U+FFFF) */
+    int float_precision;               /* significant digits of numbers, from 1 to 17, 0 for shortest exact */
+    int sort_keys;                     /* writes object members sorted by name (UTF-16 code units, as RFC 8785) */
+    const JSON_Pretty_Options *pretty; /* NULL for compact output */
+    int canonical;                     /* writes RFC 8785 canonical JSON */
+} JSON_Serialization_Options;
+
+void        json_serialization_options_init(JSON_Serialization_Options *options);
+size_t      json_serialization_size_with_options(const JSON_Value *value, const JSON_Serialization_Options *options); /* returns 0 on fail */
+JSON_Status json_serialize_to_buffer_with_options(const JSON_Value *value, char *buf, size_t buf_size_in_bytes, const JSON_Serialization_Options *options);
+JSON_Status json_serialize_to_file_with_options(const JSON_Value *value, const char *filename, const JSON_Serialization_Options *options);
+char *      json_serialize_to_string_with_options(const JSON_Value *value, const JSON_Serialization_Options *options);
+char *      json_serialize_to_string_canonical(const JSON_Value *value); /* RFC 8785, for hashing and signing */
+
 void        json_free_serialized_string(char *string); /* frees string from json_serialize_to_string and json_serialize_to_string_pretty */
 
+/* Enables or disables caching of compact serialized output in value and every object and array
+   it currently contains. Cached containers keep a copy of their output, and serializing them
+   again without pretty printing, ascii_only, sort_keys or reduced precision copies the bytes
+   of unchanged containers instead of re-serializing them. Changes invalidate the cache of the
+   modified container and its parents. Each cached container keeps its own copy, so memory use
+   grows with document size times nesting depth. Returns JSONFailure if value is not an object
+   or array. */
+JSON_Status json_value_set_serialization_cache(JSON_Value *value, int enabled);
+
+/* Thread safety
+   A value must not be used by several threads at once if any of them changes it, and serializing
+   also updates internal caches. json_value_freeze builds all internal indexes and caches of a root
+   value up front and makes it and everything it contains immutable: every function that changes it
+   returns JSONFailure and no function writes to it anymore. Any number of threads can then read
+   and serialize it concurrently without locks. Freezing can't be undone; free the value with
+   json_value_free once no thread uses it. */
+JSON_Status json_value_freeze(JSON_Value *value); /* value must be a root (have no parent) */
+int         json_value_is_frozen(const JSON_Value *value);
+
+/* Shared immutable subtrees
+   Frozen values are reference counted and can be placed in any number of objects and arrays, in
+   any number of documents, without copying. json_value_share freezes value if needed (it must then
+   be a root) and returns a new reference to it; adding the reference to an object or array (or
+   publishing it) hands it over, json_value_free releases it, and the subtree is freed with its last
+   reference. Reference counts are updated atomically, so documents sharing a subtree can be built
+   and freed by different threads. Frozen values have no parent (json_value_get_parent returns NULL).
+   Changes are copy-on-write: dotset and dotremove functions replace every shared object on the
+   path with a private copy before changing it, and json_object_unshare_value and
+   json_array_unshare_value do the same for a single member and return the private copy. A copy
+   only duplicates one level; its members are new references to the shared ones. */
+JSON_Value * json_value_share(JSON_Value *value);
+JSON_Value * json_object_unshare_value(JSON_Object *object, const char *name);
+JSON_Value * json_array_unshare_value(JSON_Array *array, size_t index);
+
+/* Persistent updates: return a new version of root with the member at the dot notation path set
+   or removed, sharing every untouched subtree with root and copying only the objects on the path,
+   so keeping many versions of a large document costs memory proportional to the edits. root must
+   be an object; it is frozen (see json_value_share) and stays valid and unchanged. The new root is
+   not frozen yet, so more changes can be made to it (copy on write as well); it is frozen when the
+   next version is made from it. json_value_with takes ownership of value only on success.
+   Return NULL on failure (same conditions as json_object_dotset_value and json_object_dotremove). */
+JSON_Value * json_value_with(JSON_Value *root, const char *path, JSON_Value *value);
+JSON_Value * json_value_without(JSON_Value *root, const char *path);
+
+/* Publication of frozen roots, for swapping in a new document while other threads are reading the
+   old one. Readers call json_publisher_acquire, read the returned root and call json_publisher_release
+   with the returned token; they take no locks. json_publisher_publish freezes the new root, swaps it
+   in atomically and frees replaced roots once no reader can still use them, without waiting for
+   readers; json_publisher_reclaim frees the remaining ones later (call it periodically, it returns
+   how many are still waiting). Calls that change the publisher (publish, reclaim) must not run
+   concurrently with each other. The publisher owns all published roots. json_publisher_init
+   returns NULL if the compiler has no atomic operations (GCC, Clang and MSVC are supported). */
+typedef struct json_publisher_t JSON_Publisher;
+
+JSON_Publisher *   json_publisher_init(JSON_Value *root); /* root may be NULL */
+void               json_publisher_free(JSON_Publisher *publisher); /* no reader may be active */
+JSON_Status        json_publisher_publish(JSON_Publisher *publisher, JSON_Value *root);
+size_t             json_publisher_reclaim(JSON_Publisher *publisher);
+const JSON_Value * json_publisher_acquire(JSON_Publisher *publisher, int *token);
+void               json_publisher_release(JSON_Publisher *publisher, int token);
+
+/* Deferred destruction, for freeing large documents without a latency spike. json_value_free_deferred
+   hands a root value over to a reclaimer in constant time (frozen values only release a reference,
+   like json_value_free) and can be called by several threads at once. json_reclaimer_step frees at
+   most max_nodes values per call and returns how many it freed; a value counts once, and so does
+   releasing a reference to a shared value. Less than max_nodes means nothing is left. Call it
+   periodically, or in a loop on a background thread, but on one thread at a time (pooled blocks go
+   to that thread's pool). json_reclaimer_free frees everything still pending. Without atomic
+   operations (see above) all calls must come from the same thread. */
+typedef struct json_reclaimer_t JSON_Reclaimer;
+
+JSON_Reclaimer * json_reclaimer_init(void);
+void             json_reclaimer_free(JSON_Reclaimer *reclaimer);
+JSON_Status      json_value_free_deferred(JSON_Reclaimer *reclaimer, JSON_Value *value); /* value must be a root */
+size_t           json_reclaimer_step(JSON_Reclaimer *reclaimer, size_t max_nodes);
+
+/* CBOR (RFC 8949) encoding, converted directly from and to JSON_Value without going through text.
+   Integral numbers below 2^64 in magnitude are written as CBOR integers, other numbers as single
+   precision floats when that is exact and as doubles otherwise. Arrays and objects are written
+   with their item counts, so decoding can presize them. Decoding accepts definite length text
+   strings, arrays, maps with text keys, integers, floats, false, true and null, and skips tags.
+   json_value_from_cbor fails unless data holds exactly one item, json_value_read_cbor reads
+   exactly one item from the stream and nothing more. */
+unsigned char * json_value_to_cbor(const JSON_Value *value, size_t *size); /* free with json_free_cbor */
+void            json_free_cbor(unsigned char *data);
+JSON_Value *    json_value_from_cbor(const void *data, size_t size);
+JSON_Status     json_value_write_cbor(const JSON_Value *value, JSON_Write_Function write_fun, void *context);
+JSON_Value *    json_value_read_cbor(JSON_Read_Function read_fun, void *context);
+
+/* Snapshots: a parsed value written as a position independent, read-only binary image that can be
+   saved to a file, mapped with mmap and opened in O(1) by any number of processes. Nodes refer to
+   each other by 32 bit relative offsets (images are limited to 4 GB), objects with more than 8
+   members carry a hash table for lookups, and equal strings and names are stored only once.
+   Snapshot values are read with the json_snapshot_* getters below, which mirror the JSON_Value
+   getters and never allocate; strings point into the image. json_snapshot_to_value makes a
+   regular, mutable copy. json_snapshot_open checks only the image header and footer, so open
+   only images written by parson. */
+typedef struct json_snapshot_value_t JSON_Snapshot_Value;
+
+void *      json_value_to_snapshot(const JSON_Value *value, size_t *size); /* free with json_free_snapshot */
+void        json_free_snapshot(void *image);
+JSON_Status json_value_write_snapshot(const JSON_Value *value, JSON_Write_Function write_fun, void *context);
+const JSON_Snapshot_Value * json_snapshot_open(const void *image, size_t size); /* returns root value or NULL */
+JSON_Value *                json_snapshot_to_value(const JSON_Snapshot_Value *value);
+
+JSON_Value_Type             json_snapshot_get_type(const JSON_Snapshot_Value *value);
+const char  *               json_snapshot_get_string(const JSON_Snapshot_Value *value);
+size_t                      json_snapshot_get_string_len(const JSON_Snapshot_Value *value);
+double                      json_snapshot_get_number(const JSON_Snapshot_Value *value);
+int                         json_snapshot_get_boolean(const JSON_Snapshot_Value *value); /* returns -1 on fail */
+size_t                      json_snapshot_get_count(const JSON_Snapshot_Value *value); /* array items or object members */
+const JSON_Snapshot_Value * json_snapshot_array_get_value(const JSON_Snapshot_Value *array, size_t index);
+const JSON_Snapshot_Value * json_snapshot_object_get_value(const JSON_Snapshot_Value *object, const char *name);
+const JSON_Snapshot_Value * json_snapshot_object_dotget_value(const JSON_Snapshot_Value *object, const char *name);
+const char  *               json_snapshot_object_get_name(const JSON_Snapshot_Value *object, size_t index);
+const JSON_Snapshot_Value * json_snapshot_object_get_value_at(const JSON_Snapshot_Value *object, size_t index);
+
+/* Compact documents: a read-only copy of a value in one allocation, where every value takes one
+   8 byte slot. Numbers are stored as plain doubles and all other values as NaN-boxed slots that
+   carry a type tag and a 32 bit payload (boolean, member count or relative offset to the strings
+   and member slots), so number-heavy documents take a fraction of the memory of JSON_Value trees.
+   Keys shared between objects (see json_parse_string) are stored only once. Documents are limited
+   to 4 GB, lookups by name scan the members in order. json_compact_to_value makes a regular copy. */
+typedef struct json_compact_value_t JSON_Compact_Value;
+
+JSON_Compact_Value * json_value_to_compact(const JSON_Value *value, size_t *size); /* free with json_free_compact */
+void                 json_free_compact(JSON_Compact_Value *document);
+JSON_Value *         json_compact_to_value(const JSON_Compact_Value *value);
+
+JSON_Value_Type            json_compact_get_type(const JSON_Compact_Value *value);
+const char  *              json_compact_get_string(const JSON_Compact_Value *value);
+double                     json_compact_get_number(const JSON_Compact_Value *value);
+int                        json_compact_get_boolean(const JSON_Compact_Value *value); /* returns -1 on fail */
+size_t                     json_compact_get_count(const JSON_Compact_Value *value); /* array items or object members */
+const JSON_Compact_Value * json_compact_array_get_value(const JSON_Compact_Value *array, size_t index);
+const JSON_Compact_Value * json_compact_object_get_value(const JSON_Compact_Value *object, const char *name);
+const JSON_Compact_Value * json_compact_object_dotget_value(const JSON_Compact_Value *object, const char *name);
+const char  *              json_compact_object_get_name(const JSON_Compact_Value *object, size_t index);
+const JSON_Compact_Value * json_compact_object_get_value_at(const JSON_Compact_Value *object, size_t index);
+
 /* Comparing */
 int  json_value_equals(const JSON_Value *a, const JSON_Value *b);
 
@@ -161,12 +379,29 @@ JSON_Status json_object_dotset_null(JSON_Object *object, const char *name);
 /* Frees and removes name-value pair */
 JSON_Status json_object_remove(JSON_Object *object, const char *name);
 
+/* Same as above, but keeps the order of remaining name-value pairs (json_object_remove moves the last
+ * pair into the removed one's place). json_object_remove_many removes all given names in one pass,
+ * names that don't exist are ignored. */
+JSON_Status json_object_remove_ordered(JSON_Object *object, const char *name);
+JSON_Status json_object_remove_many(JSON_Object *object, const char * const *names, size_t count);
+
 /* Works like dotget function, but removes name-value pair only on exact match. */
 JSON_Status json_object_dotremove(JSON_Object *object, const char *key);
 
+/* Work like json_object_remove and json_object_dotremove, but return the removed value instead of
+ * freeing it. It has no parent, belongs to the caller and can be added to another document without
+ * copying. Return NULL if there is no such value or object is frozen. */
+JSON_Value * json_object_take_value(JSON_Object *object, const char *name);
+JSON_Value * json_object_dottake_value(JSON_Object *object, const char *name);
+
 /* Removes all name-value pairs in object */
 JSON_Status json_object_clear(JSON_Object *object);
 
+/* Makes room for at least capacity name-value pairs, so adding up to that many doesn't reallocate.
+ * json_object_shrink_to_fit frees unused room, objects with shared keys keep sharing them. */
+JSON_Status json_object_reserve(JSON_Object *object, size_t capacity);
+JSON_Status json_object_shrink_to_fit(JSON_Object *object);
+
 /*
  *JSON Array
  */
@@ -179,10 +414,33 @@ int           json_array_get_boolean(const JSON_Array *array, size_t index); /*
 size_t        json_array_get_count  (const JSON_Array *array);
 JSON_Value  * json_array_get_wrapping_value(const JSON_Array *array);
 
+/* Copy leading values of one type into a C array, stopping at count or at the first value of another
+ * type, and return how many were copied. Strings still belong to the array. */
+size_t json_array_get_numbers (const JSON_Array *array, double *numbers, size_t count);
+size_t json_array_get_strings (const JSON_Array *array, const char **strings, size_t count);
+size_t json_array_get_booleans(const JSON_Array *array, int *booleans, size_t count);
+
 /* Frees and removes value at given index, does nothing and returns JSONFailure if index doesn't exist.
- * Order of values in array may change during execution.  */
+ * Values after it are moved back, so order of values in array is preserved. */
 JSON_Status json_array_remove(JSON_Array *array, size_t i);
 
+/* Works like json_array_remove, but returns the removed value instead of freeing it (see
+ * json_object_take_value). Returns NULL if index doesn't exist or array is frozen. */
+JSON_Value * json_array_take_value(JSON_Array *array, size_t i);
+
+/* Order preserving edits, each moving the values after the edited range only once.
+ * json_array_erase_range frees and removes count values starting at given index.
+ * json_array_insert_value inserts value before given index (index equal to count appends).
+ * json_array_splice replaces remove_count values starting at given index with insert_count values.
+ * Inserted values must be distinct and must not have a parent, otherwise JSONFailure is returned.
+ * With PARSON_NO_PARENT the parent can't be checked, so the caller must make sure they don't belong
+ * to any object or array (this one included). On failure array isn't changed and inserted values
+ * still belong to the caller, on success they belong to array and shouldn't be freed afterwards. */
+JSON_Status json_array_erase_range (JSON_Array *array, size_t i, size_t count);
+JSON_Status json_array_insert_value(JSON_Array *array, size_t i, JSON_Value *value);
+JSON_Status json_array_splice      (JSON_Array *array, size_t i, size_t remove_count,
+                                    JSON_Value * const *values, size_t insert_count);
+
 /* Frees and removes from array value at given index and replaces it with given one.
  * Does nothing and returns JSONFailure if index doesn't exist.
  * json_array_replace_value does not copy passed value so it shouldn't be freed afterwards. */
@@ -195,6 +453,11 @@ JSON_Status json_array_replace_null(JSON_Array *array, size_t i);
 /* Frees and removes all values from array */
 JSON_Status json_array_clear(JSON_Array *array);
 
+/* Makes room for at least capacity values, so appending up to that many doesn't reallocate.
+ * json_array_shrink_to_fit frees unused room. */
+JSON_Status json_array_reserve(JSON_Array *array, size_t capacity);
+JSON_Status json_array_shrink_to_fit(JSON_Array *array);
+
 /* Appends new value at the end of array.
  * json_array_append_value does not copy passed value so it shouldn't be freed afterwards. */
 JSON_Status json_array_append_value(JSON_Array *array, JSON_Value *value);
@@ -203,11 +466,18 @@ JSON_Status json_array_append_number(JSON_Array *array, double number);
 JSON_Status json_array_append_boolean(JSON_Array *array, int boolean);
 JSON_Status json_array_append_null(JSON_Array *array);
 
+/* Append count values from a C array with a single reservation. Either all values are appended or,
+ * on invalid input (non-finite number, NULL or invalid UTF-8 string) or allocation failure, none. */
+JSON_Status json_array_append_numbers (JSON_Array *array, const double *numbers, size_t count);
+JSON_Status json_array_append_strings (JSON_Array *array, const char * const *strings, size_t count);
+JSON_Status json_array_append_booleans(JSON_Array *array, const int *booleans, size_t count);
+
 /*
  *JSON Value
  */
 JSON_Value * json_value_init_object (void);
 JSON_Value * json_value_init_array  (void);
+JSON_Value * json_value_init_array_with_capacity(size_t capacity);
 JSON_Value * json_value_init_string (const char *string); /* copies passed string */
 JSON_Value * json_value_init_number (double number);
 JSON_Value * json_value_init_boolean(int boolean);
@@ -221,7 +491,35 @@ JSON_Array  *   json_value_get_array  (const JSON_Value *value);
 const char  *   json_value_get_string (const JSON_Value *value);
 double          json_value_get_number (const JSON_Value *value);
 int             json_value_get_boolean(const JSON_Value *value);
-JSON_Value  *   json_value_get_parent (const JSON_Value *value);
+JSON_Value  *   json_value_get_parent (const JSON_Value *value); /* always NULL with PARSON_NO_PARENT */
+
+/* Removes value from its parent without freeing it and returns it, a value without a parent is
+ * returned as is. Returns NULL for frozen values and always with PARSON_NO_PARENT, where
+ * json_object_take_value and json_array_take_value have to be used instead. */
+JSON_Value  *   json_value_detach     (JSON_Value *value);
+
+/* Cursors keep the path from a root to the current value, so parents can be found while walking
+   a tree without parent pointers: compiling parson with PARSON_NO_PARENT removes the parent pointer
+   from every value (8 bytes per value on 64 bit systems) and the writes of it while parsing and
+   building. In that mode json_value_get_parent returns NULL, attaching a value that already has
+   a parent isn't detected, and serialization caches are used only by frozen values. Cursors also
+   work in the default build, e.g. for shared subtrees that have no single parent.
+   json_cursor_next walks all values in pre-order and json_cursor_seek finds a value from the root;
+   moves that fail leave the cursor unchanged. A cursor must not outlive changes to its tree. */
+typedef struct json_cursor_t JSON_Cursor;
+
+JSON_Cursor * json_cursor_init  (const JSON_Value *root);
+void          json_cursor_free  (JSON_Cursor *cursor);
+JSON_Value  * json_cursor_value (const JSON_Cursor *cursor);
+JSON_Value  * json_cursor_parent(const JSON_Cursor *cursor); /* NULL at the root */
+size_t        json_cursor_depth (const JSON_Cursor *cursor); /* 0 at the root */
+size_t        json_cursor_index (const JSON_Cursor *cursor); /* index in the parent */
+const char  * json_cursor_name  (const JSON_Cursor *cursor); /* name in the parent object */
+JSON_Status   json_cursor_down  (JSON_Cursor *cursor, size_t index);
+JSON_Status   json_cursor_member(JSON_Cursor *cursor, const char *name);
+JSON_Status   json_cursor_up    (JSON_Cursor *cursor);
+JSON_Status   json_cursor_next  (JSON_Cursor *cursor);
+JSON_Status   json_cursor_seek  (JSON_Cursor *cursor, const JSON_Value *value);
 
 /* Same as above, but shorter */
 JSON_Value_Type json_type   (const JSON_Value *value);
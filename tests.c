@@ -50,17 +50,44 @@ void test_suite_8(void); /* Test serialization */
 void test_suite_9(void); /* Test serialization (pretty) */
 void test_suite_10(void); /* Testing for memory leaks */
 void test_suite_11(void); /* Additional things that require testing */
+void test_suite_12(void); /* Test CBOR encoding */
+void test_suite_13(void); /* Test snapshots */
+void test_suite_14(void); /* Test frozen values */
+void test_suite_15(void); /* Test publisher */
+void test_suite_16(void); /* Test shared subtrees */
+void test_suite_17(void); /* Test persistent updates */
+void test_suite_18(void); /* Test per-thread pools */
+void test_suite_19(void); /* Test deferred destruction */
+void test_suite_20(void); /* Test parsing into a recycled value */
+void test_suite_21(void); /* Test shared keys of records */
+void test_suite_22(void); /* Test compact documents */
+void test_suite_23(void); /* Test cursors */
+void test_suite_24(void); /* Test reserving capacity */
+void test_suite_25(void); /* Test bulk append and get */
+void test_suite_26(void); /* Test order preserving array edits */
+void test_suite_27(void); /* Test removing object members */
+void test_suite_28(void); /* Test moving values between documents */
 
 void print_commits_info(const char *username, const char *repo);
 void persistence_example(void);
 void serialization_example(void);
 
 static int malloc_count;
+static int malloc_calls; /* every allocation, also the ones already freed */
 static void *counted_malloc(size_t size);
 static void counted_free(void *ptr);
 
 static char * read_file(const char * filename);
 
+typedef struct test_stream_t {
+    unsigned char data[16384];
+    size_t length;
+    size_t position;
+    size_t writes;
+} Test_Stream;
+static JSON_Status stream_write(void *context, const void *data, size_t size);
+static JSON_Status stream_read(void *context, void *data, size_t size);
+
 static int tests_passed;
 static int tests_failed;
 
@@ -82,6 +109,23 @@ int main() {
     test_suite_9();
     test_suite_10();
     test_suite_11();
+    test_suite_12();
+    test_suite_13();
+    test_suite_14();
+    test_suite_15();
+    test_suite_16();
+    test_suite_17();
+    test_suite_18();
+    test_suite_19();
+    test_suite_20();
+    test_suite_21();
+    test_suite_22();
+    test_suite_23();
+    test_suite_24();
+    test_suite_25();
+    test_suite_26();
+    test_suite_27();
+    test_suite_28();
 
     printf("Tests failed: %d\n", tests_failed);
     printf("Tests passed: %d\n", tests_passed);
@@ -218,7 +262,9 @@ void test_suite_2(JSON_Value *root_value) {
     array = json_object_get_array(root_object, "string array");
     array_value = json_object_get_value(root_object, "string array");
     TEST(json_array_get_wrapping_value(array) == array_value);
+#ifndef PARSON_NO_PARENT
     TEST(json_value_get_parent(array_value) == root_value);
+#endif
     TEST(json_value_get_parent(root_value) == NULL);
 }
 
@@ -258,6 +304,14 @@ void test_suite_3(void) {
     TEST(STREQ(json_string(json_parse_string("\"\\u20ACx\"")), "€x"));
     TEST(STREQ(json_string(json_parse_string("\"\\uD801\\uDC37x\"")), "𐐷x"));
 
+    puts("Test parsing with comments:");
+    TEST(json_value_equals(json_parse_string_with_comments("/* a */ [1, // b\n 2 /**/] // c"),
+                           json_parse_string("[1,2]")));
+    TEST(STREQ(json_string(json_parse_string_with_comments("\"/* not a comment */\"")), "/* not a comment */"));
+    TEST(json_parse_string_with_comments("[1, /* unterminated") == NULL);
+    TEST(json_parse_string_with_comments("[1 / 2]") == NULL);
+    TEST(json_parse_string("[1 /* comment */]") == NULL);
+
     puts("Testing invalid strings:");
     malloc_count = 0;
     TEST(json_parse_string(NULL) == NULL);
@@ -323,7 +377,10 @@ void test_suite_5(void) {
 
     JSON_Value *val_from_file = json_parse_file("tests/test_5.txt");
 
-    JSON_Value *val = NULL, *val_parent;
+    JSON_Value *val = NULL;
+#ifndef PARSON_NO_PARENT
+    JSON_Value *val_parent = NULL;
+#endif
     JSON_Object *obj = NULL;
     JSON_Array *interests_arr = NULL;
 
@@ -385,6 +442,7 @@ void test_suite_5(void) {
     TEST(json_array_remove(interests_arr, 0) == JSONSuccess);
     TEST(json_array_remove(interests_arr, 0) == JSONFailure); /* should be empty by now */
 
+#ifndef PARSON_NO_PARENT /* values that already have a parent can't be detected without parent pointers */
     val_parent = json_value_init_null();
     TEST(json_object_set_value(obj, "x", val_parent) == JSONSuccess);
     TEST(json_object_set_value(obj, "x", val_parent) == JSONFailure);
@@ -396,6 +454,7 @@ void test_suite_5(void) {
     val_parent = json_value_init_null();
     TEST(json_array_replace_value(interests_arr, 0, val_parent) == JSONSuccess);
     TEST(json_array_replace_value(interests_arr, 0, val_parent) == JSONFailure);
+#endif
 
     TEST(json_object_remove(obj, "interests") == JSONSuccess);
 
@@ -484,8 +543,20 @@ void test_suite_8(void) {
     const char *temp_filename = "tests/test_2_serialized.txt";
     JSON_Value *a = NULL;
     JSON_Value *b = NULL;
+    JSON_Value *c = NULL;
     char *buf = NULL;
     size_t serialization_size = 0;
+    JSON_Serialization_Options options;
+    JSON_Pretty_Options pretty;
+    static const char *number_vectors[] = {
+        "5e-324", "-5e-324", "1e-310", "2.225073858507201e-308", "2.2250738585072014e-308",
+        "1.7976931348623157e+308", "-1.7976931348623157e+308", "9007199254740992", "-9007199254740992",
+        "295147905179352830000", "9.999999999999997e+22", "1e+23", "1.0000000000000001e+23",
+        "999999999999999700000", "999999999999999900000", "1e+21", "0.000001", "0.0000010000000000000002",
+        "333333333.3333332", "333333333.33333325", "333333333.3333333", "333333333.3333334",
+        "333333333.33333343", "-0.0000033333333333333333", "1424953923781206.2"
+    };
+    size_t i = 0;
     a = json_parse_file(filename);
     TEST(json_serialize_to_file(a, temp_filename) == JSONSuccess);
     b = json_parse_file(temp_filename);
@@ -494,6 +565,115 @@ void test_suite_8(void) {
     serialization_size = json_serialization_size(a);
     buf = json_serialize_to_string(a);
     TEST((strlen(buf)+1) == serialization_size);
+    buf = (char*)malloc(serialization_size);
+    TEST(json_serialize_to_buffer(a, buf, serialization_size - 1) == JSONFailure);
+    TEST(json_serialize_to_buffer(a, buf, serialization_size) == JSONSuccess);
+    TEST(STREQ(buf, json_serialize_to_string(a)));
+    free(buf);
+
+    /* per-call options */
+    json_serialization_options_init(&options);
+    TEST(STREQ(json_serialize_to_string_with_options(a, &options), json_serialize_to_string(a)));
+    TEST(json_serialization_size_with_options(a, &options) == serialization_size);
+
+    c = json_parse_string("{\"z\":\"a/b\",\"a\":[0.1,\"\xc4\x85\xf0\x9f\x98\x80\"],\"m\":{\"y\":1,\"b\":2}}");
+    options.escape_slashes = 0;
+    options.ascii_only = 1;
+    options.sort_keys = 1;
+    buf = json_serialize_to_string_with_options(c, &options);
+    TEST(STREQ(buf, "{\"a\":[0.10000000000000001,\"\\u0105\\ud83d\\ude00\"],\"m\":{\"b\":2,\"y\":1},\"z\":\"a/b\"}"));
+    TEST(json_value_equals(json_parse_string(buf), c));
+    TEST(json_serialization_size_with_options(c, &options) == strlen(buf) + 1);
+
+    options.float_precision = 6;
+    options.escape_slashes = 1;
+    options.ascii_only = 0;
+    options.sort_keys = 0;
+    buf = json_serialize_to_string_with_options(c, &options);
+    TEST(STREQ(buf, "{\"z\":\"a\\/b\",\"a\":[0.1,\"\xc4\x85\xf0\x9f\x98\x80\"],\"m\":{\"y\":1,\"b\":2}}"));
+
+    json_pretty_options_init(&pretty);
+    pretty.indent_width = 1;
+    options.pretty = &pretty;
+    options.sort_keys = 1;
+    buf = json_serialize_to_string_with_options(json_parse_string("{\"b\":1,\"a\":[]}"), &options);
+    TEST(STREQ(buf, "{\n \"a\": [],\n \"b\": 1\n}"));
+
+    options.float_precision = 18;
+    TEST(json_serialize_to_string_with_options(c, &options) == NULL);
+    TEST(json_serialize_to_string_with_options(c, NULL) == NULL);
+
+    /* cached sizes follow mutations of nested values */
+    c = json_parse_string("{\"a\":{\"b\":[1,\"x/y\"]},\"c\":[]}");
+    TEST(json_serialization_size(c) == strlen(json_serialize_to_string(c)) + 1);
+    TEST(json_array_append_string(json_object_dotget_array(json_object(c), "a.b"), "longer string") == JSONSuccess);
+    TEST(STREQ(json_serialize_to_string(c), "{\"a\":{\"b\":[1,\"x\\/y\",\"longer string\"]},\"c\":[]}"));
+    TEST(json_serialization_size(c) == strlen(json_serialize_to_string(c)) + 1);
+    TEST(json_array_replace_number(json_object_dotget_array(json_object(c), "a.b"), 0, 12345) == JSONSuccess);
+    TEST(json_object_dotremove(json_object(c), "c") == JSONSuccess);
+    TEST(STREQ(json_serialize_to_string(c), "{\"a\":{\"b\":[12345,\"x\\/y\",\"longer string\"]}}"));
+    json_set_escape_slashes(0);
+    TEST(STREQ(json_serialize_to_string(c), "{\"a\":{\"b\":[12345,\"x/y\",\"longer string\"]}}"));
+    TEST(json_serialization_size(c) == strlen(json_serialize_to_string(c)) + 1);
+    json_set_escape_slashes(1);
+    TEST(json_object_clear(json_object_dotget_object(json_object(c), "a")) == JSONSuccess);
+    TEST(STREQ(json_serialize_to_string(c), "{\"a\":{}}"));
+    TEST(json_serialization_size(c) == 9);
+
+    /* cached output of unchanged containers */
+    c = json_parse_string("{\"s\":{\"x\":[1,2,\"a/b\"],\"y\":{\"z\":null}},\"t\":[true]}");
+    TEST(json_value_set_serialization_cache(c, 1) == JSONSuccess);
+    TEST(json_value_set_serialization_cache(json_value_init_number(1), 1) == JSONFailure);
+    buf = json_serialize_to_string(c);
+    TEST(STREQ(buf, json_serialize_to_string(c)));
+    TEST(json_object_dotset_number(json_object(c), "s.y.w", 2) == JSONSuccess);
+    TEST(STREQ(json_serialize_to_string(c), "{\"s\":{\"x\":[1,2,\"a\\/b\"],\"y\":{\"z\":null,\"w\":2}},\"t\":[true]}"));
+    json_set_escape_slashes(0);
+    TEST(json_serialization_size(c) == strlen("{\"s\":{\"x\":[1,2,\"a/b\"],\"y\":{\"z\":null,\"w\":2}},\"t\":[true]}") + 1);
+    TEST(STREQ(json_serialize_to_string(c), "{\"s\":{\"x\":[1,2,\"a/b\"],\"y\":{\"z\":null,\"w\":2}},\"t\":[true]}"));
+    json_set_escape_slashes(1);
+    json_serialization_options_init(&options);
+    options.sort_keys = 1;
+    TEST(STREQ(json_serialize_to_string_with_options(c, &options), "{\"s\":{\"x\":[1,2,\"a\\/b\"],\"y\":{\"w\":2,\"z\":null}},\"t\":[true]}"));
+    TEST(STREQ(json_serialize_to_string(c), "{\"s\":{\"x\":[1,2,\"a\\/b\"],\"y\":{\"z\":null,\"w\":2}},\"t\":[true]}"));
+    TEST(json_array_replace_null(json_object_get_array(json_object(c), "t"), 0) == JSONSuccess);
+    buf = (char*)malloc(json_serialization_size(c));
+    TEST(json_serialize_to_buffer(c, buf, json_serialization_size(c)) == JSONSuccess);
+    TEST(STREQ(buf, "{\"s\":{\"x\":[1,2,\"a\\/b\"],\"y\":{\"z\":null,\"w\":2}},\"t\":[null]}"));
+    free(buf);
+    TEST(json_value_set_serialization_cache(c, 0) == JSONSuccess);
+    TEST(STREQ(json_serialize_to_string(c), "{\"s\":{\"x\":[1,2,\"a\\/b\"],\"y\":{\"z\":null,\"w\":2}},\"t\":[null]}"));
+
+    /* canonical output, examples from RFC 8785 */
+    c = json_parse_string("{\"numbers\":[333333333.33333329,1E30,4.50,2e-3,0.000000000000000000000000001],"
+                          "\"string\":\"\\u20ac$\\u000F\\u000aA'\\u0042\\u0022\\u005c\\\\\\\"\\/\","
+                          "\"literals\":[null,true,false]}");
+    TEST(STREQ(json_serialize_to_string_canonical(c),
+               "{\"literals\":[null,true,false],\"numbers\":[333333333.3333333,1e+30,4.5,0.002,1e-27],"
+               "\"string\":\"\xe2\x82\xac$\\u000f\\nA'B\\\"\\\\\\\\\\\"/\"}"));
+    c = json_parse_string("[0,-0,1e21,1e20,0.000001,1e-7,5e-300,1.7976931348623157e308,9007199254740992,"
+                          "295147905179352830000,0.1,-1.5,123.456e-10]");
+    TEST(STREQ(json_serialize_to_string_canonical(c),
+               "[0,0,1e+21,100000000000000000000,0.000001,1e-7,5e-300,1.7976931348623157e+308,9007199254740992,"
+               "295147905179352830000,0.1,-1.5,1.23456e-8]"));
+    /* number vectors from RFC 8785 appendix B, with subnormals that need fewer than 15 digits */
+    for (i = 0; i < sizeof(number_vectors) / sizeof(number_vectors[0]); i++) {
+        c = json_value_init_number(strtod(number_vectors[i], NULL));
+        buf = json_serialize_to_string_canonical(c);
+        TEST(STREQ(buf, number_vectors[i]));
+        json_free_serialized_string(buf);
+        json_value_free(c);
+    }
+    c = json_parse_string("{\"\xef\xac\xb3\":3,\"\xf0\x9f\x98\x80\":2,\"\xe2\x82\xac\":1,\"\":0,\"a\":4,\"ab\":5}");
+    TEST(STREQ(json_serialize_to_string_canonical(c),
+               "{\"\":0,\"a\":4,\"ab\":5,\"\xe2\x82\xac\":1,\"\xf0\x9f\x98\x80\":2,\"\xef\xac\xb3\":3}"));
+    TEST(json_object_set_number(json_object(c), "aa", 6) == JSONSuccess);
+    TEST(json_object_remove(json_object(c), "") == JSONSuccess);
+    TEST(STREQ(json_serialize_to_string_canonical(c),
+               "{\"a\":4,\"aa\":6,\"ab\":5,\"\xe2\x82\xac\":1,\"\xf0\x9f\x98\x80\":2,\"\xef\xac\xb3\":3}"));
+    json_serialization_options_init(&options);
+    options.float_precision = 0;
+    TEST(STREQ(json_serialize_to_string_with_options(json_parse_string("[0.1,1e30]"), &options), "[0.1,1e+30]"));
 }
 
 void test_suite_9(void) {
@@ -503,6 +683,9 @@ void test_suite_9(void) {
     char *serialized = NULL;
     JSON_Value *a = NULL;
     JSON_Value *b = NULL;
+    JSON_Value *c = NULL;
+    JSON_Pretty_Options options;
+    char buf[64];
     size_t serialization_size = 0;
     a = json_parse_file(filename);
     TEST(json_serialize_to_file_pretty(a, temp_filename) == JSONSuccess);
@@ -516,6 +699,44 @@ void test_suite_9(void) {
     file_contents = read_file(filename);
 
     TEST(STREQ(file_contents, serialized));
+
+    /* default options produce the same output as json_serialize_to_string_pretty */
+    json_pretty_options_init(&options);
+    TEST(STREQ(file_contents, json_serialize_to_string_pretty_with_options(a, &options)));
+    TEST(json_serialization_size_pretty_with_options(a, &options) == serialization_size);
+
+    c = json_parse_string("{\"a\":[1,2,3],\"b\":{\"c\":[]}}");
+    options.indent_char = '\t';
+    options.indent_width = 1;
+    options.newline = "\r\n";
+    options.name_separator = ":";
+    serialized = json_serialize_to_string_pretty_with_options(c, &options);
+    TEST(STREQ(serialized, "{\r\n\t\"a\":[\r\n\t\t1,\r\n\t\t2,\r\n\t\t3\r\n\t],\r\n\t\"b\":{\r\n\t\t\"c\":[]\r\n\t}\r\n}"));
+    TEST((strlen(serialized) + 1) == json_serialization_size_pretty_with_options(c, &options));
+
+    json_pretty_options_init(&options);
+    options.indent_width = 2;
+    options.scalars_per_line = 4;
+    serialized = json_serialize_to_string_pretty_with_options(c, &options);
+    TEST(STREQ(serialized, "{\n  \"a\": [1, 2, 3],\n  \"b\": {\n    \"c\": []\n  }\n}"));
+    TEST(json_serialize_to_buffer_pretty_with_options(c, buf, strlen(serialized), &options) == JSONFailure);
+    TEST(json_serialize_to_buffer_pretty_with_options(c, buf, strlen(serialized) + 1, &options) == JSONSuccess);
+    TEST(strcmp(buf, serialized) == 0);
+
+    options.scalars_per_line = 2;
+    serialized = json_serialize_to_string_pretty_with_options(json_parse_string("[1,2,3,4,5]"), &options);
+    TEST(STREQ(serialized, "[\n  1, 2,\n  3, 4,\n  5\n]"));
+
+    /* indentation longer than the internal whitespace buffer */
+    options.indent_width = 200;
+    options.scalars_per_line = 0;
+    serialized = json_serialize_to_string_pretty_with_options(json_parse_string("[[1]]"), &options);
+    TEST(serialized != NULL && strlen(serialized) == 1 + 1 + 200 + 1 + 1 + 400 + 1 + 1 + 200 + 1 + 1 + 1);
+    TEST(json_value_equals(json_parse_string(serialized), json_parse_string("[[1]]")));
+
+    options.newline = "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n";
+    TEST(json_serialize_to_string_pretty_with_options(c, &options) == NULL);
+    TEST(json_serialize_to_string_pretty_with_options(c, NULL) == NULL);
 }
 
 void test_suite_10(void) {
@@ -544,7 +765,10 @@ void test_suite_10(void) {
 void test_suite_11() {
     const char * array_with_slashes = "[\"a/b/c\"]";
     const char * array_with_escaped_slashes = "[\"a\\/b\\/c\"]";
+    const char escaped_chars[] = "\"\\/\b\f\n\r\t\x01\x1f";
+    char long_string[48];
     char *serialized = NULL;
+    size_t i = 0;
     JSON_Value *value = json_parse_string(array_with_slashes);
 
     serialized = json_serialize_to_string(value);
@@ -557,6 +781,1140 @@ void test_suite_11() {
     json_set_escape_slashes(1);
     serialized = json_serialize_to_string(value);
     TEST(STREQ(array_with_escaped_slashes, serialized));
+
+    /* long strings are scanned in chunks, escapes have to be found at every offset */
+    value = json_value_init_string("abcdefghijklmnopqrstuvwxyz\"0123456789\\ABCDEFGHIJ/\n\x01\x1f\x7f\xc4\x85" "end");
+    serialized = json_serialize_to_string(value);
+    TEST(STREQ("\"abcdefghijklmnopqrstuvwxyz\\\"0123456789\\\\ABCDEFGHIJ\\/\\n\\u0001\\u001f\x7f\xc4\x85" "end\"", serialized));
+    TEST(json_value_equals(json_parse_string(serialized), value));
+    for (i = 0; i < sizeof(long_string) - 1; i++) {
+        memset(long_string, 'x', sizeof(long_string) - 1);
+        long_string[sizeof(long_string) - 1] = '\0';
+        long_string[i] = escaped_chars[i % (sizeof(escaped_chars) - 1)];
+        value = json_value_init_string(long_string);
+        serialized = json_serialize_to_string(value);
+        if (!json_value_equals(json_parse_string(serialized), value) ||
+            strlen(serialized) + 1 != json_serialization_size(value)) {
+            break;
+        }
+    }
+    TEST(i == sizeof(long_string) - 1);
+}
+
+void test_suite_12(void) {
+    const unsigned char document[] = { 0xA2, 0x61, 'a', 0x01, 0x61, 'b', 0x84, 0xF5, 0xF6, 0x20,
+                                       0xFA, 0x3F, 0xC0, 0x00, 0x00 };
+    const unsigned char big_integer[] = { 0x1B, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00 };
+    const unsigned char negative_zero[] = { 0xFA, 0x80, 0x00, 0x00, 0x00 };
+    const unsigned char half_float[] = { 0xF9, 0x3C, 0x00 };
+    const unsigned char half_infinity[] = { 0xF9, 0x7C, 0x00 };
+    const unsigned char tagged[] = { 0xC1, 0x1A, 0x5A, 0x00, 0x00, 0x00 };
+    const unsigned char huge_count[] = { 0x9B, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 };
+    const unsigned char byte_string[] = { 0x41, 0x00 };
+    const unsigned char indefinite[] = { 0x9F, 0x01, 0xFF };
+    const unsigned char integer_key[] = { 0xA1, 0x01, 0x01 };
+    const unsigned char nul_string[] = { 0x61, 0x00 };
+    const unsigned char invalid_utf8[] = { 0x61, 0xFF };
+    const unsigned char duplicate_key[] = { 0xA2, 0x61, 'a', 0x01, 0x61, 'a', 0x02 };
+    unsigned char deep[2050]; /* 2049 nested arrays, parson allows 2048 */
+    unsigned char *cbor = NULL;
+    size_t size = 0, i = 0;
+    double num = 0.0;
+    Test_Stream *stream = NULL;
+    JSON_Value *val = NULL, *val_from_cbor = NULL;
+
+    val = json_parse_string("{\"a\":1,\"b\":[true,null,-1,1.5]}");
+    TEST((cbor = json_value_to_cbor(val, &size)) != NULL);
+    TEST(size == sizeof(document) && memcmp(cbor, document, size) == 0);
+    TEST((val_from_cbor = json_value_from_cbor(cbor, size)) != NULL);
+    TEST(json_value_equals(val, val_from_cbor));
+    json_free_cbor(cbor);
+    json_value_free(val_from_cbor);
+    json_value_free(val);
+
+    val = json_parse_file("tests/test_2.txt");
+    cbor = json_value_to_cbor(val, &size);
+    TEST(json_value_equals(val, val_from_cbor = json_value_from_cbor(cbor, size)));
+    TEST(json_value_from_cbor(cbor, size - 1) == NULL);
+    json_free_cbor(cbor);
+    json_value_free(val_from_cbor);
+
+    stream = (Test_Stream*)malloc(sizeof(Test_Stream));
+    stream->length = 0;
+    stream->position = 0;
+    stream->writes = 0;
+    TEST(json_value_write_cbor(val, stream_write, stream) == JSONSuccess);
+    TEST(json_value_write_cbor(val, stream_write, stream) == JSONSuccess);
+    TEST(stream->writes == 2); /* writes are buffered */
+    TEST(json_value_equals(val, val_from_cbor = json_value_read_cbor(stream_read, stream)));
+    json_value_free(val_from_cbor);
+    TEST(json_value_equals(val, val_from_cbor = json_value_read_cbor(stream_read, stream)));
+    json_value_free(val_from_cbor);
+    TEST(json_value_read_cbor(stream_read, stream) == NULL);
+    free(stream);
+    json_value_free(val);
+
+    num = 4294967296.0;
+    val = json_value_init_number(num);
+    cbor = json_value_to_cbor(val, &size);
+    TEST(size == sizeof(big_integer) && memcmp(cbor, big_integer, size) == 0);
+    json_free_cbor(cbor);
+    json_value_free(val);
+
+    val = json_value_init_number(-0.0);
+    cbor = json_value_to_cbor(val, &size);
+    TEST(size == sizeof(negative_zero) && memcmp(cbor, negative_zero, size) == 0);
+    json_free_cbor(cbor);
+    json_value_free(val);
+
+    val = json_parse_string("[0,23,24,255,256,65536,-256,0.1,-1e300,18446744073709551616]");
+    cbor = json_value_to_cbor(val, &size);
+    TEST(size == 1 + 1 + 1 + 2 + 2 + 3 + 5 + 2 + 9 + 9 + 5);
+    TEST(cbor[2] == 0x17 && cbor[3] == 0x18 && cbor[5] == 0x18 && cbor[7] == 0x19 && cbor[10] == 0x1A);
+    TEST(cbor[15] == 0x38 && cbor[17] == 0xFB && cbor[26] == 0xFB && cbor[35] == 0xFA); /* 2^64 is an exact float */
+    TEST(json_value_equals(val, val_from_cbor = json_value_from_cbor(cbor, size)));
+    json_free_cbor(cbor);
+    json_value_free(val_from_cbor);
+    json_value_free(val);
+
+    val = json_value_init_number(-17689810717091142.0); /* -1 - n is not exact, written as a double */
+    cbor = json_value_to_cbor(val, &size);
+    json_value_free(val);
+    TEST(json_value_get_number(val = json_value_from_cbor(cbor, size)) == -17689810717091142.0);
+    json_free_cbor(cbor);
+    json_value_free(val);
+
+    TEST(json_value_get_number(val = json_value_from_cbor(half_float, sizeof(half_float))) == 1.0);
+    json_value_free(val);
+    TEST(json_value_get_number(val = json_value_from_cbor(tagged, sizeof(tagged))) == 1509949440.0);
+    json_value_free(val);
+    TEST(json_value_from_cbor(half_infinity, sizeof(half_infinity)) == NULL);
+    TEST(json_value_from_cbor(huge_count, sizeof(huge_count)) == NULL);
+    TEST(json_value_from_cbor(byte_string, sizeof(byte_string)) == NULL);
+    TEST(json_value_from_cbor(indefinite, sizeof(indefinite)) == NULL);
+    TEST(json_value_from_cbor(integer_key, sizeof(integer_key)) == NULL);
+    TEST(json_value_from_cbor(nul_string, sizeof(nul_string)) == NULL);
+    TEST(json_value_from_cbor(invalid_utf8, sizeof(invalid_utf8)) == NULL);
+    TEST(json_value_from_cbor(duplicate_key, sizeof(duplicate_key)) == NULL);
+    TEST(json_value_from_cbor(document, 0) == NULL);
+
+    for (i = 0; i < sizeof(deep) - 1; i++) {
+        deep[i] = 0x81; /* array with one item */
+    }
+    deep[sizeof(deep) - 1] = 0xF6;
+    TEST(json_value_from_cbor(deep, sizeof(deep)) == NULL);
+    TEST((val = json_value_from_cbor(deep + sizeof(deep) - 2049, 2049)) != NULL);
+    json_value_free(val);
+}
+
+void test_suite_13(void) {
+    char name[16];
+    unsigned char *image = NULL, *moved = NULL;
+    size_t size = 0, i = 0;
+    Test_Stream *stream = NULL;
+    JSON_Value *val = NULL, *copy = NULL, *big = NULL;
+    const JSON_Snapshot_Value *root = NULL, *item = NULL;
+
+    val = json_parse_file("tests/test_2.txt");
+    TEST((image = (unsigned char*)json_value_to_snapshot(val, &size)) != NULL);
+    moved = (unsigned char*)malloc(size + 1); /* images are position independent and need no alignment */
+    memcpy(moved + 1, image, size);
+    TEST((root = json_snapshot_open(moved + 1, size)) != NULL);
+    TEST(json_snapshot_get_type(root) == JSONObject);
+    TEST(json_snapshot_get_count(root) == json_object_get_count(json_object(val)));
+    TEST(STREQ(json_snapshot_get_string(json_snapshot_object_get_value(root, "string")), "lorem ipsum"));
+    TEST(json_snapshot_get_string_len(json_snapshot_object_get_value(root, "string")) == 11);
+    TEST(json_snapshot_get_number(json_snapshot_object_get_value(root, "positive one")) == 1.0);
+    TEST(json_snapshot_get_number(json_snapshot_object_get_value(root, "negative one")) == -1.0);
+    TEST(json_snapshot_get_boolean(json_snapshot_object_get_value(root, "boolean true")) == 1);
+    TEST(json_snapshot_get_boolean(json_snapshot_object_get_value(root, "boolean false")) == 0);
+    TEST(json_snapshot_get_type(json_snapshot_object_get_value(root, "null")) == JSONNull);
+    TEST(STREQ(json_snapshot_get_string(json_snapshot_object_dotget_value(root, "object.nested string")), "str"));
+    TEST(json_snapshot_get_number(json_snapshot_object_dotget_value(root, "object.nested number")) == 123);
+    TEST(json_snapshot_object_dotget_value(root, "object.missing") == NULL);
+    TEST(json_snapshot_object_get_value(root, "missing") == NULL);
+    item = json_snapshot_object_get_value(root, "string array");
+    TEST(json_snapshot_get_count(item) == 2);
+    TEST(STREQ(json_snapshot_get_string(json_snapshot_array_get_value(item, 1)), "ipsum"));
+    TEST(json_snapshot_array_get_value(item, 2) == NULL);
+    TEST(STREQ(json_snapshot_object_get_name(root, 0), json_object_get_name(json_object(val), 0)));
+    TEST(json_snapshot_get_type(json_snapshot_object_get_value_at(root, 0)) == JSONString);
+    TEST(json_snapshot_get_number(item) == 0 && json_snapshot_get_string(item) == NULL);
+    TEST(json_value_equals(val, copy = json_snapshot_to_value(root)));
+    json_value_free(copy);
+
+    stream = (Test_Stream*)malloc(sizeof(Test_Stream));
+    stream->length = 0;
+    stream->writes = 0;
+    TEST(json_value_write_snapshot(val, stream_write, stream) == JSONSuccess);
+    TEST(stream->length == size && memcmp(stream->data, image, size) == 0);
+    free(stream);
+
+    moved[1] = 'X';
+    TEST(json_snapshot_open(moved + 1, size) == NULL);
+    TEST(json_snapshot_open(image, size - 1) == NULL);
+    TEST(json_snapshot_open(image, 8) == NULL);
+    free(moved);
+    json_free_snapshot(image);
+    json_value_free(val);
+
+    big = json_value_init_array();
+    for (i = 0; i < 100; i++) { /* objects with more than 8 members get a hash table, names are stored once */
+        val = json_value_init_object();
+        for (size = 0; size < 20; size++) {
+            sprintf(name, "key%d", (int)size);
+            json_object_set_number(json_object(val), name, (double)(i * 20 + size));
+        }
+        json_array_append_value(json_array(big), val);
+    }
+    image = (unsigned char*)json_value_to_snapshot(big, &size);
+    TEST(size < 100 * (12 + 20 * 8 + 64 * 4 + 20 * 16) + 20 * 16 + 1024);
+    root = json_snapshot_open(image, size);
+    TEST(json_snapshot_get_number(json_snapshot_object_get_value(json_snapshot_array_get_value(root, 42), "key17")) == 42 * 20 + 17);
+    TEST(json_snapshot_object_get_value(json_snapshot_array_get_value(root, 42), "key20") == NULL);
+    TEST(json_snapshot_object_get_value(json_snapshot_array_get_value(root, 42), "key") == NULL);
+    TEST(json_value_equals(big, copy = json_snapshot_to_value(root)));
+    json_value_free(copy);
+    json_free_snapshot(image);
+    json_value_free(big);
+
+    TEST(json_snapshot_open(NULL, 0) == NULL);
+    TEST(json_snapshot_get_type(NULL) == JSONError);
+}
+
+void test_suite_14(void) {
+    JSON_Value *val = NULL, *copy = NULL, *other = NULL;
+    JSON_Object *obj = NULL;
+    JSON_Serialization_Options options;
+    char *before = NULL, *after = NULL, *sorted = NULL;
+
+    val = json_parse_file("tests/test_2.txt");
+    copy = json_value_deep_copy(val);
+    json_value_set_serialization_cache(val, 1);
+    before = json_serialize_to_string(val);
+    json_serialization_options_init(&options);
+    options.sort_keys = 1;
+    sorted = json_serialize_to_string_with_options(copy, &options);
+    obj = json_object(val);
+#ifndef PARSON_NO_PARENT
+    TEST(json_value_freeze(json_object_get_value(obj, "object")) == JSONFailure); /* not a root */
+#endif
+    TEST(json_value_is_frozen(val) == 0);
+    TEST(json_value_freeze(val) == JSONSuccess);
+    TEST(json_value_freeze(val) == JSONSuccess);
+    TEST(json_value_is_frozen(val));
+    TEST(json_value_is_frozen(json_object_dotget_value(obj, "object.nested array")));
+    TEST(json_value_is_frozen(NULL) == 0);
+
+    TEST(json_object_set_number(obj, "positive one", 2) == JSONFailure);
+    TEST(json_object_set_number(obj, "new", 2) == JSONFailure);
+    TEST(json_object_dotset_number(obj, "object.nested number", 2) == JSONFailure);
+    TEST(json_object_remove(obj, "string") == JSONFailure);
+    TEST(json_object_dotremove(obj, "object.nested string") == JSONFailure);
+    TEST(json_object_clear(json_object_get_object(obj, "object")) == JSONFailure);
+    TEST(json_array_append_number(json_object_get_array(obj, "string array"), 1) == JSONFailure);
+    TEST(json_array_replace_null(json_object_get_array(obj, "string array"), 0) == JSONFailure);
+    TEST(json_array_remove(json_object_get_array(obj, "string array"), 0) == JSONFailure);
+    TEST(json_array_clear(json_object_get_array(obj, "string array")) == JSONFailure);
+    TEST(json_value_set_serialization_cache(val, 0) == JSONFailure);
+    TEST(json_value_equals(val, copy));
+
+    other = json_value_init_array();
+    TEST(json_array_append_value(json_array(other), json_value_share(val)) == JSONSuccess);
+    TEST(json_value_get_parent(val) == NULL);
+    json_value_free(other);
+
+    after = json_serialize_to_string(val);
+    TEST(STREQ(before, after));
+    json_free_serialized_string(after);
+    TEST(json_serialization_size(val) == strlen(before) + 1);
+    after = json_serialize_to_string_with_options(val, &options);
+    TEST(STREQ(sorted, after));
+    json_free_serialized_string(after);
+    json_set_escape_slashes(0); /* cache key doesn't match, serialized without the cache */
+    after = json_serialize_to_string(val);
+    TEST(after != NULL && strlen(after) < strlen(before));
+    json_free_serialized_string(after);
+    json_set_escape_slashes(1);
+
+    json_value_free(copy);
+    TEST((copy = json_value_deep_copy(val)) != NULL && !json_value_is_frozen(copy));
+    TEST(json_object_set_number(json_object(copy), "new", 2) == JSONSuccess);
+    json_value_free(copy);
+    json_free_serialized_string(before);
+    json_free_serialized_string(sorted);
+    json_value_free(val);
+    TEST(json_value_freeze(NULL) == JSONFailure);
+}
+
+void test_suite_15(void) {
+    JSON_Publisher *publisher = NULL;
+    JSON_Value *first = json_parse_string("{\"version\":1}");
+    JSON_Value *second = json_parse_string("{\"version\":2}");
+    JSON_Value *third = json_parse_string("{\"version\":3}");
+    const JSON_Value *root = NULL, *old_root = NULL;
+    int token = 0, old_token = 0;
+
+    TEST((publisher = json_publisher_init(first)) != NULL);
+    TEST(json_value_is_frozen(first));
+    old_root = json_publisher_acquire(publisher, &old_token);
+    TEST(json_object_get_number(json_object(old_root), "version") == 1);
+
+    TEST(json_publisher_publish(publisher, second) == JSONSuccess);
+    TEST(json_publisher_publish(publisher, second) == JSONFailure); /* already published */
+    TEST(json_publisher_reclaim(publisher) == 1); /* first is still being read */
+    root = json_publisher_acquire(publisher, &token);
+    TEST(json_object_get_number(json_object(root), "version") == 2);
+    TEST(json_object_get_number(json_object(old_root), "version") == 1);
+    json_publisher_release(publisher, old_token);
+
+    TEST(json_publisher_publish(publisher, third) == JSONSuccess);
+    TEST(json_publisher_reclaim(publisher) == 1); /* second is still being read */
+    TEST(json_object_get_number(json_object(root), "version") == 2);
+    json_publisher_release(publisher, token);
+    TEST(json_publisher_reclaim(publisher) == 0);
+    root = json_publisher_acquire(publisher, &token);
+    TEST(json_object_get_number(json_object(root), "version") == 3);
+    json_publisher_release(publisher, token);
+
+    TEST(json_publisher_publish(publisher, json_parse_string("[4]")) == JSONSuccess);
+    TEST(json_publisher_reclaim(publisher) == 0); /* no readers, freed immediately */
+    TEST(json_publisher_publish(publisher, NULL) == JSONFailure);
+    json_publisher_free(publisher);
+
+    TEST((publisher = json_publisher_init(NULL)) != NULL);
+    TEST(json_publisher_acquire(publisher, &token) == NULL);
+    json_publisher_release(publisher, token);
+    json_publisher_free(publisher);
+}
+
+void test_suite_16(void) {
+    JSON_Value *shared = json_parse_string("{\"limits\":{\"timeout\":30,\"retries\":3},\"tags\":[\"a\",\"b\"]}");
+    JSON_Value *first = json_value_init_object(), *second = json_value_init_object();
+    JSON_Value *list = json_value_init_array(), *copy = NULL;
+    JSON_Object *first_object = json_object(first), *second_object = json_object(second);
+    char *serialized = NULL;
+
+#ifndef PARSON_NO_PARENT
+    TEST(json_value_share(json_object_get_value(json_object(shared), "limits")) == NULL); /* not a root */
+#endif
+    TEST(json_object_set_value(first_object, "defaults", json_value_share(shared)) == JSONSuccess);
+    TEST(json_object_set_value(second_object, "defaults", json_value_share(shared)) == JSONSuccess);
+    TEST(json_array_append_value(json_array(list), json_value_share(json_object_get_value(json_object(shared), "tags"))) == JSONSuccess);
+    TEST(json_value_is_frozen(shared));
+    TEST(json_value_get_parent(shared) == NULL);
+    TEST(json_value_get_parent(json_object_get_value(json_object(shared), "limits")) == NULL);
+    TEST(json_object_get_value(first_object, "defaults") == shared);
+    TEST(json_object_get_value(second_object, "defaults") == shared);
+    serialized = json_serialize_to_string(first);
+    TEST(STREQ(serialized, "{\"defaults\":{\"limits\":{\"timeout\":30,\"retries\":3},\"tags\":[\"a\",\"b\"]}}"));
+    json_free_serialized_string(serialized);
+    TEST(json_object_set_number(json_object_get_object(first_object, "defaults"), "new", 1) == JSONFailure);
+
+    /* copy on write through dot paths */
+    TEST(json_object_dotset_number(first_object, "defaults.limits.timeout", 600) == JSONSuccess);
+    TEST(json_object_dotget_number(first_object, "defaults.limits.timeout") == 600);
+    TEST(json_object_dotget_number(second_object, "defaults.limits.timeout") == 30);
+    TEST(json_object_dotget_number(json_object(shared), "limits.timeout") == 30);
+    serialized = json_serialize_to_string(first); /* the copy must not keep the old cached size */
+    TEST(STREQ(serialized, "{\"defaults\":{\"limits\":{\"timeout\":600,\"retries\":3},\"tags\":[\"a\",\"b\"]}}"));
+    json_free_serialized_string(serialized);
+    TEST(json_object_get_value(first_object, "defaults") != shared);
+    TEST(json_value_is_frozen(json_object_get_value(first_object, "defaults")) == 0);
+#ifndef PARSON_NO_PARENT
+    TEST(json_value_get_parent(json_object_get_value(first_object, "defaults")) == first);
+#endif
+    TEST(json_object_dotget_value(first_object, "defaults.tags") == json_object_dotget_value(second_object, "defaults.tags"));
+    TEST(json_object_dotremove(second_object, "defaults.missing") == JSONFailure);
+    TEST(json_object_get_value(second_object, "defaults") == shared);
+    serialized = json_serialize_to_string(second);
+    json_free_serialized_string(serialized);
+    TEST(json_object_dotremove(second_object, "defaults.limits.retries") == JSONSuccess);
+    serialized = json_serialize_to_string(second);
+    TEST(STREQ(serialized, "{\"defaults\":{\"limits\":{\"timeout\":30},\"tags\":[\"a\",\"b\"]}}"));
+    json_free_serialized_string(serialized);
+    TEST(json_object_dothas_value(second_object, "defaults.limits.retries") == 0);
+    TEST(json_object_dotget_number(json_object(shared), "limits.retries") == 3);
+    TEST(json_object_dotremove(json_object(shared), "limits.retries") == JSONFailure);
+
+    /* explicit copy on write of a single member */
+    TEST(json_array_unshare_value(json_array(list), 1) == NULL);
+    TEST((copy = json_array_unshare_value(json_array(list), 0)) != NULL);
+    TEST(json_array_append_string(json_array(copy), "c") == JSONSuccess);
+    TEST(json_array_get_count(json_object_get_array(json_object(shared), "tags")) == 2);
+    TEST(json_object_unshare_value(first_object, "missing") == NULL);
+    TEST(json_object_unshare_value(json_object(shared), "tags") == NULL);
+    TEST((copy = json_object_unshare_value(second_object, "defaults")) == json_object_get_value(second_object, "defaults"));
+    TEST(json_object_unshare_value(json_object(copy), "tags") != json_object_get_value(json_object(shared), "tags"));
+
+    /* documents holding shared subtrees can be frozen and shared themselves */
+    TEST(json_value_freeze(first) == JSONSuccess);
+    copy = json_value_deep_copy(first);
+    TEST(json_value_equals(copy, first) && !json_value_is_frozen(json_object_dotget_value(json_object(copy), "defaults.tags")));
+    json_value_free(copy);
+
+    json_value_free(shared); /* the other references keep it alive */
+    TEST(json_object_dotget_number(first_object, "defaults.limits.retries") == 3);
+    TEST(json_array_get_count(json_object_dotget_array(first_object, "defaults.tags")) == 2);
+    json_value_free(first);
+    json_value_free(second);
+    json_value_free(list);
+    TEST(json_value_share(NULL) == NULL);
+}
+
+void test_suite_17(void) {
+    JSON_Value *first = json_parse_string("{\"a\":{\"b\":1,\"c\":[1,2]},\"d\":{\"e\":true},\"f\":\"g\"}");
+    JSON_Value *second = NULL, *third = NULL, *fourth = NULL, *number = json_value_init_number(2);
+    char *serialized = NULL;
+
+    TEST(json_value_with(first, "f.x", number) == NULL); /* "f" is not an object */
+    TEST((second = json_value_with(first, "a.b", number)) != NULL);
+    TEST(json_value_is_frozen(first) && !json_value_is_frozen(second));
+    TEST(json_object_dotget_number(json_object(first), "a.b") == 1);
+    TEST(json_object_dotget_number(json_object(second), "a.b") == 2);
+    TEST(json_object_get_value(json_object(first), "d") == json_object_get_value(json_object(second), "d"));
+    TEST(json_object_dotget_value(json_object(first), "a.c") == json_object_dotget_value(json_object(second), "a.c"));
+    TEST(json_object_get_value(json_object(first), "a") != json_object_get_value(json_object(second), "a"));
+    TEST(json_object_dotset_boolean(json_object(second), "d.e", 0) == JSONSuccess); /* more changes to the new version */
+    TEST(json_object_dotget_boolean(json_object(first), "d.e") == 1);
+
+    TEST(json_value_without(second, "a.missing") == NULL);
+    TEST((third = json_value_without(second, "a.c")) != NULL);
+    TEST(json_value_is_frozen(second));
+    TEST((fourth = json_value_with(third, "h.i", json_value_init_null())) != NULL);
+    serialized = json_serialize_to_string(fourth);
+    TEST(STREQ(serialized, "{\"a\":{\"b\":2},\"d\":{\"e\":false},\"f\":\"g\",\"h\":{\"i\":null}}"));
+    json_free_serialized_string(serialized);
+    serialized = json_serialize_to_string(first);
+    TEST(STREQ(serialized, "{\"a\":{\"b\":1,\"c\":[1,2]},\"d\":{\"e\":true},\"f\":\"g\"}"));
+    json_free_serialized_string(serialized);
+
+    json_value_free(second); /* versions can be freed in any order */
+    json_value_free(first);
+    json_value_free(fourth);
+    TEST(json_object_dotget_number(json_object(third), "a.b") == 2);
+    json_value_free(third);
+    TEST(json_value_with(NULL, "a", NULL) == NULL);
+    TEST(json_value_without(NULL, "a") == NULL);
+}
+
+void test_suite_18(void) {
+    JSON_Value *val = NULL;
+    char *serialized = NULL;
+    int cached = 0, i = 0;
+
+    json_set_pool_limit(1024);
+    malloc_count = 0;
+    val = json_parse_file("tests/test_2.txt");
+    json_value_free(val);
+    cached = malloc_count;
+#ifndef PARSON_NO_POOL
+    TEST(cached > 0); /* freed blocks are kept by the pool */
+#endif
+    val = json_parse_file("tests/test_2.txt");
+    serialized = json_serialize_to_string(val);
+    json_value_free(val);
+    json_free_serialized_string(serialized);
+    TEST(malloc_count == cached); /* and reused */
+    TEST(json_pool_trim() == (size_t)cached);
+    TEST(malloc_count == 0);
+    TEST(json_pool_trim() == 0);
+
+    json_set_pool_limit(2);
+    val = json_value_init_array();
+    for (i = 0; i < 100; i++) {
+        json_array_append_string(json_array(val), "lorem ipsum");
+    }
+    json_value_free(val);
+    TEST(malloc_count <= 2 * 3); /* values, strings and the array */
+    json_pool_trim();
+    TEST(malloc_count == 0);
+    json_set_pool_limit(0);
+}
+
+void test_suite_19(void) {
+    JSON_Reclaimer *reclaimer = NULL;
+    JSON_Value *val = NULL, *shared = NULL, *other = NULL;
+    int allocated = malloc_count, before = 0;
+    size_t freed = 0, total = 0;
+
+    reclaimer = json_reclaimer_init();
+    shared = json_parse_string("{\"a\":[1,2,3]}");
+    before = malloc_count;
+    val = json_parse_file("tests/test_2.txt");
+#ifndef PARSON_NO_PARENT
+    TEST(json_value_free_deferred(reclaimer, json_object_get_value(json_object(val), "object")) == JSONFailure);
+#endif
+    TEST(json_value_free_deferred(reclaimer, val) == JSONSuccess);
+    TEST(json_reclaimer_step(reclaimer, 5) == 5);
+    TEST(malloc_count > before);
+    do {
+        freed = json_reclaimer_step(reclaimer, 5);
+        total += freed;
+    } while (freed == 5);
+    TEST(total > 20);
+    TEST(malloc_count == before);
+    TEST(json_reclaimer_step(reclaimer, 5) == 0);
+
+    other = json_value_init_array();
+    json_array_append_value(json_array(other), json_value_share(shared));
+    json_array_append_null(json_array(other));
+    TEST(json_value_free_deferred(reclaimer, json_value_share(shared)) == JSONSuccess); /* only a reference */
+    TEST(json_value_free_deferred(reclaimer, other) == JSONSuccess);
+    TEST(json_reclaimer_step(reclaimer, 100) == 3); /* null, released reference, array */
+    TEST(json_object_dotget_value(json_object(shared), "a") != NULL);
+    TEST(json_value_free_deferred(reclaimer, shared) == JSONSuccess); /* last reference */
+    TEST(json_reclaimer_step(reclaimer, 1) == 1);
+    json_reclaimer_free(reclaimer); /* frees the rest */
+    TEST(malloc_count == allocated);
+    TEST(json_value_free_deferred(NULL, NULL) == JSONFailure);
+    TEST(json_reclaimer_step(NULL, 1) == 0);
+}
+
+void test_suite_20(void) {
+    JSON_Value *val = NULL, *shared = NULL, *member = NULL;
+    const char *name = NULL, *string = NULL;
+    int allocated = malloc_count, before = 0;
+
+    val = json_parse_string_reuse(NULL, "{\"id\":1,\"name\":\"lorem ipsum\",\"tags\":[\"a\",\"b\"],\"ok\":true}");
+    TEST(val != NULL);
+    before = malloc_count;
+    member = json_object_get_value(json_object(val), "tags");
+    name = json_object_get_name(json_object(val), 1);
+    string = json_object_get_string(json_object(val), "name");
+    val = json_parse_string_reuse(val, "{\"id\":2,\"name\":\"dolor\",\"tags\":[\"c\",\"d\"],\"ok\":false}");
+    TEST(val != NULL);
+    TEST(malloc_count == before);
+    TEST(json_object_get_value(json_object(val), "tags") == member); /* same nodes and strings */
+    TEST(json_object_get_name(json_object(val), 1) == name);
+    TEST(json_object_get_string(json_object(val), "name") == string);
+    TEST(json_object_get_number(json_object(val), "id") == 2);
+    TEST(STREQ(json_object_get_string(json_object(val), "name"), "dolor"));
+    TEST(json_object_get_string(json_object(val), "tags") == NULL);
+    TEST(STREQ(json_array_get_string(json_object_get_array(json_object(val), "tags"), 1), "d"));
+    TEST(json_object_get_boolean(json_object(val), "ok") == 0);
+
+    /* different shapes reuse what matches and free the rest */
+    val = json_parse_string_reuse(val, "{\"id\":\"x\",\"name\":{\"a\":null},\"tags\":[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17]}");
+    TEST(val != NULL);
+    TEST(json_object_get_count(json_object(val)) == 3);
+    TEST(STREQ(json_object_get_string(json_object(val), "id"), "x"));
+    TEST(json_value_get_type(json_object_dotget_value(json_object(val), "name.a")) == JSONNull);
+    TEST(json_array_get_number(json_object_get_array(json_object(val), "tags"), 16) == 17);
+    val = json_parse_string_reuse(val, "[\"a very long string that does not fit\", {\"key\":true}]");
+    TEST(val != NULL);
+    TEST(STREQ(json_array_get_string(json_array(val), 0), "a very long string that does not fit"));
+    TEST(json_object_get_boolean(json_array_get_object(json_array(val), 1), "key") == 1);
+    val = json_parse_string_reuse(val, "{\"a\":1,\"a\":2}"); /* failures consume it too */
+    TEST(val == NULL);
+    TEST(malloc_count == allocated);
+
+    /* shared subtrees are released, not overwritten */
+    shared = json_parse_string("{\"b\":[1,2]}");
+    val = json_value_init_object();
+    json_object_set_value(json_object(val), "a", json_value_share(shared));
+    member = json_value_init_null();
+    json_object_set_value(json_object(val), "c", member);
+#ifndef PARSON_NO_PARENT
+    TEST(json_parse_string_reuse(member, "1") == NULL); /* not a root */
+#endif
+    val = json_parse_string_reuse(val, "{\"a\":{\"b\":[3,4]}}");
+    TEST(json_object_dotget_number(json_object(val), "a.b") == 0);
+    TEST(json_array_get_number(json_object_dotget_array(json_object(val), "a.b"), 0) == 3);
+    TEST(json_array_get_number(json_object_get_array(json_object(shared), "b"), 0) == 1);
+    TEST(json_value_is_frozen(shared));
+    json_value_free(val);
+    json_value_free(shared);
+    TEST(json_parse_string_reuse(NULL, NULL) == NULL);
+    TEST(malloc_count == allocated);
+}
+
+void test_suite_21(void) {
+    JSON_Value *val = NULL, *copy = NULL;
+    JSON_Array *records = NULL;
+    JSON_Object *first = NULL, *second = NULL, *third = NULL;
+    JSON_Reclaimer *reclaimer = NULL;
+    int allocated = malloc_count, before = 0, shared_size = 0, private_size = 0, calls = 0;
+    char *serialized = NULL;
+
+    val = json_parse_string("[{\"id\":1,\"name\":\"a\",\"tags\":[]},{\"id\":2,\"name\":\"b\",\"tags\":[]},"
+                            "{\"id\":3,\"name\":\"c\",\"tags\":[]},{\"name\":\"d\",\"id\":4},{\"id\":5,\"name\":\"e\",\"tags\":[]}]");
+    records = json_array(val);
+    first = json_array_get_object(records, 0);
+    second = json_array_get_object(records, 1);
+    third = json_array_get_object(records, 2);
+    TEST(json_object_get_name(first, 1) == json_object_get_name(second, 1)); /* same keys in the same order */
+    TEST(json_object_get_name(first, 1) == json_object_get_name(json_array_get_object(records, 4), 1));
+    TEST(json_object_get_name(first, 0) != json_object_get_name(json_array_get_object(records, 3), 1));
+    TEST(json_object_get_number(second, "id") == 2);
+    TEST(STREQ(json_object_get_string(second, "name"), "b"));
+    TEST(json_object_get_value(second, "nam") == NULL);
+    TEST(json_object_dotget_value(second, "tags.x") == NULL);
+
+    /* changing keys of one record doesn't change the others */
+    TEST(json_object_set_number(first, "id", 10) == JSONSuccess);
+    TEST(json_object_get_name(first, 1) == json_object_get_name(second, 1));
+    TEST(json_object_set_number(first, "extra", 1) == JSONSuccess);
+    TEST(json_object_get_name(first, 1) != json_object_get_name(second, 1));
+    TEST(json_object_get_count(first) == 4);
+    TEST(json_object_get_value(second, "extra") == NULL);
+    TEST(json_object_remove(second, "tags") == JSONSuccess);
+    TEST(json_object_get_count(second) == 2);
+    TEST(json_object_get_count(third) == 3);
+    TEST(json_object_has_value(third, "tags"));
+    TEST(json_object_clear(third) == JSONSuccess);
+    TEST(json_object_set_string(third, "name", "f") == JSONSuccess);
+    TEST(json_object_get_count(json_array_get_object(records, 4)) == 3);
+    TEST(json_object_get_number(json_array_get_object(records, 4), "id") == 5);
+    serialized = json_serialize_to_string(val);
+    TEST(STREQ(serialized, "[{\"id\":10,\"name\":\"a\",\"tags\":[],\"extra\":1},{\"id\":2,\"name\":\"b\"},{\"name\":\"f\"},"
+                           "{\"name\":\"d\",\"id\":4},{\"id\":5,\"name\":\"e\",\"tags\":[]}]"));
+    json_free_serialized_string(serialized);
+    copy = json_value_deep_copy(val);
+    TEST(json_value_equals(val, copy));
+    json_value_free(copy);
+    json_value_free(val);
+    TEST(malloc_count == allocated);
+
+    /* records with the same keys take fewer allocations, also after reuse */
+    before = malloc_count;
+    val = json_parse_string("[{\"a\":1,\"b\":2},{\"c\":3,\"d\":4},{\"e\":5,\"f\":6},{\"g\":7,\"h\":8}]");
+    private_size = malloc_count - before;
+    json_value_free(val);
+    val = json_parse_string("[{\"a\":1,\"b\":2},{\"a\":3,\"b\":4},{\"a\":5,\"b\":6},{\"a\":7,\"b\":8}]");
+    shared_size = malloc_count - before;
+    TEST(shared_size < private_size);
+    val = json_parse_string_reuse(val, "[{\"a\":1,\"b\":2},{\"a\":3,\"b\":4},{\"a\":5,\"b\":6},{\"a\":7,\"b\":8}]");
+    TEST(malloc_count - before == shared_size);
+    TEST(json_object_get_name(json_array_get_object(json_array(val), 0), 1) ==
+         json_object_get_name(json_array_get_object(json_array(val), 3), 1));
+    TEST(json_object_get_number(json_array_get_object(json_array(val), 3), "b") == 8);
+    reclaimer = json_reclaimer_init();
+    TEST(json_value_free_deferred(reclaimer, val) == JSONSuccess);
+    json_reclaimer_free(reclaimer);
+    TEST(malloc_count == allocated);
+
+    /* reused records keep their shape, only the shape table is allocated */
+    val = json_parse_string("[{\"a\":1,\"b\":2},{\"a\":3,\"b\":4},{\"a\":5,\"b\":6}]");
+    calls = malloc_calls;
+    val = json_parse_string_reuse(val, "[{\"a\":9,\"b\":8},{\"a\":7,\"b\":6},{\"a\":5,\"b\":4}]");
+    TEST(malloc_calls - calls == 1);
+    records = json_array(val);
+    TEST(json_object_get_name(json_array_get_object(records, 0), 1) ==
+         json_object_get_name(json_array_get_object(records, 2), 1));
+    TEST(json_object_get_number(json_array_get_object(records, 2), "a") == 5);
+    TEST(json_object_get_number(json_array_get_object(records, 2), "b") == 4);
+
+    /* records with other keys get their own names, new records share the kept shape */
+    val = json_parse_string_reuse(val, "[{\"a\":1,\"b\":2},{\"a\":3,\"c\":4},{\"a\":5},{\"\\u0061\":7,\"b\":8}]");
+    records = json_array(val);
+    serialized = json_serialize_to_string(val);
+    TEST(STREQ(serialized, "[{\"a\":1,\"b\":2},{\"a\":3,\"c\":4},{\"a\":5},{\"a\":7,\"b\":8}]"));
+    json_free_serialized_string(serialized);
+    TEST(json_object_get_value(json_array_get_object(records, 1), "b") == NULL);
+    TEST(json_object_get_count(json_array_get_object(records, 2)) == 1);
+    TEST(json_object_get_name(json_array_get_object(records, 0), 1) ==
+         json_object_get_name(json_array_get_object(records, 3), 1));
+    TEST(json_object_set_number(json_array_get_object(records, 1), "d", 5) == JSONSuccess);
+    TEST(json_object_get_number(json_array_get_object(records, 1), "d") == 5);
+    json_value_free(val);
+    TEST(malloc_count == allocated);
+}
+
+void test_suite_22(void) {
+    JSON_Value *val = NULL, *copy = NULL;
+    JSON_Compact_Value *doc = NULL;
+    const JSON_Compact_Value *object = NULL, *array = NULL;
+    size_t size = 0, records_size = 0;
+    int i = 0;
+
+    val = json_parse_file("tests/test_2.txt");
+    doc = json_value_to_compact(val, &size);
+    TEST(doc != NULL && size > 0);
+    TEST(json_compact_get_type(doc) == JSONObject);
+    TEST(STREQ(json_compact_get_string(json_compact_object_get_value(doc, "string")), "lorem ipsum"));
+    TEST(STREQ(json_compact_get_string(json_compact_object_get_value(doc, "utf string")), "lorem ipsum"));
+    TEST(json_compact_get_number(json_compact_object_get_value(doc, "positive one")) == 1.0);
+    TEST(json_compact_get_number(json_compact_object_get_value(doc, "negative one")) == -1.0);
+    TEST(json_compact_get_boolean(json_compact_object_get_value(doc, "boolean true")) == 1);
+    TEST(json_compact_get_boolean(json_compact_object_get_value(doc, "boolean false")) == 0);
+    TEST(json_compact_get_type(json_compact_object_get_value(doc, "null")) == JSONNull);
+    TEST(json_compact_object_get_value(doc, "lorem") == NULL);
+    TEST(json_compact_get_boolean(json_compact_object_dotget_value(doc, "object.nested true")) == 1);
+    TEST(json_compact_object_dotget_value(doc, "object.nested true.x") == NULL);
+    array = json_compact_object_get_value(doc, "string array");
+    TEST(json_compact_get_count(array) == 2);
+    TEST(STREQ(json_compact_get_string(json_compact_array_get_value(array, 1)), "ipsum"));
+    TEST(json_compact_array_get_value(array, 2) == NULL);
+    object = json_compact_object_get_value(doc, "object");
+    TEST(json_compact_get_count(object) == json_object_get_count(json_object_get_object(json_object(val), "object")));
+    TEST(STREQ(json_compact_object_get_name(object, 0), json_object_get_name(json_object_get_object(json_object(val), "object"), 0)));
+    TEST(json_compact_object_get_value_at(object, 100) == NULL);
+    copy = json_compact_to_value(doc);
+    TEST(json_value_equals(val, copy));
+    json_value_free(copy);
+    json_free_compact(doc);
+    json_value_free(val);
+
+    /* numbers take one slot, keys shared by records are stored once */
+    val = json_value_init_array();
+    for (i = 0; i < 1000; i++) {
+        json_array_append_number(json_array(val), i - 500.25);
+    }
+    doc = json_value_to_compact(val, &size);
+    TEST(size == 8 * (2 + 1000));
+    TEST(json_compact_get_number(json_compact_array_get_value(doc, 999)) == 499 - 0.25);
+    TEST(json_compact_get_string(json_compact_array_get_value(doc, 0)) == NULL);
+    TEST(json_compact_get_boolean(doc) == -1);
+    json_free_compact(doc);
+    json_value_free(val);
+    val = json_parse_string("[{\"id\":1,\"name\":\"a\"},{\"id\":2,\"name\":\"b\"},{\"id\":3,\"name\":\"c\"}]");
+    doc = json_value_to_compact(val, &records_size);
+    TEST(records_size == 8 * (2 + 3 + 3 * 5) + 3 + 5 + 3 * 2);
+    TEST(STREQ(json_compact_get_string(json_compact_object_get_value(json_compact_array_get_value(doc, 2), "name")), "c"));
+    TEST(json_compact_get_number(json_compact_object_get_value(json_compact_array_get_value(doc, 1), "id")) == 2);
+    json_free_compact(doc);
+    json_value_free(val);
+
+    TEST(json_value_to_compact(NULL, NULL) == NULL);
+    TEST(json_compact_get_type(NULL) == JSONError);
+    TEST(json_compact_to_value(NULL) == NULL);
+    TEST(json_compact_object_get_value(NULL, "a") == NULL);
+    TEST(json_compact_object_dotget_value(NULL, "a.b") == NULL);
+    TEST(json_compact_get_count(NULL) == 0);
+}
+
+void test_suite_23(void) {
+    JSON_Value *val = NULL, *shared = NULL, *nested = NULL;
+    JSON_Cursor *cursor = NULL;
+    int allocated = malloc_count;
+    size_t count = 0, i = 0;
+
+    val = json_parse_file("tests/test_2.txt");
+    cursor = json_cursor_init(val);
+    TEST(cursor != NULL);
+    TEST(json_cursor_value(cursor) == val);
+    TEST(json_cursor_parent(cursor) == NULL);
+    TEST(json_cursor_depth(cursor) == 0);
+    TEST(json_cursor_name(cursor) == NULL);
+    TEST(json_cursor_up(cursor) == JSONFailure);
+    TEST(json_cursor_member(cursor, "object") == JSONSuccess);
+    TEST(json_cursor_member(cursor, "nested array") == JSONSuccess);
+    TEST(json_cursor_down(cursor, 1) == JSONSuccess);
+    TEST(STREQ(json_value_get_string(json_cursor_value(cursor)), "ipsum"));
+    TEST(json_cursor_depth(cursor) == 3);
+    TEST(json_cursor_index(cursor) == 1);
+    TEST(json_cursor_name(cursor) == NULL);
+    TEST(json_cursor_down(cursor, 0) == JSONFailure); /* not a container */
+    TEST(json_cursor_up(cursor) == JSONSuccess);
+    TEST(STREQ(json_cursor_name(cursor), "nested array"));
+    TEST(json_cursor_parent(cursor) == json_object_get_value(json_object(val), "object"));
+    TEST(json_cursor_down(cursor, 2) == JSONFailure);
+    TEST(json_cursor_member(cursor, "lorem") == JSONFailure);
+    TEST(json_cursor_depth(cursor) == 2);
+
+    /* pre-order walk visits every value once */
+    count = 1;
+    TEST(json_cursor_seek(cursor, val) == JSONSuccess);
+    while (json_cursor_next(cursor) == JSONSuccess) {
+        count++;
+    }
+    TEST(count == 48);
+    TEST(json_cursor_value(cursor) == json_object_get_value(json_object(val), "empty array"));
+
+    /* parents found from the root */
+    nested = json_object_dotget_value(json_object(val), "object.nested object.lorem");
+    TEST(json_cursor_seek(cursor, nested) == JSONSuccess);
+    TEST(json_cursor_depth(cursor) == 3);
+    TEST(json_cursor_parent(cursor) == json_object_dotget_value(json_object(val), "object.nested object"));
+    TEST(STREQ(json_cursor_name(cursor), "lorem"));
+    shared = json_value_init_null();
+    TEST(json_cursor_seek(cursor, shared) == JSONFailure);
+    TEST(json_cursor_value(cursor) == val);
+    json_value_free(shared);
+    json_cursor_free(cursor);
+    json_value_free(val);
+
+    /* a shared subtree has a different parent in every document */
+    shared = json_parse_string("{\"b\":[1,2]}");
+    val = json_value_init_array();
+    for (i = 0; i < 3; i++) {
+        json_array_append_value(json_array(val), json_value_share(shared));
+    }
+    cursor = json_cursor_init(val);
+    TEST(json_cursor_down(cursor, 2) == JSONSuccess);
+    TEST(json_cursor_value(cursor) == shared);
+    TEST(json_cursor_index(cursor) == 2);
+    TEST(json_cursor_parent(cursor) == val);
+    TEST(json_cursor_seek(cursor, json_object_get_value(json_object(shared), "b")) == JSONSuccess);
+    TEST(json_cursor_index(cursor) == 0 && json_cursor_depth(cursor) == 2);
+    for (i = 0; i < 100; i++) { /* deeper than the starting capacity */
+        nested = json_value_init_array();
+        json_array_append_value(json_array(nested), val);
+        val = nested;
+    }
+    json_cursor_free(cursor);
+    cursor = json_cursor_init(val);
+    count = 0;
+    while (json_cursor_next(cursor) == JSONSuccess) {
+        count++;
+    }
+    TEST(count == 100 + 3 * 4);
+    TEST(json_cursor_depth(cursor) == 103);
+    json_cursor_free(cursor);
+    json_value_free(val);
+    json_value_free(shared);
+    TEST(malloc_count == allocated);
+
+    TEST(json_cursor_init(NULL) == NULL);
+    TEST(json_cursor_value(NULL) == NULL);
+    TEST(json_cursor_parent(NULL) == NULL);
+    TEST(json_cursor_depth(NULL) == 0);
+    TEST(json_cursor_name(NULL) == NULL);
+    TEST(json_cursor_next(NULL) == JSONFailure);
+    TEST(json_cursor_seek(NULL, NULL) == JSONFailure);
+    json_cursor_free(NULL);
+}
+
+void test_suite_24(void) {
+    JSON_Value *val = NULL, *records = NULL;
+    JSON_Array *array = NULL;
+    JSON_Object *object = NULL;
+    int allocated = malloc_count, calls = 0;
+    char name[32];
+    int i = 0;
+
+    /* presized containers allocate their storage once */
+    calls = malloc_calls;
+    val = json_value_init_array_with_capacity(1000);
+    array = json_array(val);
+    for (i = 0; i < 1000; i++) {
+        json_array_append_number(array, i);
+    }
+    TEST(json_array_get_count(array) == 1000);
+    TEST(malloc_calls - calls <= 3 + 1000);
+    TEST(json_array_reserve(array, 10) == JSONSuccess);
+    json_array_remove(array, 999);
+    TEST(json_array_shrink_to_fit(array) == JSONSuccess);
+    TEST(json_array_get_number(array, 998) == 998);
+    TEST(json_array_append_number(array, 1) == JSONSuccess);
+    json_array_clear(array);
+    TEST(json_array_shrink_to_fit(array) == JSONSuccess);
+    TEST(json_array_append_null(array) == JSONSuccess);
+    json_value_free(val);
+
+    val = json_value_init_object();
+    object = json_object(val);
+    TEST(json_object_reserve(object, 100) == JSONSuccess);
+    calls = malloc_calls;
+    for (i = 0; i < 100; i++) {
+        sprintf(name, "key%d", i);
+        json_object_set_number(object, name, i);
+    }
+    TEST(malloc_calls - calls <= 2 * 100);
+    json_object_remove(object, "key0");
+    TEST(json_object_shrink_to_fit(object) == JSONSuccess);
+    TEST(json_object_get_number(object, "key99") == 99);
+    TEST(json_object_set_number(object, "key0", 0) == JSONSuccess);
+    json_object_clear(object);
+    TEST(json_object_shrink_to_fit(object) == JSONSuccess);
+    TEST(json_object_set_null(object, "a") == JSONSuccess);
+    json_value_free(val);
+
+    /* records with shared keys, reserving copies the keys, shrinking keeps them shared */
+    records = json_parse_string("[{\"id\":1,\"name\":\"a\"},{\"id\":2,\"name\":\"b\"}]");
+    object = json_array_get_object(json_array(records), 0);
+    TEST(json_object_shrink_to_fit(object) == JSONSuccess);
+    TEST(json_object_get_name(object, 1) == json_object_get_name(json_array_get_object(json_array(records), 1), 1));
+    TEST(json_object_reserve(object, 8) == JSONSuccess);
+    TEST(json_object_get_name(object, 1) != json_object_get_name(json_array_get_object(json_array(records), 1), 1));
+    TEST(json_object_set_number(object, "extra", 3) == JSONSuccess);
+    TEST(json_object_get_number(json_array_get_object(json_array(records), 1), "id") == 2);
+    json_value_freeze(records);
+    TEST(json_object_reserve(object, 16) == JSONFailure);
+    TEST(json_array_shrink_to_fit(json_array(records)) == JSONFailure);
+    json_value_free(records);
+    TEST(malloc_count == allocated);
+
+    TEST(json_array_reserve(NULL, 1) == JSONFailure);
+    TEST(json_array_shrink_to_fit(NULL) == JSONFailure);
+    TEST(json_object_reserve(NULL, 1) == JSONFailure);
+    TEST(json_object_shrink_to_fit(NULL) == JSONFailure);
+}
+
+void test_suite_25(void) {
+    JSON_Value *val = NULL;
+    JSON_Array *array = NULL;
+    double numbers[1000], read_numbers[1000];
+    const char *strings[] = {"lorem", "ipsum", "dolor"}, *read_strings[4], *invalid[2];
+    int booleans[] = {1, 0, 7}, read_booleans[4];
+    int allocated = malloc_count;
+    size_t i = 0;
+    char *serialized = NULL;
+    double zero = 0.0;
+
+    for (i = 0; i < 1000; i++) {
+        numbers[i] = (double)i / 4;
+    }
+    val = json_value_init_array();
+    array = json_array(val);
+    TEST(json_array_append_numbers(array, numbers, 1000) == JSONSuccess);
+    TEST(json_array_get_count(array) == 1000);
+    TEST(json_array_get_number(array, 999) == 249.75);
+    TEST(json_array_get_numbers(array, read_numbers, 1000) == 1000);
+    TEST(memcmp(numbers, read_numbers, sizeof(numbers)) == 0);
+    TEST(json_array_get_numbers(array, read_numbers, 10) == 10);
+    TEST(json_array_get_strings(array, read_strings, 4) == 0);
+    json_value_free(val);
+
+    val = json_value_init_array();
+    array = json_array(val);
+    json_array_append_null(array);
+    serialized = json_serialize_to_string(val); /* fills the cache */
+    TEST(json_array_append_strings(array, strings, 3) == JSONSuccess);
+    TEST(json_array_append_booleans(array, booleans, 3) == JSONSuccess);
+    json_free_serialized_string(serialized);
+    serialized = json_serialize_to_string(val);
+    TEST(STREQ(serialized, "[null,\"lorem\",\"ipsum\",\"dolor\",true,false,true]"));
+    json_free_serialized_string(serialized);
+    TEST(json_array_get_strings(array, read_strings, 4) == 0); /* starts with null */
+    json_array_remove(array, 0);
+    TEST(json_array_get_strings(array, read_strings, 4) == 3);
+    TEST(read_strings[2] == json_array_get_string(array, 2));
+    TEST(json_array_get_booleans(json_array(val), read_booleans, 4) == 0);
+#ifndef PARSON_NO_PARENT
+    TEST(json_value_get_parent(json_array_get_value(array, 5)) == val);
+#endif
+
+    /* invalid members leave the array as it was */
+    invalid[0] = "valid";
+    invalid[1] = NULL;
+    TEST(json_array_append_strings(array, invalid, 2) == JSONFailure);
+    numbers[500] = zero / zero; /* NaN */
+    TEST(json_array_append_numbers(array, numbers, 1000) == JSONFailure);
+    TEST(json_array_get_count(array) == 6);
+    TEST(json_array_append_numbers(array, NULL, 0) == JSONSuccess);
+    TEST(json_array_append_numbers(array, NULL, 1) == JSONFailure);
+    json_value_freeze(val);
+    TEST(json_array_append_booleans(array, booleans, 1) == JSONFailure);
+    json_value_free(val);
+    TEST(malloc_count == allocated);
+
+    val = json_parse_string("[true,false,true,1]");
+    TEST(json_array_get_booleans(json_array(val), read_booleans, 4) == 3);
+    TEST(read_booleans[0] == 1 && read_booleans[1] == 0 && read_booleans[2] == 1);
+    json_value_free(val);
+    TEST(json_array_get_numbers(NULL, read_numbers, 1) == 0);
+    TEST(json_array_append_numbers(NULL, numbers, 1) == JSONFailure);
+}
+
+void test_suite_26(void) {
+    JSON_Value *val = NULL, *shared = NULL, *values[3], *member = NULL;
+    JSON_Array *array = NULL;
+    int allocated = malloc_count;
+    double numbers[5] = {0, 1, 2, 3, 4};
+    char *serialized = NULL;
+    size_t i = 0;
+
+    val = json_value_init_array();
+    array = json_array(val);
+    json_array_append_numbers(array, numbers, 5);
+    TEST(json_array_insert_value(array, 0, json_value_init_string("first")) == JSONSuccess);
+    TEST(json_array_insert_value(array, 3, json_value_init_null()) == JSONSuccess);
+    TEST(json_array_insert_value(array, 7, json_value_init_boolean(1)) == JSONSuccess); /* appends */
+    serialized = json_serialize_to_string(val);
+    TEST(STREQ(serialized, "[\"first\",0,1,null,2,3,4,true]"));
+    json_free_serialized_string(serialized);
+    member = json_value_init_null();
+    TEST(json_array_insert_value(array, 9, member) == JSONFailure);
+#ifndef PARSON_NO_PARENT
+    TEST(json_array_insert_value(array, 0, json_array_get_value(array, 1)) == JSONFailure);
+#endif
+    TEST(json_array_get_count(array) == 8);
+
+    TEST(json_array_erase_range(array, 2, 3) == JSONSuccess);
+    serialized = json_serialize_to_string(val);
+    TEST(STREQ(serialized, "[\"first\",0,3,4,true]"));
+    json_free_serialized_string(serialized);
+    TEST(json_array_erase_range(array, 4, 2) == JSONFailure);
+    TEST(json_array_erase_range(array, 5, 0) == JSONSuccess);
+    TEST(json_array_erase_range(array, 6, 0) == JSONFailure);
+    TEST(json_array_remove(array, 0) == JSONSuccess);
+    TEST(json_array_get_number(array, 0) == 0 && json_array_get_number(array, 1) == 3); /* order kept */
+
+    /* splice replaces a range, shared values keep their parent */
+    shared = json_parse_string("{\"a\":1}");
+    json_value_freeze(shared);
+    values[0] = member;
+    values[1] = json_value_share(shared);
+    values[2] = json_value_init_number(9);
+    TEST(json_array_splice(array, 1, 2, values, 3) == JSONSuccess);
+    serialized = json_serialize_to_string(val);
+    TEST(STREQ(serialized, "[0,null,{\"a\":1},9,true]"));
+    json_free_serialized_string(serialized);
+#ifndef PARSON_NO_PARENT
+    TEST(json_value_get_parent(member) == val);
+    TEST(json_value_get_parent(shared) == NULL);
+    TEST(json_array_splice(array, 0, 1, values, 1) == JSONFailure); /* member already has a parent */
+#endif
+    values[0] = json_value_init_null();
+    values[1] = values[0];
+    TEST(json_array_splice(array, 0, 5, values, 2) == JSONFailure); /* it would be freed twice */
+    serialized = json_serialize_to_string(val);
+    TEST(STREQ(serialized, "[0,null,{\"a\":1},9,true]"));
+    json_free_serialized_string(serialized);
+    values[1] = NULL;
+    TEST(json_array_splice(array, 0, 5, values, 2) == JSONFailure);
+    TEST(json_array_get_count(array) == 5);
+    TEST(json_array_splice(array, 0, 5, values, 1) == JSONSuccess); /* replaces everything */
+    TEST(json_array_get_count(array) == 1 && json_value_get_type(json_array_get_value(array, 0)) == JSONNull);
+    for (i = 0; i < 100; i++) {
+        TEST(json_array_insert_value(array, 1, json_value_init_number((double)i)) == JSONSuccess);
+    }
+    TEST(json_array_get_number(array, 1) == 99 && json_array_get_number(array, 100) == 0);
+    TEST(json_array_erase_range(array, 0, 101) == JSONSuccess);
+    TEST(json_array_get_count(array) == 0);
+    TEST(json_array_splice(array, 0, 0, NULL, 0) == JSONSuccess);
+    TEST(json_array_splice(array, 0, 0, NULL, 1) == JSONFailure);
+    json_value_freeze(val);
+    values[0] = json_value_init_null();
+    TEST(json_array_insert_value(array, 0, values[0]) == JSONFailure);
+    TEST(json_array_erase_range(array, 0, 0) == JSONFailure);
+    json_value_free(values[0]);
+    json_value_free(val);
+    json_value_free(shared);
+    TEST(malloc_count == allocated);
+
+    TEST(json_array_insert_value(NULL, 0, NULL) == JSONFailure);
+    TEST(json_array_erase_range(NULL, 0, 0) == JSONFailure);
+}
+
+void test_suite_27(void) {
+    JSON_Value *val = NULL, *records = NULL;
+    JSON_Object *object = NULL, *second = NULL;
+    const char *strip[] = {"b", "missing", "d", "b"}, *absent[] = {"x", "y"};
+    int allocated = malloc_count;
+    char *serialized = NULL;
+
+    val = json_parse_string("{\"a\":1,\"b\":2,\"c\":3,\"d\":4,\"e\":5}");
+    object = json_object(val);
+    TEST(json_object_remove_ordered(object, "a") == JSONSuccess);
+    TEST(json_object_remove_ordered(object, "a") == JSONFailure);
+    TEST(json_object_remove_ordered(object, NULL) == JSONFailure);
+    serialized = json_serialize_to_string(val);
+    TEST(STREQ(serialized, "{\"b\":2,\"c\":3,\"d\":4,\"e\":5}"));
+    json_free_serialized_string(serialized);
+    TEST(json_object_remove(object, "b") == JSONSuccess); /* moves the last pair */
+    TEST(STREQ(json_object_get_name(object, 0), "e"));
+    TEST(json_object_remove_ordered(object, "e") == JSONSuccess);
+    TEST(json_object_remove_ordered(object, "d") == JSONSuccess);
+    TEST(json_object_get_count(object) == 1 && json_object_get_number(object, "c") == 3);
+    json_value_free(val);
+
+    /* one pass keeps the order of what's left */
+    val = json_parse_string("{\"a\":1,\"b\":[2],\"c\":3,\"d\":{\"x\":4},\"e\":5}");
+    object = json_object(val);
+    TEST(json_object_remove_many(object, strip, 4) == JSONSuccess);
+    serialized = json_serialize_to_string(val);
+    TEST(STREQ(serialized, "{\"a\":1,\"c\":3,\"e\":5}"));
+    json_free_serialized_string(serialized);
+    TEST(json_object_remove_many(object, absent, 2) == JSONSuccess);
+    TEST(json_object_get_count(object) == 3);
+    TEST(json_object_remove_many(object, NULL, 0) == JSONSuccess);
+    absent[1] = NULL;
+    TEST(json_object_remove_many(object, absent, 2) == JSONFailure);
+    json_value_free(val);
+
+    /* records with shared keys only copy them when something is removed */
+    records = json_parse_string("[{\"id\":1,\"b\":2,\"d\":3},{\"id\":4,\"b\":5,\"d\":6}]");
+    object = json_array_get_object(json_array(records), 0);
+    second = json_array_get_object(json_array(records), 1);
+    absent[1] = "y";
+    TEST(json_object_remove_many(object, absent, 2) == JSONSuccess);
+    TEST(json_object_get_name(object, 0) == json_object_get_name(second, 0));
+    TEST(json_object_remove_many(object, strip, 4) == JSONSuccess);
+    TEST(json_object_get_count(object) == 1 && json_object_get_number(object, "id") == 1);
+    TEST(json_object_remove_ordered(second, "id") == JSONSuccess);
+    TEST(STREQ(json_object_get_name(second, 0), "b") && STREQ(json_object_get_name(second, 1), "d"));
+    json_value_freeze(records);
+    TEST(json_object_remove_many(object, strip, 1) == JSONFailure);
+    TEST(json_object_remove_ordered(second, "b") == JSONFailure);
+    json_value_free(records);
+    TEST(malloc_count == allocated);
+    TEST(json_object_remove_many(NULL, strip, 1) == JSONFailure);
+}
+
+void test_suite_28(void) {
+    JSON_Value *source = NULL, *target = NULL, *taken = NULL, *shared = NULL, *original = NULL;
+    JSON_Object *object = NULL;
+    JSON_Array *array = NULL;
+    int allocated = malloc_count;
+    char *serialized = NULL;
+
+    source = json_parse_file("tests/test_2.txt");
+    target = json_value_init_object();
+    object = json_object(source);
+
+    /* subtrees are moved, not copied */
+    original = json_object_get_value(object, "object");
+    taken = json_object_take_value(object, "object");
+    TEST(taken == original && json_value_get_parent(taken) == NULL);
+    TEST(json_object_get_value(object, "object") == NULL);
+    TEST(json_object_set_value(json_object(target), "moved", taken) == JSONSuccess);
+    taken = json_object_dottake_value(json_object(target), "moved.nested array");
+    TEST(STREQ(json_array_get_string(json_array(taken), 1), "ipsum"));
+    TEST(json_object_dotget_value(json_object(target), "moved.nested array") == NULL);
+    array = json_object_get_array(object, "x^2 array");
+    TEST(json_array_append_value(array, taken) == JSONSuccess);
+    taken = json_array_take_value(array, 0);
+    TEST(json_value_get_number(taken) == 0);
+    TEST(json_array_get_number(array, 0) == 1); /* order kept */
+    TEST(json_array_take_value(array, 11) == NULL);
+    TEST(json_object_set_value(json_object(target), "zero", taken) == JSONSuccess);
+    TEST(json_object_take_value(object, "lorem") == NULL);
+    TEST(json_object_dottake_value(object, "string.x") == NULL);
+
+#ifndef PARSON_NO_PARENT
+    taken = json_value_detach(json_object_dotget_value(json_object(target), "moved.nested object"));
+    TEST(taken != NULL && json_value_get_parent(taken) == NULL);
+    TEST(json_object_dotget_value(json_object(target), "moved.nested object") == NULL);
+    TEST(json_value_detach(taken) == taken); /* already a root */
+    TEST(json_array_append_value(array, taken) == JSONSuccess);
+    taken = json_value_detach(json_array_get_value(array, 9));
+    TEST(json_value_get_number(taken) == 100);
+    TEST(json_array_get_count(array) == 11);
+    json_value_free(taken);
+#else
+    TEST(json_value_detach(target) == NULL);
+#endif
+    serialized = json_serialize_to_string(target);
+    TEST(strstr(serialized, "nested array") == NULL && strstr(serialized, "\"zero\":0") != NULL);
+    json_free_serialized_string(serialized);
+
+    /* shared subtrees can be moved, frozen ones can't be taken apart */
+    shared = json_parse_string("{\"a\":[1,2]}");
+    json_value_freeze(shared);
+    TEST(json_object_set_value(json_object(target), "shared", json_value_share(shared)) == JSONSuccess);
+    taken = json_object_take_value(json_object(target), "shared");
+    TEST(taken == shared);
+    TEST(json_object_take_value(json_object(shared), "a") == NULL);
+    TEST(json_array_take_value(json_object_get_array(json_object(shared), "a"), 0) == NULL);
+    TEST(json_value_detach(json_object_get_value(json_object(shared), "a")) == NULL);
+    TEST(json_object_set_value(json_object(target), "again", taken) == JSONSuccess);
+    taken = json_object_dottake_value(json_object(target), "again.a"); /* copy on write, "a" stays shared */
+    TEST(taken == json_object_get_value(json_object(shared), "a") && json_value_is_frozen(taken));
+    TEST(json_object_get_count(json_object_get_object(json_object(target), "again")) == 0);
+    TEST(json_array_get_count(json_object_get_array(json_object(shared), "a")) == 2);
+    json_value_free(taken);
+    json_value_free(shared);
+    json_value_free(source);
+    json_value_free(target);
+    TEST(malloc_count == allocated);
+
+    TEST(json_object_take_value(NULL, "a") == NULL);
+    TEST(json_object_dottake_value(NULL, "a.b") == NULL);
+    TEST(json_array_take_value(NULL, 0) == NULL);
+    TEST(json_value_detach(NULL) == NULL);
 }
 
 void print_commits_info(const char *username, const char *repo) {
@@ -666,10 +2024,32 @@ static char * read_file(const char * filename) {
     return file_contents;
 }
 
+static JSON_Status stream_write(void *context, const void *data, size_t size) {
+    Test_Stream *stream = (Test_Stream*)context;
+    if (size > sizeof(stream->data) - stream->length) {
+        return JSONFailure;
+    }
+    memcpy(stream->data + stream->length, data, size);
+    stream->length += size;
+    stream->writes++;
+    return JSONSuccess;
+}
+
+static JSON_Status stream_read(void *context, void *data, size_t size) {
+    Test_Stream *stream = (Test_Stream*)context;
+    if (size > stream->length - stream->position) {
+        return JSONFailure;
+    }
+    memcpy(data, stream->data + stream->position, size);
+    stream->position += size;
+    return JSONSuccess;
+}
+
 static void *counted_malloc(size_t size) {
     void *res = malloc(size);
     if (res != NULL) {
         malloc_count++;
+        malloc_calls++;
     }
     return res;
 }
@@ -0,0 +1,249 @@
+/*
+ Parson ( http://kgabis.github.com/parson/ )
+ Copyright (c) 2012 - 2017 Krzysztof Gabis
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+*/
+
+/* Concurrent stress test and benchmark for frozen values, publishers and shared subtrees, needs POSIX threads.
+   Build and run with "make test_threads", add -fsanitize=thread to check for data races. */
+
+#include "parson.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#define TEST_THREADS    8
+#define TEST_ITERATIONS 200
+#define TEST_SECTIONS   64
+#define TEST_MEMBERS    32
+#define TEST_VERSIONS   2000
+#define TEST_REQUESTS   2000
+
+static JSON_Value *root;
+static char *expected_compact;
+static char *expected_sorted;
+static size_t expected_size;
+static JSON_Publisher *publisher;
+static JSON_Reclaimer *reclaimer;
+
+static void * reader_thread(void *arg);
+static void * publisher_reader_thread(void *arg);
+static void * request_thread(void *arg);
+static JSON_Value * build_version(long version);
+static JSON_Value * build_document(void);
+static double now(void);
+
+int main(int argc, char **argv) {
+    pthread_t threads[TEST_THREADS];
+    JSON_Serialization_Options options;
+    long failures = 0, iterations = TEST_ITERATIONS;
+    void *result = NULL;
+    double start = 0.0, elapsed = 0.0;
+    int i = 0, thread_count = argc > 1 ? atoi(argv[1]) : TEST_THREADS;
+    if (thread_count < 1 || thread_count > TEST_THREADS) {
+        thread_count = TEST_THREADS;
+    }
+
+    json_set_pool_limit(256);
+    root = build_document();
+    if (root == NULL || json_value_freeze(root) != JSONSuccess) {
+        printf("Could not build and freeze the document\n");
+        return 1;
+    }
+    json_serialization_options_init(&options);
+    options.sort_keys = 1;
+    expected_compact = json_serialize_to_string(root);
+    expected_sorted = json_serialize_to_string_with_options(root, &options);
+    expected_size = json_serialization_size(root);
+
+    start = now();
+    for (i = 0; i < thread_count; i++) {
+        pthread_create(&threads[i], NULL, reader_thread, (void*)&iterations);
+    }
+    for (i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], &result);
+        failures += (long)(size_t)result;
+    }
+    elapsed = now() - start;
+
+    printf("Threads: %d, iterations per thread: %ld, document size: %lu bytes\n",
+           thread_count, iterations, (unsigned long)expected_size);
+    printf("Elapsed: %.3f s, %.0f documents read per second\n", elapsed, thread_count * iterations / elapsed);
+
+    /* readers check every version they see while the main thread keeps publishing new ones */
+    publisher = json_publisher_init(build_version(0));
+    if (publisher == NULL) {
+        printf("Could not create the publisher\n");
+        return 1;
+    }
+    start = now();
+    for (i = 0; i < thread_count; i++) {
+        pthread_create(&threads[i], NULL, publisher_reader_thread, NULL);
+    }
+    for (iterations = 1; iterations <= TEST_VERSIONS; iterations++) {
+        json_publisher_publish(publisher, build_version(iterations < TEST_VERSIONS ? iterations : -1));
+    }
+    for (i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], &result);
+        failures += (long)(size_t)result;
+    }
+    failures += json_publisher_reclaim(publisher) != 0;
+    elapsed = now() - start;
+    json_publisher_free(publisher);
+    printf("Published %d versions in %.3f s\n", TEST_VERSIONS, elapsed);
+
+    /* per-request documents built concurrently, all sharing the frozen document, and freed by the
+       reclaimer while the first thread keeps running steps */
+    reclaimer = json_reclaimer_init();
+    start = now();
+    for (i = 0; i < thread_count; i++) {
+        pthread_create(&threads[i], NULL, request_thread, (void*)(size_t)i);
+    }
+    for (i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], &result);
+        failures += (long)(size_t)result;
+    }
+    json_reclaimer_free(reclaimer);
+    elapsed = now() - start;
+    printf("Built %.0f documents sharing a subtree per second\n", thread_count * TEST_REQUESTS / elapsed);
+
+    printf("Tests failed: %ld\n", failures);
+    json_free_serialized_string(expected_compact);
+    json_free_serialized_string(expected_sorted);
+    json_value_free(root);
+    json_pool_trim();
+    return failures != 0;
+}
+
+/* Reads every member of the shared document and serializes it in all modes that use caches or indexes */
+static void * reader_thread(void *arg) {
+    JSON_Serialization_Options options;
+    const JSON_Object *object = json_object(root), *section = NULL;
+    char name[64], *serialized = NULL;
+    long i = 0, iterations = *(const long*)arg;
+    size_t failures = 0, s = 0, m = 0;
+    double sum = 0.0;
+    json_serialization_options_init(&options);
+    options.sort_keys = 1;
+    for (i = 0; i < iterations; i++) {
+        sum = 0.0;
+        for (s = 0; s < TEST_SECTIONS; s++) {
+            sprintf(name, "section%lu", (unsigned long)s);
+            section = json_object_get_object(object, name);
+            for (m = 0; m < TEST_MEMBERS; m++) {
+                sprintf(name, "member%lu", (unsigned long)m);
+                sum += json_object_get_number(section, name);
+            }
+            sprintf(name, "section%lu.nested.name", (unsigned long)s);
+            failures += json_object_dotget_string(object, name) == NULL;
+        }
+        failures += sum != (double)(TEST_SECTIONS * TEST_MEMBERS) * (TEST_SECTIONS * TEST_MEMBERS - 1) / 2;
+        failures += json_serialization_size(root) != expected_size;
+        serialized = json_serialize_to_string(root);
+        failures += serialized == NULL || strcmp(serialized, expected_compact) != 0;
+        json_free_serialized_string(serialized);
+        serialized = json_serialize_to_string_with_options(root, &options);
+        failures += serialized == NULL || strcmp(serialized, expected_sorted) != 0;
+        json_free_serialized_string(serialized);
+    }
+    json_pool_trim();
+    return (void*)failures;
+}
+
+/* Reads published versions until it sees the last one (version -1) */
+static void * publisher_reader_thread(void *arg) {
+    const JSON_Value *value = NULL;
+    size_t failures = 0;
+    double version = 0.0, last_version = 0.0;
+    int token = 0;
+    (void)arg;
+    do {
+        value = json_publisher_acquire(publisher, &token);
+        version = json_object_get_number(json_object(value), "version");
+        failures += json_object_get_number(json_object(value), "double") != version * 2;
+        failures += version >= 0 && version < last_version; /* versions never go back */
+        failures += json_array_get_count(json_object_get_array(json_object(value), "items")) != 16;
+        last_version = version;
+        json_publisher_release(publisher, token);
+    } while (version >= 0);
+    json_pool_trim();
+    return (void*)failures;
+}
+
+/* Builds documents that share the frozen document, changes them through copy on write and hands
+   them to the reclaimer */
+static void * request_thread(void *arg) {
+    JSON_Value *request = NULL;
+    size_t failures = 0;
+    long i = 0;
+    for (i = 0; i < TEST_REQUESTS; i++) {
+        request = json_value_init_object();
+        json_object_set_number(json_object(request), "id", (double)i);
+        json_object_set_value(json_object(request), "config", json_value_share(root));
+        json_object_dotset_number(json_object(request), "config.section1.member0", -1);
+        failures += json_object_dotget_number(json_object(request), "config.section1.member0") != -1;
+        failures += json_object_dotget_number(json_object(request), "config.section2.member0") != 2 * TEST_MEMBERS;
+        failures += json_object_dotget_number(json_object(root), "section1.member0") != TEST_MEMBERS;
+        failures += json_value_free_deferred(reclaimer, request) != JSONSuccess;
+        if (arg == NULL) { /* only one thread may run steps */
+            json_reclaimer_step(reclaimer, 256);
+        }
+    }
+    json_pool_trim();
+    return (void*)failures;
+}
+
+static JSON_Value * build_version(long version) {
+    JSON_Value *value = json_value_init_object();
+    JSON_Value *items = json_value_init_array();
+    int i = 0;
+    for (i = 0; i < 16; i++) {
+        json_array_append_number(json_array(items), version);
+    }
+    json_object_set_number(json_object(value), "version", (double)version);
+    json_object_set_number(json_object(value), "double", (double)version * 2);
+    json_object_set_value(json_object(value), "items", items);
+    return value;
+}
+
+static JSON_Value * build_document(void) {
+    JSON_Value *value = json_value_init_object();
+    JSON_Object *object = json_object(value);
+    char name[64];
+    size_t s = 0, m = 0;
+    for (s = 0; s < TEST_SECTIONS; s++) {
+        for (m = 0; m < TEST_MEMBERS; m++) {
+            sprintf(name, "section%lu.member%lu", (unsigned long)s, (unsigned long)(TEST_MEMBERS - 1 - m));
+            json_object_dotset_number(object, name, (double)(s * TEST_MEMBERS + TEST_MEMBERS - 1 - m));
+        }
+        sprintf(name, "section%lu.nested.name", (unsigned long)s);
+        json_object_dotset_string(object, name, "a/b");
+    }
+    return value;
+}
+
+static double now(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}